@@ -30,11 +30,11 @@
 #include "zigbeeutils.h"
 #include "loggingcategory.h"
 
-#include <QDataStream>
+#include <QThread>
 
-// SLIP: https://tools.ietf.org/html/rfc1055
-
-ZigbeeInterfaceDeconz::ZigbeeInterfaceDeconz(QObject *parent) : QObject(parent)
+ZigbeeInterfaceDeconz::ZigbeeInterfaceDeconz(QObject *parent) :
+    QObject(parent),
+    m_framer(ZigbeeSlipFramer::ChecksumTypeSum16, true)
 {
     m_reconnectTimer = new QTimer(this);
     m_reconnectTimer->setSingleShot(true);
@@ -50,95 +50,88 @@ ZigbeeInterfaceDeconz::~ZigbeeInterfaceDeconz()
 
 bool ZigbeeInterfaceDeconz::available() const
 {
-    return m_available;
+    return m_available.loadAcquire() != 0;
 }
 
 QString ZigbeeInterfaceDeconz::serialPort() const
 {
-    return m_serialPort->portName();
+    QMutexLocker locker(&m_serialPortNameMutex);
+    return m_serialPortName;
 }
 
-quint16 ZigbeeInterfaceDeconz::calculateCrc(const QByteArray &data)
+void ZigbeeInterfaceDeconz::startIoThread()
 {
-    quint16 crc = 0;
-    for (int i = 0; i < data.length(); i++) {
-        crc += static_cast<quint8>(data.at(i));
-    }
-    quint8 crc0 = (~crc + 1) & 0xFF;
-    quint8 crc1 = ((~crc + 1) >> 8) & 0xFF;
-    return (static_cast<quint16>(crc1 << 8) | static_cast<quint16>(crc0));
+    if (m_ioThread)
+        return;
+
+    m_ioThread = new ZigbeeInterfaceThread("deCONZ UART", parent());
+    connect(m_ioThread, &ZigbeeInterfaceThread::receiveQueueReady, this, &ZigbeeInterfaceDeconz::processReceiveQueue, Qt::DirectConnection);
+    m_ioThread->startInterface(this);
 }
 
-QByteArray ZigbeeInterfaceDeconz::unescapeData(const QByteArray &data)
+bool ZigbeeInterfaceDeconz::ioThreadRunning() const
 {
-    QByteArray deserializedData;
-    // Parse serial data and built InterfaceMessage
-    bool escaped = false;
-    for (int i = 0; i < data.length(); i++) {
-        quint8 byte = static_cast<quint8>(data.at(i));
-
-        if (escaped) {
-            if (byte == ProtocolByteTransposedEnd) {
-                deserializedData.append(static_cast<char>(ProtocolByteEnd));
-            } else if (byte == ProtocolByteTransposedEsc) {
-                deserializedData.append(static_cast<char>(ProtocolByteEsc));
-            } else {
-                qCWarning(dcZigbeeInterfaceTraffic()) << "Error while deserialing data. Escape character received but the escaped character was not recognized.";
-                return QByteArray();
-            }
-
-            escaped = false;
-            continue;
-        }
+    return m_ioThread && m_ioThread->isRunning();
+}
 
-        // If escape byte, the next byte has to be a modified byte
-        if (byte == ProtocolByteEsc) {
-            escaped = true;
-        } else {
-            deserializedData.append(static_cast<char>(byte));
-        }
+qint64 ZigbeeInterfaceDeconz::receivedTimestamp() const
+{
+    return m_receivedTimestamp;
+}
+
+void ZigbeeInterfaceDeconz::deliverPackage(const QByteArray &package, qint64 timestamp)
+{
+    if (!m_ioThread) {
+        m_receivedTimestamp = timestamp;
+        emit packageReceived(package);
+        return;
     }
 
-    return deserializedData;
+    // Hand the package over to the controller thread
+    ReceivedPackage receivedPackage;
+    receivedPackage.package = package;
+    receivedPackage.timestamp = timestamp;
+    if (!m_receiveQueue.enqueue(receivedPackage)) {
+        qCWarning(dcZigbeeInterface()) << "Receive queue full. Dropping frame" << ZigbeeUtils::convertByteArrayToHexString(package);
+        return;
+    }
+
+    if (m_receiveQueue.requestWakeUp()) {
+        m_ioThread->notifyReceiveQueueReady();
+    }
 }
 
-QByteArray ZigbeeInterfaceDeconz::escapeData(const QByteArray &data)
+void ZigbeeInterfaceDeconz::writePackage(const QByteArray &package)
 {
-    QByteArray serializedData;
-    QDataStream stream(&serializedData, QIODevice::WriteOnly);
-
-    for (int i = 0; i < data.length(); i++) {
-        quint8 byte = static_cast<quint8>(data.at(i));
-        switch (byte) {
-        case ProtocolByteEnd:
-            stream << static_cast<quint8>(ProtocolByteEsc);
-            stream << static_cast<quint8>(ProtocolByteTransposedEnd);
-            break;
-        case ProtocolByteEsc:
-            stream << static_cast<quint8>(ProtocolByteEsc);
-            stream << static_cast<quint8>(ProtocolByteTransposedEsc);
-            break;
-        default:
-            stream << byte;
-            break;
-        }
+    if (!available()) {
+        qCWarning(dcZigbeeInterface()) << "Can not send data. The interface is not available";
+        return;
     }
 
-    return serializedData;
+    qCDebug(dcZigbeeInterface()) << "Send frame" << ZigbeeUtils::convertByteArrayToHexString(package);
+
+    // Add the checksum and escape data according to SLIP for transfere
+    QByteArray data = m_framer.encode(package);
+
+    // Send the data
+    qCDebug(dcZigbeeInterfaceTraffic()) << "-->" << ZigbeeUtils::convertByteArrayToHexString(data);
+    if (m_serialPort->write(data) < 0) {
+        qCWarning(dcZigbeeInterface()) << "Could not stream byte" << ZigbeeUtils::convertByteArrayToHexString(data);
+    }
 }
 
 void ZigbeeInterfaceDeconz::setAvailable(bool available)
 {
-    if (m_available == available)
+    if ((m_available.loadAcquire() != 0) == available)
         return;
 
     // Clear the data buffer in any case
-    if (m_available) {
-        m_dataBuffer.clear();
+    if (m_available.loadAcquire() != 0) {
+        m_framer.clear();
     }
 
-    m_available = available;
-    emit availableChanged(m_available);
+    m_available.storeRelease(available ? 1 : 0);
+    emit availableChanged(available);
 }
 
 void ZigbeeInterfaceDeconz::onReconnectTimeout()
@@ -158,41 +151,12 @@ void ZigbeeInterfaceDeconz::onReconnectTimeout()
 
 void ZigbeeInterfaceDeconz::onReadyRead()
 {
-    QByteArray data = m_serialPort->readAll();
-
-    // Read each byte until we get END byte, then unescape the package
-    for (int i = 0; i < data.length(); i++) {
-        quint8 byte = static_cast<quint8>(data.at(i));
-        if (byte == ProtocolByteEnd) {
-            // If there is no data...continue since it might be a starting END byte
-            if (m_dataBuffer.isEmpty())
-                continue;
-
-            qCDebug(dcZigbeeInterfaceTraffic()) << "<--" << ZigbeeUtils::convertByteArrayToHexString(m_dataBuffer);
-            QByteArray frame = unescapeData(m_dataBuffer);
-            if (frame.isNull()) {
-                qCWarning(dcZigbeeInterface()) << "Received inconsistant message. Ignoring data" << ZigbeeUtils::convertByteArrayToHexString(m_dataBuffer);
-            } else {
-                QByteArray package = frame.left(frame.length() - 2);
-                QByteArray checksumBytes = frame.right(2);
-                QDataStream stream(&checksumBytes, QIODevice::ReadOnly);
-                stream.setByteOrder(QDataStream::LittleEndian);
-                quint16 receivedChecksum = 0;
-                stream >> receivedChecksum;
-                quint16 calculatedChecksum = calculateCrc(package);
-                if (receivedChecksum != calculatedChecksum) {
-                    qCWarning(dcZigbeeInterfaceTraffic()) << "Checksum verification failed for frame" << ZigbeeUtils::convertByteArrayToHexString(m_dataBuffer) << receivedChecksum << "!=" << calculatedChecksum;
-                    m_dataBuffer.clear();
-                    continue;
-                }
-
-                // Checksum verified, we got valid data
-                qCDebug(dcZigbeeInterface()) << "Received frame" << ZigbeeUtils::convertByteArrayToHexString(frame);
-                emit packageReceived(package);
-            }
-            m_dataBuffer.clear();
-        } else {
-            m_dataBuffer.append(data.at(i));
+    // Read directly into the framer buffer and hand out every complete frame
+    while (m_framer.readFrom(m_serialPort) > 0) {
+        qint64 timestamp = ZigbeeUtils::monotonicMilliseconds();
+        QByteArray package;
+        while (m_framer.takeFrame(&package)) {
+            deliverPackage(package, timestamp);
         }
     }
 }
@@ -207,46 +171,55 @@ void ZigbeeInterfaceDeconz::onError(const QSerialPort::SerialPortError &error)
     }
 }
 
-void ZigbeeInterfaceDeconz::sendPackage(const QByteArray &package)
+void ZigbeeInterfaceDeconz::processReceiveQueue()
 {
-    if (!m_available) {
-        qCWarning(dcZigbeeInterface()) << "Can not send data. The interface is not available";
-        return;
-    }
-
-    // Build the frame and escape the package data and crc
-    quint16 checksum = calculateCrc(package);
+    // Runs in the controller thread
+    m_receiveQueue.acknowledgeWakeUp();
 
-    QByteArray frame = package;
-    QDataStream frameStream(&frame, QIODevice::WriteOnly  | QIODevice::Append);
-    frameStream.setByteOrder(QDataStream::LittleEndian);
-    frameStream << checksum;
-
-    qCDebug(dcZigbeeInterface()) << "Send frame" << ZigbeeUtils::convertByteArrayToHexString(frame);
+    ReceivedPackage receivedPackage;
+    while (m_receiveQueue.dequeue(&receivedPackage)) {
+        m_receivedTimestamp = receivedPackage.timestamp;
+        emit packageReceived(receivedPackage.package);
+    }
+}
 
-    // Escape data according to SLIP for transfere
-    QByteArray serializedData = escapeData(frame);
+void ZigbeeInterfaceDeconz::processSendQueue()
+{
+    // Runs in the I/O thread
+    m_sendQueue.acknowledgeWakeUp();
 
-    // Build transport data
-    QByteArray data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
-    stream << static_cast<quint8>(ProtocolByteEnd); // Start with SLIP END character
-    for (int i = 0; i < serializedData.length(); i++)
-        stream << static_cast<quint8>(serializedData.at(i));
+    QByteArray package;
+    while (m_sendQueue.dequeue(&package)) {
+        writePackage(package);
+    }
+}
 
-    stream << static_cast<quint8>(ProtocolByteEnd); // End with SLIP END character
+void ZigbeeInterfaceDeconz::sendPackage(const QByteArray &package)
+{
+    if (QThread::currentThread() == thread()) {
+        writePackage(package);
+        return;
+    }
 
-    // Send the data
-    qCDebug(dcZigbeeInterfaceTraffic()) << "-->" << ZigbeeUtils::convertByteArrayToHexString(data);
-    if (m_serialPort->write(data) < 0) {
-        qCWarning(dcZigbeeInterface()) << "Could not stream byte" << ZigbeeUtils::convertByteArrayToHexString(data);
+    // Hand the package over to the I/O thread
+    if (!m_sendQueue.enqueue(package)) {
+        qCWarning(dcZigbeeInterface()) << "Send queue full. Dropping frame" << ZigbeeUtils::convertByteArrayToHexString(package);
+        return;
     }
 
-    //m_serialPort->flush();
+    if (m_sendQueue.requestWakeUp()) {
+        QMetaObject::invokeMethod(this, "processSendQueue", Qt::QueuedConnection);
+    }
 }
 
 bool ZigbeeInterfaceDeconz::enable(const QString &serialPort, qint32 baudrate)
 {
+    if (QThread::currentThread() != thread()) {
+        bool success = false;
+        QMetaObject::invokeMethod(this, "enable", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, success), Q_ARG(QString, serialPort), Q_ARG(qint32, baudrate));
+        return success;
+    }
+
     qCDebug(dcZigbeeInterface()) << "Start UART interface " << serialPort << baudrate;
 
     if (m_serialPort) {
@@ -255,6 +228,9 @@ bool ZigbeeInterfaceDeconz::enable(const QString &serialPort, qint32 baudrate)
     }
 
     m_serialPort = new QSerialPort(serialPort, this);
+    m_serialPortNameMutex.lock();
+    m_serialPortName = serialPort;
+    m_serialPortNameMutex.unlock();
     m_serialPort->setBaudRate(baudrate);
     m_serialPort->setDataBits(QSerialPort::Data8);
     m_serialPort->setStopBits(QSerialPort::OneStop);
@@ -279,6 +255,11 @@ bool ZigbeeInterfaceDeconz::enable(const QString &serialPort, qint32 baudrate)
 
 void ZigbeeInterfaceDeconz::reconnectController()
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "reconnectController", Qt::BlockingQueuedConnection);
+        return;
+    }
+
     if (!m_serialPort)
         return;
 
@@ -293,6 +274,11 @@ void ZigbeeInterfaceDeconz::reconnectController()
 
 void ZigbeeInterfaceDeconz::disable()
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "disable", Qt::BlockingQueuedConnection);
+        return;
+    }
+
     if (!m_serialPort)
         return;
 
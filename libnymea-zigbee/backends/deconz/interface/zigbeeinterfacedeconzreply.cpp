@@ -62,6 +62,14 @@ Deconz::StatusCode ZigbeeInterfaceDeconzReply::statusCode() const
     return m_statusCode;
 }
 
+qint64 ZigbeeInterfaceDeconzReply::latency() const
+{
+    if (m_sendTimestamp == 0 || m_responseTimestamp == 0)
+        return 0;
+
+    return m_responseTimestamp - m_sendTimestamp;
+}
+
 bool ZigbeeInterfaceDeconzReply::timendOut() const
 {
     return m_timeout;
@@ -74,19 +82,17 @@ bool ZigbeeInterfaceDeconzReply::aborted() const
 
 void ZigbeeInterfaceDeconzReply::abort()
 {
-    m_timer->stop();
+    m_timer.stop();
     m_aborted = true;
     emit finished();
 }
 
 ZigbeeInterfaceDeconzReply::ZigbeeInterfaceDeconzReply(Deconz::Command command, QObject *parent) :
     QObject(parent),
-    m_timer(new QTimer(this)),
     m_command(command)
 {
-    m_timer->setInterval(5000);
-    m_timer->setSingleShot(true);
-    connect(m_timer, &QTimer::timeout, this, &ZigbeeInterfaceDeconzReply::onTimeout);
+    m_timer.setInterval(5000);
+    m_timer.setCallback([this](){ onTimeout(); });
 }
 
 void ZigbeeInterfaceDeconzReply::setSequenceNumber(quint8 sequenceNumber)
@@ -29,9 +29,9 @@
 #define ZIGBEEINTERFACEDECONZREPLY_H
 
 #include <QObject>
-#include <QTimer>
 
 #include "deconz.h"
+#include "zigbeetimerwheel.h"
 #include "zigbeenetworkrequest.h"
 
 class ZigbeeInterfaceDeconzReply : public QObject
@@ -52,6 +52,9 @@ public:
     // Response content
     Deconz::StatusCode statusCode() const;
 
+    // Time between writing the request and reading its response from the UART, 0 if there was no response
+    qint64 latency() const;
+
     bool timendOut() const;
     bool aborted() const;
     void abort();
@@ -59,9 +62,15 @@ public:
 private:
     explicit ZigbeeInterfaceDeconzReply(Deconz::Command command, QObject *parent = nullptr);
     ZigbeeNetworkRequest m_networkRequest;
-    QTimer *m_timer = nullptr;
+    ZigbeeTimeout m_timer;
     bool m_timeout = false;
     bool m_aborted = false;
+    qint64 m_sendTimestamp = 0;
+    qint64 m_responseTimestamp = 0;
+
+    // Scheduling information
+    Zigbee::RequestPriority m_priority = Zigbee::RequestPriorityUser;
+    quint64 m_destination = 0;
 
     void setSequenceNumber(quint8 sequenceNumber);
 
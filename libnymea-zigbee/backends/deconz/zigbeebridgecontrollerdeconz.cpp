@@ -32,6 +32,46 @@
 #include "zigbeebridgecontrollerdeconz.h"
 
 #include <QDataStream>
+#include <QSharedPointer>
+
+// Describes how to read a network configuration parameter from the read parameter response.
+// The stream is positioned right after the payload length and the parameter id.
+typedef struct DeconzParameterReader {
+    Deconz::Parameter parameter;
+    void (*parse)(QDataStream &stream, DeconzNetworkConfiguration &configuration);
+} DeconzParameterReader;
+
+// Parameters read by readNetworkParameters(). The watchdog timeout depends on the protocol version and gets read afterwards.
+// Note: reading the network key returns "InavlidParameter". Might be for security reasons which is good! We don't make use of link key for now.
+static const DeconzParameterReader s_networkParameterReaders[] = {
+    { Deconz::ParameterMacAddress, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          quint64 macAddress = 0; stream >> macAddress; configuration.ieeeAddress = ZigbeeAddress(macAddress); } },
+    { Deconz::ParameterPanId, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          stream >> configuration.panId; } },
+    { Deconz::ParameterNetworkAddress, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          stream >> configuration.shortAddress; } },
+    { Deconz::ParameterNetworkExtendedPanId, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          stream >> configuration.extendedPanId; } },
+    { Deconz::ParameterNodeType, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          quint8 nodeType = 0; stream >> nodeType; configuration.nodeType = static_cast<Deconz::NodeType>(nodeType); } },
+    { Deconz::ParameterChannelMask, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          stream >> configuration.channelMask; } },
+    { Deconz::ParameterApsExtendedPanId, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          stream >> configuration.apsExtendedPanId; } },
+    { Deconz::ParameterTrustCenterAddress, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          quint64 trustCenterAddress = 0; stream >> trustCenterAddress; configuration.trustCenterAddress = ZigbeeAddress(trustCenterAddress); } },
+    { Deconz::ParameterSecurityMode, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          quint8 securityMode = 0; stream >> securityMode; configuration.securityMode = static_cast<Deconz::SecurityMode>(securityMode); } },
+    { Deconz::ParameterPredefinedNwkPanId, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          quint8 predefinedNwkPanId = 0; stream >> predefinedNwkPanId; configuration.predefinedNetworkPanId = static_cast<bool>(predefinedNwkPanId); } },
+    { Deconz::ParameterCurrentChannel, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          stream >> configuration.currentChannel; } },
+    { Deconz::ParameterPermitJoin, nullptr },
+    { Deconz::ParameterProtocolVersion, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          stream >> configuration.protocolVersion; } },
+    { Deconz::ParameterNetworkUpdateId, [](QDataStream &stream, DeconzNetworkConfiguration &configuration) {
+          stream >> configuration.networkUpdateId; } }
+};
 
 ZigbeeBridgeControllerDeconz::ZigbeeBridgeControllerDeconz(QObject *parent) :
     ZigbeeBridgeController(parent)
@@ -61,6 +101,11 @@ Deconz::NetworkState ZigbeeBridgeControllerDeconz::networkState() const
     return m_networkState;
 }
 
+int ZigbeeBridgeControllerDeconz::requestQueueDepth(Zigbee::RequestPriority priority) const
+{
+    return m_replyQueue.count(priority);
+}
+
 void ZigbeeBridgeControllerDeconz::rebootController()
 {
     // According to the docs, the watchdog can be used to reboot the device by
@@ -206,17 +251,17 @@ ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::requestSendRequest(con
     case Zigbee::DestinationAddressModeGroup:
         interfaceReply = requestEnqueueSendDataGroup(request.requestId(), request.destinationShortAddress(),
                                                      request.profileId(), request.clusterId(),request.sourceEndpoint(),
-                                                     request.asdu(), request.txOptions(), request.radius());
+                                                     request.asdu(), request.txOptions(), request.radius(), request.priority(), request.destinationKey());
         break;
     case Zigbee::DestinationAddressModeShortAddress:
         interfaceReply = requestEnqueueSendDataShortAddress(request.requestId(), request.destinationShortAddress(),
                                                             request.destinationEndpoint(), request.profileId(), request.clusterId(),
-                                                            request.sourceEndpoint(), request.asdu(), request.txOptions(), request.radius());
+                                                            request.sourceEndpoint(), request.asdu(), request.txOptions(), request.radius(), request.priority(), request.destinationKey());
         break;
     case Zigbee::DestinationAddressModeIeeeAddress:
         interfaceReply = requestEnqueueSendDataIeeeAddress(request.requestId(), request.destinationIeeeAddress(),
                                                            request.destinationEndpoint(), request.profileId(), request.clusterId(),
-                                                           request.sourceEndpoint(), request.asdu(), request.txOptions(), request.radius());
+                                                           request.sourceEndpoint(), request.asdu(), request.txOptions(), request.radius(), request.priority(), request.destinationKey());
         break;
     }
 
@@ -225,37 +270,45 @@ ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::requestSendRequest(con
 
 void ZigbeeBridgeControllerDeconz::sendNextRequest()
 {
-    // Check if there is a reply request to send
-    if (m_replyQueue.isEmpty())
-        return;
-
-    // Check if there is currently a running reply
-    if (m_currentReply)
-        return;
+    // Fill the send window. The responses will be matched by the sequence number, so multiple requests can be on the wire.
+    while (!m_replyQueue.isEmpty() && m_pendingReplies.count() < m_maxPendingReplies) {
+        // If the APS request table on the controller is full, hold back the APS data requests but keep sending
+        // other commands, since reading the data confirmations is what frees the table again.
+        bool apsFreeSlotsAvailable = m_apsFreeSlotsAvailable;
+        ZigbeeInterfaceDeconzReply *reply = m_replyQueue.dequeue([apsFreeSlotsAvailable](ZigbeeInterfaceDeconzReply *queuedReply){
+            return apsFreeSlotsAvailable || queuedReply->command() != Deconz::CommandApsDataRequest;
+        });
 
-    //    // FIXME: If the controler request queue is full, wait until it's free again
-    //    if (!m_apsFreeSlotsAvailable)
-    //        return;
+        if (!reply)
+            return;
 
-    // Get the next reply, set the sequence number, send the request data over the interface and start waiting
-    m_currentReply = m_replyQueue.dequeue();
-    m_currentReply->setSequenceNumber(generateSequenceNumber());
-    qCDebug(dcZigbeeController()) << "Send request" << m_currentReply;
-    m_interface->sendPackage(m_currentReply->requestData());
-    m_currentReply->m_timer->start();
+        // Set the sequence number, send the request data over the interface and start waiting
+        reply->setSequenceNumber(generateSequenceNumber());
+        m_pendingReplies.insert(reply->sequenceNumber(), reply);
+        qCDebug(dcZigbeeController()) << "Send request" << reply << "Pending replies:" << m_pendingReplies.count();
+        reply->m_sendTimestamp = ZigbeeUtils::monotonicMilliseconds();
+        m_interface->sendPackage(reply->requestData());
+        reply->m_timer.start();
+    }
 }
 
 quint8 ZigbeeBridgeControllerDeconz::generateSequenceNumber()
 {
+    // Skip sequence numbers which are still in use by pending replies
+    while (m_pendingReplies.contains(m_sequenceNumber))
+        m_sequenceNumber++;
+
     return m_sequenceNumber++;
 }
 
-ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::createReply(Deconz::Command command, const QString &requestName, const QByteArray &requestData, QObject *parent)
+ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::createReply(Deconz::Command command, const QString &requestName, const QByteArray &requestData, QObject *parent, Zigbee::RequestPriority priority, quint64 destination)
 {
     // Create the reply
     ZigbeeInterfaceDeconzReply *reply = new ZigbeeInterfaceDeconzReply(command, parent);
     reply->m_requestName = requestName;
     reply->m_requestData = requestData;
+    reply->m_priority = priority;
+    reply->m_destination = destination;
 
     // Make sure we clean up on timeout
     connect(reply, &ZigbeeInterfaceDeconzReply::timeout, this, [this, reply](){
@@ -278,28 +331,30 @@ ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::createReply(Deconz::Co
     connect(reply, &ZigbeeInterfaceDeconzReply::finished, reply, [this, reply](){
         reply->deleteLater();
 
-        if (m_currentReply == reply) {
-            m_currentReply = nullptr;
+        if (m_pendingReplies.value(reply->sequenceNumber()) == reply) {
+            m_pendingReplies.remove(reply->sequenceNumber());
             QMetaObject::invokeMethod(this, "sendNextRequest", Qt::QueuedConnection);
+        } else {
+            // The reply finished before it has been sent, i.e. if aborted
+            m_replyQueue.remove(reply);
         }
     });
 
-    // Enqueu this reply and send it once the current reply slot is free
+    // Enqueu this reply and send it once there is a free slot in the send window
 
-    // If this is a data indication or a confirmation, prepend the reply since responses have higher priority than new requests
+    // If this is a data indication or a confirmation, drain it before anything else since responses have higher priority than new requests
     if (command == Deconz::CommandApsDataConfirm || command == Deconz::CommandApsDataIndication) {
-        m_replyQueue.prepend(reply);
-        qCDebug(dcZigbeeController()) << "Prepend request to queue:" << reply->requestName();
-    } else {
-        m_replyQueue.enqueue(reply);
-        qCDebug(dcZigbeeController()) << "Enqueue request:" << reply->requestName();
+        reply->m_priority = Zigbee::RequestPriorityInbound;
     }
 
+    m_replyQueue.enqueue(reply, reply->m_priority, reply->m_destination);
+    qCDebug(dcZigbeeController()) << "Enqueue request:" << reply->requestName() << reply->m_priority << m_replyQueue;
+
     QMetaObject::invokeMethod(this, "sendNextRequest", Qt::QueuedConnection);
     return reply;
 }
 
-ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::requestEnqueueSendDataGroup(quint8 requestId, quint16 groupAddress, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius)
+ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::requestEnqueueSendDataGroup(quint8 requestId, quint16 groupAddress, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius, Zigbee::RequestPriority priority, quint64 destination)
 {
     //    quint8 sequenceNumber = generateSequenceNumber();
     //    qCDebug(dcZigbeeController()) << "Request enqueue send data to group" << ZigbeeUtils::convertUint16ToHexString(groupAddress)
@@ -335,10 +390,10 @@ ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::requestEnqueueSendData
     stream << static_cast<quint8>(txOptions);
     stream << radius;
 
-    return createReply(Deconz::CommandApsDataRequest, "Request enqueue send data to group", message, this);
+    return createReply(Deconz::CommandApsDataRequest, "Request enqueue send data to group", message, this, priority, destination);
 }
 
-ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::requestEnqueueSendDataShortAddress(quint8 requestId, quint16 shortAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius)
+ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::requestEnqueueSendDataShortAddress(quint8 requestId, quint16 shortAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius, Zigbee::RequestPriority priority, quint64 destination)
 {
     //    quint8 sequenceNumber = generateSequenceNumber();
     //    qCDebug(dcZigbeeController()) << "Request enqueue send data to short address" << ZigbeeUtils::convertUint16ToHexString(shortAddress)
@@ -375,10 +430,10 @@ ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::requestEnqueueSendData
     stream << static_cast<quint8>(txOptions); // TX Options: Use APS ACKs
     stream << radius;
 
-    return createReply(Deconz::CommandApsDataRequest, "Request enqueue send data to short address", message, this);
+    return createReply(Deconz::CommandApsDataRequest, "Request enqueue send data to short address", message, this, priority, destination);
 }
 
-ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::requestEnqueueSendDataIeeeAddress(quint8 requestId, ZigbeeAddress ieeeAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius)
+ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::requestEnqueueSendDataIeeeAddress(quint8 requestId, ZigbeeAddress ieeeAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius, Zigbee::RequestPriority priority, quint64 destination)
 {
     //    quint8 sequenceNumber = generateSequenceNumber();
     //    qCDebug(dcZigbeeController()) << "Request enqueue send data to IEEE address" << ieeeAddress.toString()
@@ -414,377 +469,116 @@ ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::requestEnqueueSendData
     stream << static_cast<quint8>(txOptions); // TX Options: Use APS ACKs
     stream << radius;
 
-    return createReply(Deconz::CommandApsDataRequest, "Request enqueue send data to IEEE address", message, this);
+    return createReply(Deconz::CommandApsDataRequest, "Request enqueue send data to IEEE address", message, this, priority, destination);
 }
 
 ZigbeeInterfaceDeconzReply *ZigbeeBridgeControllerDeconz::readNetworkParameters()
 {
     qCDebug(dcZigbeeController()) << "Start reading network parameters";
 
-    // This method reads all network configuration parameters sequentially. This method returns a reply which will be finished either
-    // when a read request failes or all requests finished successfully.
+    // This method enqueues read requests for all network configuration parameters at once. This method returns a reply which will be finished either
+    // when the first read request failes or all requests finished successfully.
     // If read request failes, this mehtod returns the status code of the failed request.
 
     // Create an independent reply for finishing the entire read sequence
     ZigbeeInterfaceDeconzReply *readNetworkParametersReply = new ZigbeeInterfaceDeconzReply(Deconz::CommandReadParameter, this);
     connect(readNetworkParametersReply, &ZigbeeInterfaceDeconzReply::finished, readNetworkParametersReply, &ZigbeeInterfaceDeconzReply::deleteLater, Qt::QueuedConnection);
 
-    // Read MAC address of the bridge
-    ZigbeeInterfaceDeconzReply *replyMacAddress = requestReadParameter(Deconz::ParameterMacAddress);
-    connect(replyMacAddress, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyMacAddress](){
-        if (replyMacAddress->statusCode() != Deconz::StatusCodeSuccess) {
-            qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyMacAddress->sequenceNumber() << replyMacAddress->command()
-                                            << Deconz::ParameterMacAddress << "finished with error" << replyMacAddress->statusCode();
+    // Number of reads still pending, set to 0 once the first one failed
+    QSharedPointer<int> pendingReads(new int(sizeof(s_networkParameterReaders) / sizeof(DeconzParameterReader)));
 
-            readNetworkParametersReply->m_statusCode = replyMacAddress->statusCode();
-            emit readNetworkParametersReply->finished();
-            return;
-        }
-        QDataStream stream(replyMacAddress->responseData());
-        stream.setByteOrder(QDataStream::LittleEndian);
-        quint16 payloadLenght = 0; quint8 parameter = 0; quint64 macAddress = 0;
-        stream >> payloadLenght >> parameter >> macAddress;
+    for (const DeconzParameterReader &parameterReader : s_networkParameterReaders) {
+        ZigbeeInterfaceDeconzReply *reply = requestReadParameter(parameterReader.parameter);
+        connect(reply, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, reply, parameterReader, pendingReads](){
+            // Check if the sequence has already been finished due to an error
+            if (*pendingReads <= 0)
+                return;
 
-        m_networkConfiguration.ieeeAddress = ZigbeeAddress(macAddress);
-        qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyMacAddress->sequenceNumber() << replyMacAddress->command()
-                                      << static_cast<Deconz::Parameter>(parameter) << "finished successfully";
-        qCDebug(dcZigbeeController()) << "IEEE address:" << m_networkConfiguration.ieeeAddress.toString();
-
-        // Read PAN ID
-        ZigbeeInterfaceDeconzReply *replyPanId = requestReadParameter(Deconz::ParameterPanId);
-        connect(replyPanId, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyPanId](){
-            if (replyPanId->statusCode() != Deconz::StatusCodeSuccess) {
-                qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyPanId->sequenceNumber() << replyPanId->command()
-                                                << Deconz::ParameterPanId << "finished with error" << replyPanId->statusCode();
-                readNetworkParametersReply->m_statusCode = replyPanId->statusCode();
+            if (reply->statusCode() != Deconz::StatusCodeSuccess) {
+                qCWarning(dcZigbeeController()) << "Request" << "SQN:" << reply->sequenceNumber() << reply->command()
+                                                << parameterReader.parameter << "finished with error" << reply->statusCode();
+                *pendingReads = 0;
+                readNetworkParametersReply->m_statusCode = reply->statusCode();
                 emit readNetworkParametersReply->finished();
                 return;
             }
-            QDataStream stream(replyPanId->responseData());
+
+            QDataStream stream(reply->responseData());
             stream.setByteOrder(QDataStream::LittleEndian);
-            quint16 payloadLenght = 0; quint8 parameter = 0; quint16 panId = 0;
-            stream >> payloadLenght >> parameter >> panId;
-
-            m_networkConfiguration.panId = panId;
-            qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyPanId->sequenceNumber() << replyPanId->command()
-                                          << static_cast<Deconz::Parameter>(parameter) << "finished successfully";
-            qCDebug(dcZigbeeController()) << "PAN ID:" << ZigbeeUtils::convertUint16ToHexString(m_networkConfiguration.panId);
-
-            // Read short address
-            ZigbeeInterfaceDeconzReply *replyShortAddress = requestReadParameter(Deconz::ParameterNetworkAddress);
-            connect(replyShortAddress, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyShortAddress](){
-                if (replyShortAddress->statusCode() != Deconz::StatusCodeSuccess) {
-                    qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyShortAddress->sequenceNumber() << replyShortAddress->command() << Deconz::ParameterNetworkAddress
-                                                    << "finished with error" << replyShortAddress->statusCode();
-                    readNetworkParametersReply->m_statusCode = replyShortAddress->statusCode();
-                    emit readNetworkParametersReply->finished();
-                    return;
-                }
-
-                QDataStream stream(replyShortAddress->responseData());
-                stream.setByteOrder(QDataStream::LittleEndian);
-                quint16 payloadLenght = 0; quint8 parameter = 0; quint16 shortAddress = 0;
-                stream >> payloadLenght >> parameter >> shortAddress;
-                m_networkConfiguration.shortAddress = shortAddress;
-                qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyShortAddress->sequenceNumber()
-                                              << replyShortAddress->command() << static_cast<Deconz::Parameter>(parameter) << "finished successfully";
-                qCDebug(dcZigbeeController()) << ZigbeeUtils::convertUint16ToHexString(m_networkConfiguration.shortAddress);
-
-                // Read extended PAN ID
-                ZigbeeInterfaceDeconzReply *replyExtendedPanId = requestReadParameter(Deconz::ParameterNetworkExtendedPanId);
-                connect(replyExtendedPanId, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyExtendedPanId](){
-                    if (replyExtendedPanId->statusCode() != Deconz::StatusCodeSuccess) {
-                        qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyExtendedPanId->sequenceNumber() << replyExtendedPanId->command()
-                                                        << Deconz::ParameterNetworkExtendedPanId << "finished with error" << replyExtendedPanId->statusCode();
-                        readNetworkParametersReply->m_statusCode = replyExtendedPanId->statusCode();
-                        emit readNetworkParametersReply->finished();
-                        return;
-                    }
-
-                    QDataStream stream(replyExtendedPanId->responseData());
-                    stream.setByteOrder(QDataStream::LittleEndian);
-                    quint16 payloadLenght = 0; quint8 parameter = 0; quint64 networkExtendedPanId = 0;
-                    stream >> payloadLenght >> parameter >> networkExtendedPanId;
-                    m_networkConfiguration.extendedPanId = networkExtendedPanId;
-                    qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyExtendedPanId->sequenceNumber() << replyExtendedPanId->command() << static_cast<Deconz::Parameter>(parameter)
-                                                  << "finished successfully";
-                    qCDebug(dcZigbeeController()) << ZigbeeUtils::convertUint64ToHexString(m_networkConfiguration.extendedPanId);
-
-                    // Read device type
-                    ZigbeeInterfaceDeconzReply *replyNodeType = requestReadParameter(Deconz::ParameterNodeType);
-                    connect(replyNodeType, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyNodeType](){
-                        if (replyNodeType->statusCode() != Deconz::StatusCodeSuccess) {
-                            qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyNodeType->sequenceNumber() << replyNodeType->command()
-                                                            << Deconz::ParameterNodeType << "finished with error" << replyNodeType->statusCode();
-                            readNetworkParametersReply->m_statusCode = replyNodeType->statusCode();
-                            emit readNetworkParametersReply->finished();
-                            return;
-                        }
-
-                        QDataStream stream(replyNodeType->responseData());
-                        stream.setByteOrder(QDataStream::LittleEndian);
-                        quint16 payloadLenght = 0; quint8 parameter = 0; quint8 nodeType = 0;
-                        stream >> payloadLenght >> parameter >> nodeType;
-
-                        m_networkConfiguration.nodeType = static_cast<Deconz::NodeType>(nodeType);
-                        qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyNodeType->sequenceNumber() << replyNodeType->command() << static_cast<Deconz::Parameter>(parameter)
-                                                      << "finished successfully";
-                        qCDebug(dcZigbeeController()) << m_networkConfiguration.nodeType;
-
-                        // Read channel mask
-                        ZigbeeInterfaceDeconzReply *replyChannelMask = requestReadParameter(Deconz::ParameterChannelMask);
-                        connect(replyChannelMask, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyChannelMask](){
-                            if (replyChannelMask->statusCode() != Deconz::StatusCodeSuccess) {
-                                qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyChannelMask->sequenceNumber() << replyChannelMask->command() << Deconz::ParameterChannelMask
-                                                                << "finished with error" << replyChannelMask->statusCode();
-                                readNetworkParametersReply->m_statusCode = replyChannelMask->statusCode();
-                                emit readNetworkParametersReply->finished();
-                                return;
-                            }
-
-                            QDataStream stream(replyChannelMask->responseData());
-                            stream.setByteOrder(QDataStream::LittleEndian);
-                            quint16 payloadLenght = 0; quint8 parameter = 0; quint32 channelMask = 0;
-                            stream >> payloadLenght >> parameter >> channelMask;
-
-                            m_networkConfiguration.channelMask = channelMask;
-                            qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyChannelMask->sequenceNumber() << replyChannelMask->command()
-                                                          << static_cast<Deconz::Parameter>(parameter) << "finished successfully";
-                            qCDebug(dcZigbeeController()) << ZigbeeUtils::convertUint32ToHexString(m_networkConfiguration.channelMask);
-
-                            // Read APS extended PAN ID
-                            ZigbeeInterfaceDeconzReply *replyApsExtendedPanId = requestReadParameter(Deconz::ParameterApsExtendedPanId);
-                            connect(replyApsExtendedPanId, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyApsExtendedPanId](){
-                                if (replyApsExtendedPanId->statusCode() != Deconz::StatusCodeSuccess) {
-                                    qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyApsExtendedPanId->sequenceNumber() << replyApsExtendedPanId->command()
-                                                                    << Deconz::ParameterApsExtendedPanId << "finished with error" << replyApsExtendedPanId->statusCode();
-                                    readNetworkParametersReply->m_statusCode = replyApsExtendedPanId->statusCode();
-                                    emit readNetworkParametersReply->finished();
-                                    return;
-                                }
-
-                                QDataStream stream(replyApsExtendedPanId->responseData());
-                                stream.setByteOrder(QDataStream::LittleEndian);
-                                quint16 payloadLenght = 0; quint8 parameter = 0; quint64 apsExtendedPanId = 0;
-                                stream >> payloadLenght >> parameter >> apsExtendedPanId;
-
-                                m_networkConfiguration.apsExtendedPanId = apsExtendedPanId;
-                                qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyApsExtendedPanId->sequenceNumber() << replyApsExtendedPanId->command()
-                                                              << static_cast<Deconz::Parameter>(parameter) << "finished successfully";
-                                qCDebug(dcZigbeeController()) << ZigbeeUtils::convertUint64ToHexString(m_networkConfiguration.apsExtendedPanId);
-
-                                // Read trust center address
-                                ZigbeeInterfaceDeconzReply *replyTrustCenterAddress = requestReadParameter(Deconz::ParameterTrustCenterAddress);
-                                connect(replyTrustCenterAddress, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyTrustCenterAddress](){
-                                    if (replyTrustCenterAddress->statusCode() != Deconz::StatusCodeSuccess) {
-                                        qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyTrustCenterAddress->sequenceNumber() << replyTrustCenterAddress->command()
-                                                                        << Deconz::ParameterTrustCenterAddress << "finished with error" << replyTrustCenterAddress->statusCode();
-                                        readNetworkParametersReply->m_statusCode = replyTrustCenterAddress->statusCode();
-                                        emit readNetworkParametersReply->finished();
-                                        return;
-                                    }
-
-                                    QDataStream stream(replyTrustCenterAddress->responseData());
-                                    stream.setByteOrder(QDataStream::LittleEndian);
-                                    quint16 payloadLenght = 0; quint8 parameter = 0; quint64 trustCenterAddress = 0;
-                                    stream >> payloadLenght >> parameter >> trustCenterAddress;
-
-                                    m_networkConfiguration.trustCenterAddress = ZigbeeAddress(trustCenterAddress);
-                                    qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyTrustCenterAddress->sequenceNumber() << replyTrustCenterAddress->command()
-                                                                  << static_cast<Deconz::Parameter>(parameter) << "finished successfully";
-                                    qCDebug(dcZigbeeController()) << m_networkConfiguration.trustCenterAddress;
-
-                                    // Read security mode
-                                    ZigbeeInterfaceDeconzReply *replySecurityMode = requestReadParameter(Deconz::ParameterSecurityMode);
-                                    connect(replySecurityMode, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replySecurityMode](){
-                                        if (replySecurityMode->statusCode() != Deconz::StatusCodeSuccess) {
-                                            qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replySecurityMode->sequenceNumber() << replySecurityMode->command()
-                                                                            << Deconz::ParameterSecurityMode << "finished with error" << replySecurityMode->statusCode();
-                                            readNetworkParametersReply->m_statusCode = replySecurityMode->statusCode();
-                                            emit readNetworkParametersReply->finished();
-                                            return;
-                                        }
-
-                                        QDataStream stream(replySecurityMode->responseData());
-                                        stream.setByteOrder(QDataStream::LittleEndian);
-                                        quint16 payloadLenght = 0; quint8 parameter = 0; quint8 securityMode = 0;
-                                        stream >> payloadLenght >> parameter >> securityMode;
-
-                                        m_networkConfiguration.securityMode = static_cast<Deconz::SecurityMode>(securityMode);
-                                        qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replySecurityMode->sequenceNumber() << replySecurityMode->command()
-                                                                      << static_cast<Deconz::Parameter>(parameter) << "finished successfully";
-                                        qCDebug(dcZigbeeController()) << m_networkConfiguration.securityMode;
-
-
-                                        // Read predefined new pan id
-                                        ZigbeeInterfaceDeconzReply *replyPredefinedNwkPanId = requestReadParameter(Deconz::ParameterPredefinedNwkPanId);
-                                        connect(replyPredefinedNwkPanId, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyPredefinedNwkPanId](){
-                                            if (replyPredefinedNwkPanId->statusCode() != Deconz::StatusCodeSuccess) {
-                                                qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyPredefinedNwkPanId->sequenceNumber() << replyPredefinedNwkPanId->command()
-                                                                                << Deconz::ParameterSecurityMode << "finished with error" << replyPredefinedNwkPanId->statusCode();
-                                                readNetworkParametersReply->m_statusCode = replyPredefinedNwkPanId->statusCode();
-                                                emit readNetworkParametersReply->finished();
-                                                return;
-                                            }
-
-                                            QDataStream stream(replyPredefinedNwkPanId->responseData());
-                                            stream.setByteOrder(QDataStream::LittleEndian);
-                                            quint16 payloadLenght = 0; quint8 parameter = 0; quint8 predefinedNwkPanId = 0;
-                                            stream >> payloadLenght >> parameter >> predefinedNwkPanId;
-
-                                            m_networkConfiguration.predefinedNetworkPanId = static_cast<bool>(predefinedNwkPanId);
-                                            qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyPredefinedNwkPanId->sequenceNumber() << replyPredefinedNwkPanId->command()
-                                                                          << static_cast<Deconz::Parameter>(parameter) << "finished successfully";
-                                            qCDebug(dcZigbeeController()) << m_networkConfiguration.predefinedNetworkPanId;
-
-
-                                            // We don't make use of link key for now
-
-                                            // Note: reading the network key returns "InavlidParameter". Might be for security reasons which is good!
-
-                                            // Read channel
-                                            ZigbeeInterfaceDeconzReply *replyChannel = requestReadParameter(Deconz::ParameterCurrentChannel);
-                                            connect(replyChannel, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyChannel](){
-                                                if (replyChannel->statusCode() != Deconz::StatusCodeSuccess) {
-                                                    qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyChannel->sequenceNumber() << replyChannel->command() << Deconz::ParameterCurrentChannel
-                                                                                    << "finished with error" << replyChannel->statusCode();
-                                                    readNetworkParametersReply->m_statusCode = replyChannel->statusCode();
-                                                    emit readNetworkParametersReply->finished();
-                                                    return;
-                                                }
-
-                                                QDataStream stream(replyChannel->responseData());
-                                                stream.setByteOrder(QDataStream::LittleEndian);
-                                                quint16 payloadLenght = 0; quint8 parameter = 0; quint8 channel = 0;
-                                                stream >> payloadLenght >> parameter >> channel;
-                                                m_networkConfiguration.currentChannel = channel;
-                                                qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyChannel->sequenceNumber() << replyChannel->command() << static_cast<Deconz::Parameter>(parameter)
-                                                                              << "finished successfully";
-                                                qCDebug(dcZigbeeController()) << "Current channel:" << m_networkConfiguration.currentChannel;
-
-
-                                                // Read permit join status
-                                                ZigbeeInterfaceDeconzReply *replyPermitJoin = requestReadParameter(Deconz::ParameterPermitJoin);
-                                                connect(replyPermitJoin, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyPermitJoin](){
-                                                    if (replyPermitJoin->statusCode() != Deconz::StatusCodeSuccess) {
-                                                        qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyPermitJoin->sequenceNumber() << replyPermitJoin->command()
-                                                                                        << Deconz::ParameterPermitJoin << "finished with error" << replyPermitJoin->statusCode();
-                                                        readNetworkParametersReply->m_statusCode = replyPermitJoin->statusCode();
-                                                        emit readNetworkParametersReply->finished();
-                                                        return;
-                                                    }
-
-                                                    QDataStream stream(replyPermitJoin->responseData());
-                                                    stream.setByteOrder(QDataStream::LittleEndian);
-                                                    quint16 payloadLenght = 0; quint8 parameter = 0;
-                                                    stream >> payloadLenght >> parameter;
-                                                    //m_networkConfiguration.currentChannel = channel;
-                                                    qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyPermitJoin->sequenceNumber() << replyPermitJoin->command() << static_cast<Deconz::Parameter>(parameter)
-                                                                                  << "finished successfully" << ZigbeeUtils::convertByteArrayToHexString(replyPermitJoin->responseData());
-
-
-                                                    // Read protocol version
-                                                    ZigbeeInterfaceDeconzReply *replyProtocolVersion = requestReadParameter(Deconz::ParameterProtocolVersion);
-                                                    connect(replyProtocolVersion, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyProtocolVersion](){
-                                                        if (replyProtocolVersion->statusCode() != Deconz::StatusCodeSuccess) {
-                                                            qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyProtocolVersion->sequenceNumber() << replyProtocolVersion->command()
-                                                                                            << Deconz::ParameterProtocolVersion << "finished with error" << replyProtocolVersion->statusCode();
-                                                            readNetworkParametersReply->m_statusCode = replyProtocolVersion->statusCode();
-                                                            emit readNetworkParametersReply->finished();
-                                                            return;
-                                                        }
-
-                                                        QDataStream stream(replyProtocolVersion->responseData());
-                                                        stream.setByteOrder(QDataStream::LittleEndian);
-                                                        quint16 payloadLenght = 0; quint8 parameter = 0; quint16 protocolVersion = 0;
-                                                        stream >> payloadLenght >> parameter >> protocolVersion;
-                                                        m_networkConfiguration.protocolVersion = protocolVersion;
-                                                        qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyProtocolVersion->sequenceNumber() << replyProtocolVersion->command()
-                                                                                      << static_cast<Deconz::Parameter>(parameter) << "finished successfully";
-                                                        qCDebug(dcZigbeeController()) << "Protocol version:" << ZigbeeUtils::convertUint16ToHexString(m_networkConfiguration.protocolVersion);
-
-                                                        // Read network updat id
-                                                        ZigbeeInterfaceDeconzReply *replyNetworkUpdateId = requestReadParameter(Deconz::ParameterNetworkUpdateId);
-                                                        connect(replyNetworkUpdateId, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyNetworkUpdateId](){
-                                                            if (replyNetworkUpdateId->statusCode() != Deconz::StatusCodeSuccess) {
-                                                                qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyNetworkUpdateId->sequenceNumber() << replyNetworkUpdateId->command()
-                                                                                                << Deconz::ParameterNetworkUpdateId << "finished with error" << replyNetworkUpdateId->statusCode();
-                                                                readNetworkParametersReply->m_statusCode = replyNetworkUpdateId->statusCode();
-                                                                emit readNetworkParametersReply->finished();
-                                                                return;
-                                                            }
-
-                                                            QDataStream stream(replyNetworkUpdateId->responseData());
-                                                            stream.setByteOrder(QDataStream::LittleEndian);
-                                                            quint16 payloadLenght = 0; quint8 parameter = 0; quint8 networkUpdateId = 0;
-                                                            stream >> payloadLenght >> parameter >> networkUpdateId;
-                                                            m_networkConfiguration.networkUpdateId = networkUpdateId;
-                                                            qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyNetworkUpdateId->sequenceNumber() << replyNetworkUpdateId->command()
-                                                                                          << static_cast<Deconz::Parameter>(parameter) << "finished successfully";
-                                                            qCDebug(dcZigbeeController()) << "Network update ID:" << m_networkConfiguration.networkUpdateId;
-
-                                                            // Make sure the watchdog is available for this version
-                                                            if (m_networkConfiguration.protocolVersion < 0x0108) {
-                                                                qCDebug(dcZigbeeController()) << "The watchdog api is available since protocol version 0x0108. The watchdog is not required for this version";
-                                                                m_watchdogTimer->stop();
-
-                                                                // Finished reading all parameters. Finish the independent reply in order to indicate the process has finished
-                                                                emit networkConfigurationParameterChanged(m_networkConfiguration);
-                                                                readNetworkParametersReply->m_statusCode = Deconz::StatusCodeSuccess;
-                                                                emit readNetworkParametersReply->finished();
-                                                                return;
-                                                            }
-
-                                                            // Reset the watchdog in any case
-                                                            resetControllerWatchdog();
-
-                                                            // Read watchdog timeout
-                                                            ZigbeeInterfaceDeconzReply *replyWatchdogTimeout = requestReadParameter(Deconz::ParameterWatchdogTtl);
-                                                            connect(replyWatchdogTimeout, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyWatchdogTimeout](){
-                                                                if (replyWatchdogTimeout->statusCode() != Deconz::StatusCodeSuccess) {
-                                                                    qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyWatchdogTimeout->sequenceNumber() << replyWatchdogTimeout->command()
-                                                                                                    << Deconz::ParameterWatchdogTtl << "finished with error" << replyWatchdogTimeout->statusCode();
-                                                                    readNetworkParametersReply->m_statusCode = replyWatchdogTimeout->statusCode();
-                                                                    emit readNetworkParametersReply->finished();
-                                                                    return;
-                                                                }
-
-                                                                QDataStream stream(replyWatchdogTimeout->responseData());
-                                                                stream.setByteOrder(QDataStream::LittleEndian);
-                                                                quint16 payloadLenght = 0; quint8 parameter = 0; quint32 watchdogTimeout = 0;
-                                                                stream >> payloadLenght >> parameter >> watchdogTimeout;
-                                                                m_networkConfiguration.watchdogTimeout = watchdogTimeout;
-                                                                qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyWatchdogTimeout->sequenceNumber() << replyWatchdogTimeout->command()
-                                                                                              << static_cast<Deconz::Parameter>(parameter) << "finished successfully";
-                                                                qCDebug(dcZigbeeController()) << "Watchdog timeout:" << m_networkConfiguration.watchdogTimeout;
-
-                                                                // Finished reading all parameters. Finish the independent reply in order to indicate the process has finished
-                                                                emit networkConfigurationParameterChanged(m_networkConfiguration);
-                                                                readNetworkParametersReply->m_statusCode = Deconz::StatusCodeSuccess;
-                                                                emit readNetworkParametersReply->finished();
-
-
-                                                                // We ignore the frame counter for now, since we let the firmware take control
-
-                                                            });
-                                                        });
-                                                    });
-                                                });
-                                            });
-                                        });
-                                    });
-                                });
-                            });
-                        });
-                    });
-                });
-            });
+            quint16 payloadLenght = 0; quint8 parameter = 0;
+            stream >> payloadLenght >> parameter;
+            if (parameter != parameterReader.parameter) {
+                qCWarning(dcZigbeeController()) << "Request" << "SQN:" << reply->sequenceNumber() << reply->command() << parameterReader.parameter
+                                                << "returned unexpected parameter" << static_cast<Deconz::Parameter>(parameter);
+                *pendingReads = 0;
+                readNetworkParametersReply->m_statusCode = Deconz::StatusCodeInvalidValue;
+                emit readNetworkParametersReply->finished();
+                return;
+            }
+
+            if (parameterReader.parse)
+                parameterReader.parse(stream, m_networkConfiguration);
+
+            qCDebug(dcZigbeeController()) << "Request" << "SQN:" << reply->sequenceNumber() << reply->command()
+                                          << parameterReader.parameter << "finished successfully" << ZigbeeUtils::convertByteArrayToHexString(reply->responseData());
+
+            *pendingReads -= 1;
+            if (*pendingReads == 0) {
+                finishReadNetworkParameters(readNetworkParametersReply);
+            }
         });
-    });
+    }
 
     return readNetworkParametersReply;
 }
 
+void ZigbeeBridgeControllerDeconz::finishReadNetworkParameters(ZigbeeInterfaceDeconzReply *readNetworkParametersReply)
+{
+    // Make sure the watchdog is available for this version
+    if (m_networkConfiguration.protocolVersion < 0x0108) {
+        qCDebug(dcZigbeeController()) << "The watchdog api is available since protocol version 0x0108. The watchdog is not required for this version";
+        m_watchdogTimer->stop();
+
+        // Finished reading all parameters. Finish the independent reply in order to indicate the process has finished
+        qCDebug(dcZigbeeController()) << m_networkConfiguration;
+        emit networkConfigurationParameterChanged(m_networkConfiguration);
+        readNetworkParametersReply->m_statusCode = Deconz::StatusCodeSuccess;
+        emit readNetworkParametersReply->finished();
+        return;
+    }
+
+    // Reset the watchdog in any case
+    resetControllerWatchdog();
+
+    // Read watchdog timeout
+    ZigbeeInterfaceDeconzReply *replyWatchdogTimeout = requestReadParameter(Deconz::ParameterWatchdogTtl);
+    connect(replyWatchdogTimeout, &ZigbeeInterfaceDeconzReply::finished, this, [this, readNetworkParametersReply, replyWatchdogTimeout](){
+        if (replyWatchdogTimeout->statusCode() != Deconz::StatusCodeSuccess) {
+            qCWarning(dcZigbeeController()) << "Request" << "SQN:" << replyWatchdogTimeout->sequenceNumber() << replyWatchdogTimeout->command()
+                                            << Deconz::ParameterWatchdogTtl << "finished with error" << replyWatchdogTimeout->statusCode();
+            readNetworkParametersReply->m_statusCode = replyWatchdogTimeout->statusCode();
+            emit readNetworkParametersReply->finished();
+            return;
+        }
+
+        QDataStream stream(replyWatchdogTimeout->responseData());
+        stream.setByteOrder(QDataStream::LittleEndian);
+        quint16 payloadLenght = 0; quint8 parameter = 0; quint32 watchdogTimeout = 0;
+        stream >> payloadLenght >> parameter >> watchdogTimeout;
+        m_networkConfiguration.watchdogTimeout = watchdogTimeout;
+        qCDebug(dcZigbeeController()) << "Request" << "SQN:" << replyWatchdogTimeout->sequenceNumber() << replyWatchdogTimeout->command()
+                                      << static_cast<Deconz::Parameter>(parameter) << "finished successfully";
+
+        // Finished reading all parameters. Finish the independent reply in order to indicate the process has finished
+        qCDebug(dcZigbeeController()) << m_networkConfiguration;
+        emit networkConfigurationParameterChanged(m_networkConfiguration);
+        readNetworkParametersReply->m_statusCode = Deconz::StatusCodeSuccess;
+        emit readNetworkParametersReply->finished();
+
+        // We ignore the frame counter for now, since we let the firmware take control
+    });
+}
+
 DeconzDeviceState ZigbeeBridgeControllerDeconz::parseDeviceStateFlag(quint8 deviceStateFlag)
 {
     DeconzDeviceState state;
@@ -853,6 +647,23 @@ void ZigbeeBridgeControllerDeconz::readDataConfirm()
     });
 }
 
+void ZigbeeBridgeControllerDeconz::setApsFreeSlotsAvailable(bool available)
+{
+    if (m_apsFreeSlotsAvailable == available)
+        return;
+
+    m_apsFreeSlotsAvailable = available;
+    if (!m_apsFreeSlotsAvailable) {
+        // Warn only if the network is up
+        if (m_networkState == Deconz::NetworkStateConnected) {
+            qCWarning(dcZigbeeController()) << "The APS request table is full on the device. Holding back APS requests until the queue gets processed on the controller.";
+        }
+    } else {
+        qCDebug(dcZigbeeController()) << "The APS request table is free again. Sending the next request";
+        QMetaObject::invokeMethod(this, "sendNextRequest", Qt::QueuedConnection);
+    }
+}
+
 void ZigbeeBridgeControllerDeconz::processDeviceState(DeconzDeviceState deviceState)
 {
     qCDebug(dcZigbeeController()) << "Process device state notification" << deviceState;
@@ -863,19 +674,8 @@ void ZigbeeBridgeControllerDeconz::processDeviceState(DeconzDeviceState deviceSt
         emit networkStateChanged(m_networkState);
     }
 
-    if (m_apsFreeSlotsAvailable != deviceState.apsDataRequestFreeSlots) {
-        m_apsFreeSlotsAvailable = deviceState.apsDataRequestFreeSlots;
-        if (!m_apsFreeSlotsAvailable) {
-            // Warn only if the network is up
-            if (m_networkState == Deconz::NetworkStateConnected) {
-                qCWarning(dcZigbeeController()) << "The APS request table is full on the device. Cannot send requests until the queue gets processed on the controller.";
-            }
-            return;
-        } else {
-            qCDebug(dcZigbeeController()) << "The APS request table is free again. Sending the next request";
-            sendNextRequest();
-        }
-    }
+    // Note: even if the APS request table is full we have to continue reading the confirmations, otherwise it never gets free again
+    setApsFreeSlotsAvailable(deviceState.apsDataRequestFreeSlots);
 
     if (m_networkState != Deconz::NetworkStateConnected)
         return;
@@ -939,6 +739,7 @@ void ZigbeeBridgeControllerDeconz::processDataIndication(const QByteArray &data)
     // Process the device state in order to check if we have to request another indication
     DeconzDeviceState deviceState = parseDeviceStateFlag(deviceStateFlag);
     qCDebug(dcZigbeeController()) << "Verify device state after data indication response" << deviceState;
+    setApsFreeSlotsAvailable(deviceState.apsDataRequestFreeSlots);
     if (deviceState.apsDataIndication) {
         readDataIndication();
     }
@@ -970,6 +771,7 @@ void ZigbeeBridgeControllerDeconz::processDataConfirm(const QByteArray &data)
     // Process the device state in order to check if we have to request another indication
     DeconzDeviceState deviceState = parseDeviceStateFlag(deviceStateFlag);
     qCDebug(dcZigbeeController()) << "Verify device state after data confirmation response" << deviceState;
+    setApsFreeSlotsAvailable(deviceState.apsDataRequestFreeSlots);
     if (deviceState.apsDataConfirm) {
         readDataConfirm();
     }
@@ -992,8 +794,12 @@ void ZigbeeBridgeControllerDeconz::onInterfaceAvailableChanged(bool available)
     qCDebug(dcZigbeeController()) << "Interface available changed" << available;
     if (!available) {
         // Clean up any pending replies
-        while (!m_replyQueue.isEmpty()) {
-            ZigbeeInterfaceDeconzReply *reply = m_replyQueue.dequeue();
+        foreach (ZigbeeInterfaceDeconzReply *reply, m_pendingReplies.values()) {
+            reply->abort();
+        }
+        m_pendingReplies.clear();
+
+        foreach (ZigbeeInterfaceDeconzReply *reply, m_replyQueue.takeAll()) {
             reply->abort();
         }
 
@@ -1019,18 +825,41 @@ void ZigbeeBridgeControllerDeconz::onInterfacePackageReceived(const QByteArray &
     qCDebug(dcZigbeeController()) << "Interface message received" << command << "SQN:" << sequenceNumber
                                   << status << "Frame length:" << frameLength << ZigbeeUtils::convertByteArrayToHexString(data);
 
-    // Check if this is the response to the current active reply
-    if (m_currentReply && m_currentReply->sequenceNumber() == sequenceNumber && m_currentReply->command() == command) {
-        m_currentReply->m_responseData = data;
-        m_currentReply->m_statusCode = status;
-        emit m_currentReply->finished();
-        // Note: the current reply will be cleaned up in the finished slot
+    // Check if this is the response to one of the pending replies
+    ZigbeeInterfaceDeconzReply *reply = m_pendingReplies.value(sequenceNumber);
+    if (reply && reply->command() == command) {
+        if (command == Deconz::CommandApsDataRequest) {
+            if (status == Deconz::StatusCodeBusy) {
+                // The APS request table filled up while this request was on the wire. Put it back in front
+                // of the queue and send it again once the controller reports free slots.
+                qCDebug(dcZigbeeController()) << "The controller is busy. Re-enqueue" << reply;
+                reply->m_timer.stop();
+                m_pendingReplies.remove(sequenceNumber);
+                m_replyQueue.prepend(reply, reply->m_priority, reply->m_destination);
+                setApsFreeSlotsAvailable(false);
+                return;
+            }
+
+            // The response contains the current device state: payload length (2), device state (1), request id (1)
+            if (status == Deconz::StatusCodeSuccess && data.length() >= 3) {
+                setApsFreeSlotsAvailable(parseDeviceStateFlag(static_cast<quint8>(data.at(2))).apsDataRequestFreeSlots);
+            }
+        }
+
+        reply->m_responseData = data;
+        reply->m_statusCode = status;
+        reply->m_responseTimestamp = m_interface->receivedTimestamp();
+        qCDebug(dcZigbeeController()) << "Response for" << reply << "received after" << reply->latency() << "ms";
+        emit reply->finished();
+        // Note: the reply will be cleaned up in the finished slot
         return;
     }
 
     // We got a notification, lets set the current sequence number to the notification id,
-    // so the next request will be a continuous increase
-    m_sequenceNumber = sequenceNumber + 1;
+    // so the next request will be a continuous increase. Only if nothing is on the wire,
+    // otherwise we could hand out a sequence number twice.
+    if (m_pendingReplies.isEmpty())
+        m_sequenceNumber = sequenceNumber + 1;
 
     // No request for this data, lets check which notification and process the data
     switch (command) {
@@ -1074,6 +903,9 @@ void ZigbeeBridgeControllerDeconz::resetControllerWatchdog()
 
 bool ZigbeeBridgeControllerDeconz::enable(const QString &serialPort, qint32 baudrate)
 {
+    if (m_ioThreadEnabled)
+        m_interface->startIoThread();
+
     return m_interface->enable(serialPort, baudrate);
 }
 
@@ -37,6 +37,7 @@
 #include "zigbeeaddress.h"
 #include "zigbeenetworkkey.h"
 #include "zigbeenetworkrequest.h"
+#include "zigbeerequestscheduler.h"
 #include "zigbeebridgecontroller.h"
 
 #include "interface/deconz.h"
@@ -87,6 +88,8 @@ public:
     Deconz::NetworkState networkState() const;
     void rebootController();
 
+    int requestQueueDepth(Zigbee::RequestPriority priority) const override;
+
 
     // Controllere requests
     ZigbeeInterfaceDeconzReply *requestVersion();
@@ -108,31 +111,33 @@ private:
     Deconz::NetworkState m_networkState = Deconz::NetworkStateOffline;
     QTimer *m_watchdogTimer = nullptr;
 
-    // APS request queue
+    // Request pipeline: up to m_maxPendingReplies requests can be on the wire, matched by sequence number
     bool m_apsFreeSlotsAvailable = true;
-    ZigbeeInterfaceDeconzReply *m_currentReply = nullptr;
+    int m_maxPendingReplies = 4;
+    QHash<quint8, ZigbeeInterfaceDeconzReply *> m_pendingReplies;
     ZigbeeInterfaceDeconzReply *m_readConfirmReply = nullptr;
     ZigbeeInterfaceDeconzReply *m_readIndicationReply = nullptr;
 
-    QQueue<ZigbeeInterfaceDeconzReply *> m_replyQueue;
+    ZigbeeRequestScheduler<ZigbeeInterfaceDeconzReply *> m_replyQueue;
 
     quint8 generateSequenceNumber();
 
-    ZigbeeInterfaceDeconzReply *createReply(Deconz::Command command, const QString &requestName, const QByteArray &requestData, QObject *parent);
+    ZigbeeInterfaceDeconzReply *createReply(Deconz::Command command, const QString &requestName, const QByteArray &requestData, QObject *parent, Zigbee::RequestPriority priority = Zigbee::RequestPriorityUser, quint64 destination = 0);
 
     // Send data depending on the request destination address mode
     QByteArray buildRequestEnqueueSendDataGroupMessage(quint8 requestId, quint16 groupAddress, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0);
-    ZigbeeInterfaceDeconzReply *requestEnqueueSendDataGroup(quint8 requestId, quint16 groupAddress, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0);
-    ZigbeeInterfaceDeconzReply *requestEnqueueSendDataShortAddress(quint8 requestId, quint16 shortAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0);
-    ZigbeeInterfaceDeconzReply *requestEnqueueSendDataIeeeAddress(quint8 requestId, ZigbeeAddress ieeeAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0);
+    ZigbeeInterfaceDeconzReply *requestEnqueueSendDataGroup(quint8 requestId, quint16 groupAddress, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0, Zigbee::RequestPriority priority = Zigbee::RequestPriorityUser, quint64 destination = 0);
+    ZigbeeInterfaceDeconzReply *requestEnqueueSendDataShortAddress(quint8 requestId, quint16 shortAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0, Zigbee::RequestPriority priority = Zigbee::RequestPriorityUser, quint64 destination = 0);
+    ZigbeeInterfaceDeconzReply *requestEnqueueSendDataIeeeAddress(quint8 requestId, ZigbeeAddress ieeeAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0, Zigbee::RequestPriority priority = Zigbee::RequestPriorityUser, quint64 destination = 0);
 
     // Receive data
     ZigbeeInterfaceDeconzReply *requestReadReceivedDataIndication(Deconz::SourceAddressMode sourceAddressMode = Deconz::SourceAddressModeShortSourceAddress);
     ZigbeeInterfaceDeconzReply *requestQuerySendDataConfirm();
 
-    // Note: this method reads all parameters individual. The returned reply it self will not send or receive any data.
+    // Note: this method enqueues all parameter reads at once. The returned reply it self will not send or receive any data.
     // The data can be fetched from m_networkConfiguration on success.
     ZigbeeInterfaceDeconzReply *readNetworkParameters();
+    void finishReadNetworkParameters(ZigbeeInterfaceDeconzReply *readNetworkParametersReply);
 
     // Device state helper
     DeconzDeviceState parseDeviceStateFlag(quint8 deviceStateFlag);
@@ -141,6 +146,7 @@ private:
     void readDataIndication();
     void readDataConfirm();
 
+    void setApsFreeSlotsAvailable(bool available);
     void processDeviceState(DeconzDeviceState deviceState);
     void processDataIndication(const QByteArray &data);
     void processDataConfirm(const QByteArray &data);
@@ -64,10 +64,15 @@ Zigbee::ZigbeeBackendType ZigbeeNetworkDeconz::backendType() const
 ZigbeeNetworkReply *ZigbeeNetworkDeconz::sendRequest(const ZigbeeNetworkRequest &request)
 {
     ZigbeeNetworkReply *reply = createNetworkReply(request);
+    if (!reserveRequestId(reply))
+        return reply;
+
     // Send the request, and keep the reply until transposrt, zigbee trasmission and response arrived
     m_pendingReplies.insert(request.requestId(), reply);
-    connect(reply, &ZigbeeNetworkReply::finished, this, [this, request](){
-        m_pendingReplies.remove(request.requestId());
+    connect(reply, &ZigbeeNetworkReply::finished, this, [this, request, reply](){
+        if (m_pendingReplies.value(request.requestId()) == reply) {
+            m_pendingReplies.remove(request.requestId());
+        }
     });
 
     // Finish the reply right away if the network is offline
@@ -682,6 +687,7 @@ void ZigbeeNetworkDeconz::startNetwork()
 {
     loadNetwork();
 
+    m_controller->setIoThreadEnabled(serialIoThreadEnabled());
     if (!m_controller->enable(serialPortName(), serialBaudrate())) {
         setPermitJoiningState(false);
         setState(StateOffline);
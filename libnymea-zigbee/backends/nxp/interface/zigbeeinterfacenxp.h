@@ -28,40 +28,56 @@
 #ifndef ZIGBEEINTERFACENXP_H
 #define ZIGBEEINTERFACENXP_H
 
-#include <QObject>
+#include <QMutex>
 #include <QTimer>
+#include <QObject>
+#include <QAtomicInt>
 #include <QSerialPort>
 
+#include "zigbeespscqueue.h"
+#include "zigbeeslipframer.h"
+#include "zigbeeinterfacethread.h"
+
 class ZigbeeInterfaceNxp : public QObject
 {
     Q_OBJECT
 
 public:
-    enum ProtocolByte {
-        ProtocolByteEnd = 0xC0,
-        ProtocolByteEsc = 0xDB,
-        ProtocolByteTransposedEnd = 0xDC,
-        ProtocolByteTransposedEsc = 0xDD
-    };
-    Q_ENUM(ProtocolByte)
-
     explicit ZigbeeInterfaceNxp(QObject *parent = nullptr);
     ~ZigbeeInterfaceNxp();
 
     bool available() const;
     QString serialPort() const;
 
+    // Optional dedicated I/O thread for reading, decoding and writing frames. Has to be started before enabling the interface.
+    void startIoThread();
+    bool ioThreadRunning() const;
+
+    // Monotonic timestamp of the frame currently delivered by packageReceived(), taken when it was read from the UART
+    qint64 receivedTimestamp() const;
+
 private:
+    typedef struct ReceivedPackage {
+        QByteArray package;
+        qint64 timestamp = 0;
+    } ReceivedPackage;
+
     QTimer *m_reconnectTimer = nullptr;
     QSerialPort *m_serialPort = nullptr;
-    bool m_available = false;
-    QByteArray m_dataBuffer;
+    // Written by the I/O thread, read from the controller thread
+    QAtomicInt m_available;
+    mutable QMutex m_serialPortNameMutex;
+    QString m_serialPortName;
+    ZigbeeSlipFramer m_framer;
 
-    quint8 calculateCrc(const QByteArray &data);
-    QByteArray unescapeData(const QByteArray &data);
-    QByteArray escapeData(const QByteArray &data);
+    ZigbeeInterfaceThread *m_ioThread = nullptr;
+    ZigbeeSpscQueue<ReceivedPackage> m_receiveQueue;
+    ZigbeeSpscQueue<QByteArray> m_sendQueue;
+    qint64 m_receivedTimestamp = 0;
 
     void setAvailable(bool available);
+    void deliverPackage(const QByteArray &package, qint64 timestamp);
+    void writePackage(const QByteArray &package);
 
 signals:
     void availableChanged(bool available);
@@ -71,6 +87,8 @@ private slots:
     void onReconnectTimeout();
     void onReadyRead();
     void onError(const QSerialPort::SerialPortError &error);
+    void processReceiveQueue();
+    void processSendQueue();
 
 public slots:
     void sendPackage(const QByteArray &package);
@@ -62,6 +62,14 @@ Nxp::Status ZigbeeInterfaceNxpReply::status() const
     return m_status;
 }
 
+qint64 ZigbeeInterfaceNxpReply::latency() const
+{
+    if (m_sendTimestamp == 0 || m_responseTimestamp == 0)
+        return 0;
+
+    return m_responseTimestamp - m_sendTimestamp;
+}
+
 bool ZigbeeInterfaceNxpReply::timendOut() const
 {
     return m_timeout;
@@ -74,24 +82,22 @@ bool ZigbeeInterfaceNxpReply::aborted() const
 
 void ZigbeeInterfaceNxpReply::abort()
 {
-    m_timer->stop();
+    m_timer.stop();
     m_aborted = true;
     emit finished();
 }
 
 ZigbeeInterfaceNxpReply::ZigbeeInterfaceNxpReply(Nxp::Command command, QObject *parent) :
     QObject(parent),
-    m_timer(new QTimer(this)),
     m_command(command)
 {
-    m_timer->setInterval(5000);
-    m_timer->setSingleShot(true);
-    connect(m_timer, &QTimer::timeout, this, &ZigbeeInterfaceNxpReply::onTimeout);
+    m_timer.setInterval(5000);
+    m_timer.setCallback([this](){ onTimeout(); });
 }
 
 void ZigbeeInterfaceNxpReply::setFinished()
 {
-    m_timer->stop();
+    m_timer.stop();
     emit finished();
 }
 
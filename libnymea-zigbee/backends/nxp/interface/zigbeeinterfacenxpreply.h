@@ -29,9 +29,9 @@
 #define ZIGBEEINTERFACENXPREPLY_H
 
 #include <QObject>
-#include <QTimer>
 
 #include "nxp.h"
+#include "zigbeetimerwheel.h"
 #include "zigbeenetworkrequest.h"
 
 class ZigbeeInterfaceNxpReply : public QObject
@@ -52,6 +52,9 @@ public:
     // Response content
     Nxp::Status status() const;
 
+    // Time between writing the request and reading its response from the UART, 0 if there was no response
+    qint64 latency() const;
+
     bool timendOut() const;
     bool aborted() const;
     void abort();
@@ -60,9 +63,11 @@ private:
     explicit ZigbeeInterfaceNxpReply(Nxp::Command command, QObject *parent = nullptr);
 
     ZigbeeNetworkRequest m_networkRequest;
-    QTimer *m_timer = nullptr;
+    ZigbeeTimeout m_timer;
     bool m_timeout = false;
     bool m_aborted = false;
+    qint64 m_sendTimestamp = 0;
+    qint64 m_responseTimestamp = 0;
 
     // Request content
     QString m_requestName;
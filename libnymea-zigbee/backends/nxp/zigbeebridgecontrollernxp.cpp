@@ -49,6 +49,16 @@ ZigbeeBridgeControllerNxp::ControllerState ZigbeeBridgeControllerNxp::controller
     return m_controllerState;
 }
 
+qint64 ZigbeeBridgeControllerNxp::receivedTimestamp() const
+{
+    return m_interface->receivedTimestamp();
+}
+
+int ZigbeeBridgeControllerNxp::requestQueueDepth(Zigbee::RequestPriority priority) const
+{
+    return m_replyQueue.count(priority);
+}
+
 void ZigbeeBridgeControllerNxp::refreshControllerState()
 {
     // Get controller state
@@ -215,17 +225,17 @@ ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::requestSendRequest(const Zig
     case Zigbee::DestinationAddressModeGroup:
         interfaceReply = requestEnqueueSendDataGroup(request.requestId(), request.destinationShortAddress(),
                                                      request.profileId(), request.clusterId(),request.sourceEndpoint(),
-                                                     request.asdu(), request.txOptions(), request.radius());
+                                                     request.asdu(), request.txOptions(), request.radius(), request.priority(), request.destinationKey());
         break;
     case Zigbee::DestinationAddressModeShortAddress:
         interfaceReply = requestEnqueueSendDataShortAddress(request.requestId(), request.destinationShortAddress(),
                                                             request.destinationEndpoint(), request.profileId(), request.clusterId(),
-                                                            request.sourceEndpoint(), request.asdu(), request.txOptions(), request.radius());
+                                                            request.sourceEndpoint(), request.asdu(), request.txOptions(), request.radius(), request.priority(), request.destinationKey());
         break;
     case Zigbee::DestinationAddressModeIeeeAddress:
         interfaceReply = requestEnqueueSendDataIeeeAddress(request.requestId(), request.destinationIeeeAddress(),
                                                            request.destinationEndpoint(), request.profileId(), request.clusterId(),
-                                                           request.sourceEndpoint(), request.asdu(), request.txOptions(), request.radius());
+                                                           request.sourceEndpoint(), request.asdu(), request.txOptions(), request.radius(), request.priority(), request.destinationKey());
         break;
     }
 
@@ -280,7 +290,7 @@ void ZigbeeBridgeControllerNxp::startFactoryResetUpdate()
     m_firmwareUpdateHandler->startFactoryReset();
 }
 
-ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::createReply(Nxp::Command command, quint8 sequenceNumber, const QString &requestName, const QByteArray &requestData, QObject *parent)
+ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::createReply(Nxp::Command command, quint8 sequenceNumber, const QString &requestName, const QByteArray &requestData, QObject *parent, Zigbee::RequestPriority priority, quint64 destination)
 {
     // Create the reply
     ZigbeeInterfaceNxpReply *reply = new ZigbeeInterfaceNxpReply(command, parent);
@@ -298,11 +308,14 @@ ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::createReply(Nxp::Command com
         if (m_currentReply == reply) {
             m_currentReply = nullptr;
             QMetaObject::invokeMethod(this, "sendNextRequest", Qt::QueuedConnection);
+        } else {
+            // The reply finished before it has been sent
+            m_replyQueue.remove(reply);
         }
     });
 
-    qCDebug(dcZigbeeController()) << "Enqueue request" << reply->command() << "SQN:" << reply->sequenceNumber();
-    m_replyQueue.enqueue(reply);
+    m_replyQueue.enqueue(reply, priority, destination);
+    qCDebug(dcZigbeeController()) << "Enqueue request" << reply->command() << "SQN:" << reply->sequenceNumber() << priority << m_replyQueue;
 
     QMetaObject::invokeMethod(this, "sendNextRequest", Qt::QueuedConnection);
     return reply;
@@ -313,7 +326,7 @@ void ZigbeeBridgeControllerNxp::bumpSequenceNumber()
     m_sequenceNumber += 1;
 }
 
-ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::requestEnqueueSendDataGroup(quint8 requestId, quint16 groupAddress, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius)
+ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::requestEnqueueSendDataGroup(quint8 requestId, quint16 groupAddress, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius, Zigbee::RequestPriority priority, quint64 destination)
 {
     Q_UNUSED(txOptions)
     Q_ASSERT_X(asdu.length() <= 127, "ASDU", "ASDU package length has to <= 127 bytes");
@@ -346,10 +359,10 @@ ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::requestEnqueueSendDataGroup(
         stream << static_cast<quint8>(payload.at(i));
     }
 
-    return createReply(Nxp::CommandSendApsDataRequest, m_sequenceNumber, "Request send ASP data request to group", message, this);
+    return createReply(Nxp::CommandSendApsDataRequest, m_sequenceNumber, "Request send ASP data request to group", message, this, priority, destination);
 }
 
-ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::requestEnqueueSendDataShortAddress(quint8 requestId, quint16 shortAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius)
+ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::requestEnqueueSendDataShortAddress(quint8 requestId, quint16 shortAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius, Zigbee::RequestPriority priority, quint64 destination)
 {
     Q_UNUSED(txOptions)
     Q_ASSERT_X(asdu.length() <= 127, "ASDU", "ASDU package length has to <= 127 bytes");
@@ -382,10 +395,10 @@ ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::requestEnqueueSendDataShortA
         stream << static_cast<quint8>(payload.at(i));
     }
 
-    return createReply(Nxp::CommandSendApsDataRequest, m_sequenceNumber, "Request send ASP data request to short address", message, this);
+    return createReply(Nxp::CommandSendApsDataRequest, m_sequenceNumber, "Request send ASP data request to short address", message, this, priority, destination);
 }
 
-ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::requestEnqueueSendDataIeeeAddress(quint8 requestId, ZigbeeAddress ieeeAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius)
+ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::requestEnqueueSendDataIeeeAddress(quint8 requestId, ZigbeeAddress ieeeAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius, Zigbee::RequestPriority priority, quint64 destination)
 {
     Q_UNUSED(txOptions)
     Q_ASSERT_X(asdu.length() <= 127, "ASDU", "ASDU package length has to <= 127 bytes");
@@ -418,7 +431,7 @@ ZigbeeInterfaceNxpReply *ZigbeeBridgeControllerNxp::requestEnqueueSendDataIeeeAd
         stream << static_cast<quint8>(payload.at(i));
     }
 
-    return createReply(Nxp::CommandSendApsDataRequest, m_sequenceNumber, "Request send ASP data request to IEEE address", message, this);
+    return createReply(Nxp::CommandSendApsDataRequest, m_sequenceNumber, "Request send ASP data request to IEEE address", message, this, priority, destination);
 }
 
 void ZigbeeBridgeControllerNxp::initializeUpdateProvider()
@@ -614,10 +627,12 @@ void ZigbeeBridgeControllerNxp::onInterfacePackageReceived(const QByteArray &pac
         Nxp::Command command = static_cast<Nxp::Command>(commandInt);
         Nxp::Status status = static_cast<Nxp::Status>(statusInt);
         qCDebug(dcZigbeeController()) << "Interface response received" << command << "SQN:" << sequenceNumber << status << ZigbeeUtils::convertByteArrayToHexString(data);
-        if (m_currentReply->sequenceNumber() == sequenceNumber) {
+        if (m_currentReply && m_currentReply->sequenceNumber() == sequenceNumber) {
             if (m_currentReply->command() == command) {
                 m_currentReply->m_status = status;
                 m_currentReply->m_responseData = data;
+                m_currentReply->m_responseTimestamp = m_interface->receivedTimestamp();
+                qCDebug(dcZigbeeController()) << "Response for" << m_currentReply << "received after" << m_currentReply->latency() << "ms";
             } else {
                 qCWarning(dcZigbeeController()) << "Received interface response for a pending sequence number but the command does not match the request." << command << m_currentReply->command();
             }
@@ -641,14 +656,18 @@ void ZigbeeBridgeControllerNxp::sendNextRequest()
     // Send next message
     m_currentReply = m_replyQueue.dequeue();
     qCDebug(dcZigbeeController()) << "Send request" << m_currentReply;
+    m_currentReply->m_sendTimestamp = ZigbeeUtils::monotonicMilliseconds();
     m_interface->sendPackage(m_currentReply->requestData());
-    m_currentReply->m_timer->start();
+    m_currentReply->m_timer.start();
 }
 
 bool ZigbeeBridgeControllerNxp::enable(const QString &serialPort, qint32 baudrate)
 {
     m_serialPort = serialPort;
     m_baudrate = baudrate;
+    if (m_ioThreadEnabled)
+        m_interface->startIoThread();
+
     return m_interface->enable(serialPort, baudrate);
 }
 
@@ -37,6 +37,7 @@
 #include "zigbeeaddress.h"
 #include "zigbeenetworkkey.h"
 #include "zigbeenetworkrequest.h"
+#include "zigbeerequestscheduler.h"
 #include "zigbeebridgecontroller.h"
 #include "firmwareupdatehandlernxp.h"
 #include "interface/zigbeeinterfacenxp.h"
@@ -73,6 +74,11 @@ public:
     ControllerState controllerState() const;
     void refreshControllerState();
 
+    int requestQueueDepth(Zigbee::RequestPriority priority) const override;
+
+    // Monotonic receive time of the frame currently being processed, taken when it was read from the UART
+    qint64 receivedTimestamp() const;
+
     // Controllere requests
     ZigbeeInterfaceNxpReply *requestVersion();
     ZigbeeInterfaceNxpReply *requestControllerState();
@@ -112,14 +118,14 @@ private:
     quint8 m_sequenceNumber = 0;
 
     ZigbeeInterfaceNxpReply *m_currentReply = nullptr;
-    QQueue<ZigbeeInterfaceNxpReply *> m_replyQueue;
-    ZigbeeInterfaceNxpReply *createReply(Nxp::Command command, quint8 sequenceNumber, const QString &requestName, const QByteArray &requestData, QObject *parent);
+    ZigbeeRequestScheduler<ZigbeeInterfaceNxpReply *> m_replyQueue;
+    ZigbeeInterfaceNxpReply *createReply(Nxp::Command command, quint8 sequenceNumber, const QString &requestName, const QByteArray &requestData, QObject *parent, Zigbee::RequestPriority priority = Zigbee::RequestPriorityUser, quint64 destination = 0);
 
     void bumpSequenceNumber();
 
-    ZigbeeInterfaceNxpReply *requestEnqueueSendDataGroup(quint8 requestId, quint16 groupAddress, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0);
-    ZigbeeInterfaceNxpReply *requestEnqueueSendDataShortAddress(quint8 requestId, quint16 shortAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0);
-    ZigbeeInterfaceNxpReply *requestEnqueueSendDataIeeeAddress(quint8 requestId, ZigbeeAddress ieeeAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0);
+    ZigbeeInterfaceNxpReply *requestEnqueueSendDataGroup(quint8 requestId, quint16 groupAddress, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0, Zigbee::RequestPriority priority = Zigbee::RequestPriorityUser, quint64 destination = 0);
+    ZigbeeInterfaceNxpReply *requestEnqueueSendDataShortAddress(quint8 requestId, quint16 shortAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0, Zigbee::RequestPriority priority = Zigbee::RequestPriorityUser, quint64 destination = 0);
+    ZigbeeInterfaceNxpReply *requestEnqueueSendDataIeeeAddress(quint8 requestId, ZigbeeAddress ieeeAddress, quint8 destinationEndpoint, quint16 profileId, quint16 clusterId, quint8 sourceEndpoint, const QByteArray &asdu, Zigbee::ZigbeeTxOptions txOptions, quint8 radius = 0, Zigbee::RequestPriority priority = Zigbee::RequestPriorityUser, quint64 destination = 0);
 
 protected:
     void initializeUpdateProvider() override;
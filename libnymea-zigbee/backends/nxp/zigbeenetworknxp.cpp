@@ -78,6 +78,13 @@ ZigbeeNetworkReply *ZigbeeNetworkNxp::sendRequest(const ZigbeeNetworkRequest &re
     ZigbeeNetworkReply *reply = createNetworkReply(request);
     // Send the request, and keep the reply until transposrt, zigbee trasmission and response arrived
     connect(reply, &ZigbeeNetworkReply::finished, this, [this, reply](){
+        m_replyQueue.remove(reply);
+        if (m_inFlightReplies.contains(reply)) {
+            // The reply finished without a confirmation, i.e. on timeout or for local requests
+            releaseSendSlot(reply, ZigbeeUtils::monotonicMilliseconds());
+            sendNextReply();
+        }
+
         if (m_pendingReplies.values().contains(reply)) {
             quint8 requestId = m_pendingReplies.key(reply);
             m_pendingReplies.remove(requestId);
@@ -99,13 +106,18 @@ ZigbeeNetworkReply *ZigbeeNetworkNxp::sendRequest(const ZigbeeNetworkRequest &re
     }
 
     // Enqueu reply and send next one if we have enouth capacity
-    m_replyQueue.enqueue(reply);
+    m_replyQueue.enqueue(reply, request.priority(), request.destinationKey());
     //qCDebug(dcZigbeeNetwork()) << "=== Pending replies count (enqueued)" << m_replyQueue.count();
     sendNextReply();
 
     return reply;
 }
 
+ZigbeeNetworkNxp::SendWindowStatistics ZigbeeNetworkNxp::sendWindowStatistics() const
+{
+    return m_sendWindowStatistics;
+}
+
 void ZigbeeNetworkNxp::setPermitJoining(quint8 duration, quint16 address)
 {
     if (duration > 0) {
@@ -160,58 +172,67 @@ void ZigbeeNetworkNxp::setPermitJoining(quint8 duration, quint16 address)
 
 void ZigbeeNetworkNxp::sendNextReply()
 {
-    if (m_replyQueue.isEmpty())
-        return;
-
-    if (m_currentReply)
-        return;
+    // Fill the send window. If more requests are pending in the firmware than it can buffer, confirmations get lost.
+    while (!m_replyQueue.isEmpty() && m_inFlightReplies.count() < m_sendWindow) {
+        ZigbeeNetworkReply *reply = m_replyQueue.dequeue();
+        m_inFlightReplies.insert(reply, ZigbeeUtils::monotonicMilliseconds());
+        m_sendWindowStatistics.requestsSent++;
+        m_sendWindowStatistics.peakInFlight = qMax(m_sendWindowStatistics.peakInFlight, static_cast<quint32>(m_inFlightReplies.count()));
+        //qCDebug(dcZigbeeNetwork()) << "=== Pending replies count (dequeued)" << m_replyQueue.count();
+
+        ZigbeeInterfaceNxpReply *interfaceReply = m_controller->requestSendRequest(reply->request());
+        connect(interfaceReply, &ZigbeeInterfaceNxpReply::finished, reply, [this, reply, interfaceReply](){
+            if (interfaceReply->status() != Nxp::StatusSuccess) {
+                qCWarning(dcZigbeeController()) << "Could send request to controller. SQN:" << interfaceReply->sequenceNumber() << interfaceReply->status();
+                if (interfaceReply->status() == Nxp::StatusStackError && m_sendWindow > 1) {
+                    // The firmware ran out of buffers, the requests already in flight are what it can handle right now
+                    m_sendWindow = qMax(1, m_inFlightReplies.count() - 1);
+                    qCDebug(dcZigbeeNetwork()) << "Shrinking the send window to" << m_sendWindow;
+                }
+                finishReplyInternally(reply, ZigbeeNetworkReply::ErrorInterfaceError);
+                return;
+            }
 
+            // Note: this is a special case for nxp coordinator requests, they don't send a confirm because the request will not be sent trough the network
+            if ((reply->request().destinationAddressMode() == Zigbee::DestinationAddressModeShortAddress &&
+                    reply->request().destinationShortAddress() == 0x0000 &&
+                    reply->request().profileId() == Zigbee::ZigbeeProfileDevice) ||
+                    (reply->request().destinationAddressMode() == Zigbee::DestinationAddressModeIeeeAddress &&
+                     m_coordinatorNode &&
+                     reply->request().destinationIeeeAddress() == m_coordinatorNode->extendedAddress() &&
+                     reply->request().profileId() == Zigbee::ZigbeeProfileDevice)) {
+
+                qCDebug(dcZigbeeNetwork()) << "Finish reply since there will be no CONFIRM for local node requests.";
+                finishReplyInternally(reply);
+                return;
+            }
 
-    ZigbeeNetworkReply *reply = m_replyQueue.dequeue();
-    //qCDebug(dcZigbeeNetwork()) << "=== Pending replies count (dequeued)" << m_replyQueue.count();
+            quint8 networkRequestId = interfaceReply->responseData().at(0);
+            ZigbeeNetworkRequest request = reply->request();
+            request.setRequestId(networkRequestId);
+            updateReplyRequest(reply, request);
 
-    ZigbeeInterfaceNxpReply *interfaceReply = m_controller->requestSendRequest(reply->request());
-    connect(interfaceReply, &ZigbeeInterfaceNxpReply::finished, reply, [this, reply, interfaceReply](){
-        if (interfaceReply->status() != Nxp::StatusSuccess) {
-            qCWarning(dcZigbeeController()) << "Could send request to controller. SQN:" << interfaceReply->sequenceNumber() << interfaceReply->status();
-            finishReplyInternally(reply, ZigbeeNetworkReply::ErrorInterfaceError);
-            return;
-        }
+            qCDebug(dcZigbeeAps()) << "Request SQN updated:" << reply->request();
 
-        // Note: this is a special case for nxp coordinator requests, they don't send a confirm because the request will not be sent trough the network
-        if ((reply->request().destinationAddressMode() == Zigbee::DestinationAddressModeShortAddress &&
-                reply->request().destinationShortAddress() == 0x0000 &&
-                reply->request().profileId() == Zigbee::ZigbeeProfileDevice) ||
-                (reply->request().destinationAddressMode() == Zigbee::DestinationAddressModeIeeeAddress &&
-                 m_coordinatorNode &&
-                 reply->request().destinationIeeeAddress() == m_coordinatorNode->extendedAddress() &&
-                 reply->request().profileId() == Zigbee::ZigbeeProfileDevice)) {
-
-            qCDebug(dcZigbeeNetwork()) << "Finish reply since there will be no CONFIRM for local node requests.";
-            finishReplyInternally(reply);
-            return;
-        }
-
-        quint8 networkRequestId = interfaceReply->responseData().at(0);
-        ZigbeeNetworkRequest request = reply->request();
-        request.setRequestId(networkRequestId);
-        updateReplyRequest(reply, request);
+            // The firmware assigns the request ids, an older request still holding this id will never be confirmed
+            ZigbeeNetworkReply *staleReply = m_pendingReplies.value(networkRequestId, m_bufferedReplies.value(networkRequestId));
+            if (staleReply && staleReply != reply) {
+                qCWarning(dcZigbeeNetwork()) << "Request id" << networkRequestId << "has been reused while still in flight. Failing" << staleReply->request();
+                m_pendingReplies.remove(networkRequestId);
+                m_bufferedReplies.remove(networkRequestId);
+                finishReplyInternally(staleReply, ZigbeeNetworkReply::ErrorRequestIdUnavailable);
+            }
 
-        qCDebug(dcZigbeeAps()) << "Request SQN updated:" << reply->request();
-        //qCWarning(dcZigbeeNetwork()) << "#### Insert network reply" << reply << "ID:" << networkRequestId << "Current reply count" << m_pendingReplies.count();
-        m_pendingReplies.insert(networkRequestId, reply);
-        // The request has been sent successfully to the device, start the timeout timer now
-        startWaitingReply(reply);
-    });
+            m_pendingReplies.insert(networkRequestId, reply);
+            // The request has been sent successfully to the device, start the timeout timer now
+            startWaitingReply(reply);
+        });
+    }
 }
 
 void ZigbeeNetworkNxp::finishReplyInternally(ZigbeeNetworkReply *reply, ZigbeeNetworkReply::Error error)
 {
     finishNetworkReply(reply, error);
-    if (m_currentReply == reply) {
-        m_currentReply = nullptr;
-    }
-
     sendNextReply();
 }
 
@@ -312,6 +333,7 @@ void ZigbeeNetworkNxp::onControllerAvailableChanged(bool available)
         }
 
         m_reconnectCounter = 0;
+        m_sendWindow = m_maxInFlightReplies;
         ZigbeeInterfaceNxpReply *reply = m_controller->requestVersion();
         connect(reply, &ZigbeeInterfaceNxpReply::finished, this, [this, reply](){
             // Retry or firmware upgrade if available
@@ -540,7 +562,27 @@ void ZigbeeNetworkNxp::onApsDataConfirmReceived(const Zigbee::ApsdeDataConfirm &
         return;
     }
 
+    // The firmware released the request buffer, there is room for the next request
+    releaseSendSlot(reply, m_controller->receivedTimestamp());
+    if (m_sendWindow < m_maxInFlightReplies)
+        m_sendWindow++;
+
     setReplyResponseError(reply, confirm.zigbeeStatusCode);
+    sendNextReply();
+}
+
+void ZigbeeNetworkNxp::releaseSendSlot(ZigbeeNetworkReply *reply, qint64 timestamp)
+{
+    if (!m_inFlightReplies.contains(reply))
+        return;
+
+    qint64 latency = timestamp - m_inFlightReplies.take(reply);
+    m_sendWindowStatistics.requestsCompleted++;
+    m_sendWindowStatistics.lastLatency = latency;
+    m_sendWindowStatistics.maxLatency = qMax(m_sendWindowStatistics.maxLatency, latency);
+    m_sendWindowStatistics.totalLatency += latency;
+    qCDebug(dcZigbeeNetwork()) << "Request left the send window after" << latency << "ms. In flight:" << m_inFlightReplies.count() << "/" << m_sendWindow
+                               << "Average latency:" << m_sendWindowStatistics.totalLatency / m_sendWindowStatistics.requestsCompleted << "ms";
 }
 
 void ZigbeeNetworkNxp::onApsDataIndicationReceived(const Zigbee::ApsdeDataIndication &indication)
@@ -598,6 +640,7 @@ void ZigbeeNetworkNxp::startNetwork()
 
     setPermitJoiningState(false);
 
+    m_controller->setIoThreadEnabled(serialIoThreadEnabled());
     if (!m_controller->enable(serialPortName(), serialBaudrate())) {
         setState(StateOffline);
         setError(ErrorHardwareUnavailable);
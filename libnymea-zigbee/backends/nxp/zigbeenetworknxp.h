@@ -33,6 +33,7 @@
 
 #include "zigbeenetwork.h"
 #include "zigbeechannelmask.h"
+#include "zigbeerequestscheduler.h"
 #include "zcl/zigbeeclusterlibrary.h"
 #include "zigbeebridgecontrollernxp.h"
 
@@ -40,6 +41,15 @@ class ZigbeeNetworkNxp : public ZigbeeNetwork
 {
     Q_OBJECT
 public:
+    typedef struct SendWindowStatistics {
+        quint32 requestsSent = 0;
+        quint32 requestsCompleted = 0;
+        quint32 peakInFlight = 0;
+        qint64 lastLatency = 0;
+        qint64 maxLatency = 0;
+        qint64 totalLatency = 0;
+    } SendWindowStatistics;
+
     explicit ZigbeeNetworkNxp(const QUuid &networkUuid, QObject *parent = nullptr);
 
     ZigbeeBridgeController *bridgeController() const override;
@@ -48,6 +58,8 @@ public:
 
     void setPermitJoining(quint8 duration, quint16 address = Zigbee::BroadcastAddressAllRouters) override;
 
+    SendWindowStatistics sendWindowStatistics() const;
+
 private:
     ZigbeeBridgeControllerNxp *m_controller = nullptr;
     bool m_networkRunning = false;
@@ -55,10 +67,16 @@ private:
     QHash<quint8, ZigbeeNetworkReply *> m_pendingReplies;
     QHash<quint8, ZigbeeNetworkReply *> m_bufferedReplies;
 
-    QQueue<ZigbeeNetworkReply *> m_replyQueue;
-    ZigbeeNetworkReply *m_currentReply = nullptr;
+    // Send window: APS data requests handed to the firmware and not confirmed yet, with the time they have been sent.
+    // The firmware only has a few APDU buffers for outgoing requests, the window shrinks if it reports a stack error.
+    ZigbeeRequestScheduler<ZigbeeNetworkReply *> m_replyQueue;
+    QHash<ZigbeeNetworkReply *, qint64> m_inFlightReplies;
+    int m_maxInFlightReplies = 4;
+    int m_sendWindow = 4;
+    SendWindowStatistics m_sendWindowStatistics;
 
     void sendNextReply();
+    void releaseSendSlot(ZigbeeNetworkReply *reply, qint64 timestamp);
     void finishReplyInternally(ZigbeeNetworkReply *reply, ZigbeeNetworkReply::Error error = ZigbeeNetworkReply::ErrorNoError);
 
     int m_reconnectCounter = 0;
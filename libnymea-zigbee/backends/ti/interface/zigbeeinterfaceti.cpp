@@ -30,8 +30,11 @@
 #include "zigbeeutils.h"
 #include "loggingcategory.h"
 
+#include <QThread>
 #include <QDataStream>
 
+#include <string.h>
+
 ZigbeeInterfaceTi::ZigbeeInterfaceTi(QObject *parent) : QObject(parent)
 {
     m_reconnectTimer = new QTimer(this);
@@ -39,6 +42,9 @@ ZigbeeInterfaceTi::ZigbeeInterfaceTi(QObject *parent) : QObject(parent)
     m_reconnectTimer->setInterval(5000);
 
     connect(m_reconnectTimer, &QTimer::timeout, this, &ZigbeeInterfaceTi::onReconnectTimeout);
+
+    // Keep the receive buffer memory, it gets compacted instead of released
+    m_dataBuffer.reserve(4096);
 }
 
 ZigbeeInterfaceTi::~ZigbeeInterfaceTi()
@@ -48,12 +54,33 @@ ZigbeeInterfaceTi::~ZigbeeInterfaceTi()
 
 bool ZigbeeInterfaceTi::available() const
 {
-    return m_available;
+    return m_available.loadAcquire() != 0;
 }
 
 QString ZigbeeInterfaceTi::serialPort() const
 {
-    return m_serialPort->portName();
+    QMutexLocker locker(&m_serialPortNameMutex);
+    return m_serialPortName;
+}
+
+void ZigbeeInterfaceTi::startIoThread()
+{
+    if (m_ioThread)
+        return;
+
+    m_ioThread = new ZigbeeInterfaceThread("TI UART", parent());
+    connect(m_ioThread, &ZigbeeInterfaceThread::receiveQueueReady, this, &ZigbeeInterfaceTi::processReceiveQueue, Qt::DirectConnection);
+    m_ioThread->startInterface(this);
+}
+
+bool ZigbeeInterfaceTi::ioThreadRunning() const
+{
+    return m_ioThread && m_ioThread->isRunning();
+}
+
+qint64 ZigbeeInterfaceTi::receivedTimestamp() const
+{
+    return m_receivedTimestamp;
 }
 
 void ZigbeeInterfaceTi::sendMagicByte()
@@ -61,40 +88,51 @@ void ZigbeeInterfaceTi::sendMagicByte()
     QByteArray message;
     QDataStream stream(&message, QIODevice::WriteOnly);
     stream << static_cast<quint8>(0xef);
-    m_serialPort->write(message);
+    writeData(message);
 }
 
 void ZigbeeInterfaceTi::setDTR(bool dtr)
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "setDTR", Qt::BlockingQueuedConnection, Q_ARG(bool, dtr));
+        return;
+    }
+
     m_serialPort->setDataTerminalReady(dtr);
 }
 
 void ZigbeeInterfaceTi::setRTS(bool rts)
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "setRTS", Qt::BlockingQueuedConnection, Q_ARG(bool, rts));
+        return;
+    }
+
     m_serialPort->setRequestToSend(rts);
 }
 
-quint8 ZigbeeInterfaceTi::calculateChecksum(const QByteArray &data)
+quint8 ZigbeeInterfaceTi::calculateChecksum(const char *data, int length)
 {
     quint8 checksum = 0;
-    for (int i = 0; i < data.length(); i++) {
-        checksum ^= static_cast<quint8>(data.at(i));
+    for (int i = 0; i < length; i++) {
+        checksum ^= static_cast<quint8>(data[i]);
     }
     return checksum;
 }
 
 void ZigbeeInterfaceTi::setAvailable(bool available)
 {
-    if (m_available == available)
+    if ((m_available.loadAcquire() != 0) == available)
         return;
 
     // Clear the data buffer in any case
-    if (m_available) {
-        m_dataBuffer.clear();
+    if (m_available.loadAcquire() != 0) {
+        m_dataBuffer.resize(0);
+        m_readOffset = 0;
     }
 
-    m_available = available;
-    emit availableChanged(m_available);
+    m_available.storeRelease(available ? 1 : 0);
+    emit availableChanged(available);
 }
 
 void ZigbeeInterfaceTi::onReconnectTimeout()
@@ -114,55 +152,98 @@ void ZigbeeInterfaceTi::onReconnectTimeout()
 
 void ZigbeeInterfaceTi::onReadyRead()
 {
-    m_dataBuffer.append(m_serialPort->readAll());
+    QByteArray data = m_serialPort->readAll();
+    m_readTimestamp = ZigbeeUtils::monotonicMilliseconds();
+    qCDebug(dcZigbeeInterfaceTraffic()) << "<--" << data.toHex();
+    m_dataBuffer.append(data);
     processBuffer();
 }
 
 void ZigbeeInterfaceTi::processBuffer()
 {
-    if (m_dataBuffer.isEmpty()) {
-        return;
-    }
+    // Packet must be SOF + payload length field + CMD0 + CMD1 + payload length + Checksum
+    while (m_readOffset < m_dataBuffer.length()) {
+        const char *data = m_dataBuffer.constData() + m_readOffset;
+        int available = m_dataBuffer.length() - m_readOffset;
+
+        // StartOfFrame, resynchronize on the next SOF byte in one go
+        if (static_cast<quint8>(data[0]) != SOF) {
+            const char *sof = static_cast<const char *>(memchr(data, SOF, static_cast<size_t>(available)));
+            int discard = sof ? static_cast<int>(sof - data) : available;
+            qCWarning(dcZigbeeInterface()) << "Data doesn't start with StartOfFrame byte 0xfe. Discarding" << discard << "bytes...";
+            m_readOffset += discard;
+            continue;
+        }
 
-    qCDebug(dcZigbeeInterfaceTraffic()) << "<--" << m_dataBuffer.toHex();
-    // StartOfFrame
-    if (static_cast<quint8>(m_dataBuffer.at(0)) != SOF) {
-        qCWarning(dcZigbeeInterface()) << "Data doesn't start with StartOfFrame byte 0xfe. Discarding data...";
-        m_dataBuffer.remove(0, 1);
-        processBuffer();
-        return;
-    }
+        if (available < 2) {
+            break;
+        }
 
-    // payload length
-    quint8 payloadLength = static_cast<quint8>(m_dataBuffer[1]);
-    // Packet must be SOF + payload length field + CMD0 + CMD1 + payload length + Checksum
-    if (m_dataBuffer.length() < payloadLength + 5) {
-        qCDebug(dcZigbeeInterface()) << "Not enough data in buffer....";
-        return;
-    }
-    QByteArray packet = m_dataBuffer.left(5 + payloadLength);
-    m_dataBuffer.remove(0, 5 + payloadLength);
+        // payload length
+        quint8 payloadLength = static_cast<quint8>(data[1]);
+        int packetLength = payloadLength + 5;
+        if (available < packetLength) {
+            qCDebug(dcZigbeeInterface()) << "Not enough data in buffer....";
+            break;
+        }
+
+        quint8 checksum = static_cast<quint8>(data[4 + payloadLength]);
+        if (calculateChecksum(data + 1, 3 + payloadLength) != checksum) {
+            // Skip only the SOF byte, this might have been line noise and a valid frame could start within
+            qCWarning(dcZigbeeInterface()) << "Checksum mismatch!";
+            m_readOffset += 1;
+            continue;
+        }
 
-    quint8 cmd0 = static_cast<quint8>(packet[2]);
-    quint8 cmd1 = static_cast<quint8>(packet[3]);
-    QByteArray payload = packet.mid(4, payloadLength);
-    quint8 checksum = packet.at(4 + payloadLength);
+        quint8 cmd0 = static_cast<quint8>(data[2]);
+        quint8 cmd1 = static_cast<quint8>(data[3]);
+        Ti::SubSystem subSystem = static_cast<Ti::SubSystem>(cmd0 & 0x1F);
+        Ti::CommandType type = static_cast<Ti::CommandType>(cmd0 & 0xE0);
 
-    if (calculateChecksum(packet.mid(1, 3 + payloadLength)) != checksum) {
-        qCWarning(dcZigbeeInterface()) << "Checksum mismatch!";
-        processBuffer();
-        return;
-    }
-//    qCDebug(dcZigbeeInterface()) << "packet received:" << payloadLength << cmd0 << command << payload.toHex(' ') << checksum;
+        // The payload is the only copy of the packet data, receivers are allowed to keep it
+        QByteArray payload(data + 4, payloadLength);
+        m_readOffset += packetLength;
 
-    Ti::SubSystem subSystem = static_cast<Ti::SubSystem>(cmd0 & 0x1F);
-    Ti::CommandType type = static_cast<Ti::CommandType>(cmd0 & 0xE0);
+        if (!m_ioThread) {
+            m_receivedTimestamp = m_readTimestamp;
+            emit packetReceived(subSystem, type, cmd1, payload);
+            continue;
+        }
 
-    emit packetReceived(subSystem, type, cmd1, payload);
+        // Hand the packet over to the controller thread
+        ReceivedPacket packet;
+        packet.subSystem = subSystem;
+        packet.type = type;
+        packet.command = cmd1;
+        packet.payload = payload;
+        packet.timestamp = m_readTimestamp;
+        if (!m_receiveQueue.enqueue(packet)) {
+            qCWarning(dcZigbeeInterface()) << "Receive queue full. Dropping packet" << subSystem << type << cmd1 << payload.toHex();
+            continue;
+        }
 
-    // In case there's more...
-    processBuffer();
+        if (m_receiveQueue.requestWakeUp()) {
+            m_ioThread->notifyReceiveQueueReady();
+        }
+    }
 
+    compactBuffer();
+}
+
+void ZigbeeInterfaceTi::compactBuffer()
+{
+    // Everything consumed, reuse the reserved memory from the start
+    if (m_readOffset >= m_dataBuffer.length()) {
+        m_dataBuffer.resize(0);
+        m_readOffset = 0;
+        return;
+    }
+
+    // Move the pending data to the front only once the consumed part dominates the buffer
+    if (m_readOffset >= 4096 && m_readOffset >= m_dataBuffer.length() / 2) {
+        m_dataBuffer.remove(0, m_readOffset);
+        m_readOffset = 0;
+    }
 }
 
 void ZigbeeInterfaceTi::onError(const QSerialPort::SerialPortError &error)
@@ -175,13 +256,31 @@ void ZigbeeInterfaceTi::onError(const QSerialPort::SerialPortError &error)
     }
 }
 
-void ZigbeeInterfaceTi::sendPacket(Ti::CommandType type, Ti::SubSystem subSystem, quint8 command, const QByteArray &payload)
+void ZigbeeInterfaceTi::processReceiveQueue()
 {
-    if (!m_available) {
-        qCWarning(dcZigbeeInterface()) << "Can not send data. The interface is not available";
-        return;
+    // Runs in the controller thread
+    m_receiveQueue.acknowledgeWakeUp();
+
+    ReceivedPacket packet;
+    while (m_receiveQueue.dequeue(&packet)) {
+        m_receivedTimestamp = packet.timestamp;
+        emit packetReceived(packet.subSystem, packet.type, packet.command, packet.payload);
+    }
+}
+
+void ZigbeeInterfaceTi::processSendQueue()
+{
+    // Runs in the I/O thread
+    m_sendQueue.acknowledgeWakeUp();
+
+    QByteArray data;
+    while (m_sendQueue.dequeue(&data)) {
+        writeData(data);
     }
+}
 
+void ZigbeeInterfaceTi::sendPacket(Ti::CommandType type, Ti::SubSystem subSystem, quint8 command, const QByteArray &payload)
+{
     quint8 cmd0 = type | subSystem;
 
     // Build transport data
@@ -194,19 +293,46 @@ void ZigbeeInterfaceTi::sendPacket(Ti::CommandType type, Ti::SubSystem subSystem
     for (int i = 0; i < payload.length(); i++) {
         stream << static_cast<quint8>(payload.at(i));
     }
-    stream << calculateChecksum(data.right(data.length() - 1));
+    stream << calculateChecksum(data.constData() + 1, data.length() - 1);
+
+    writeData(data);
+}
+
+void ZigbeeInterfaceTi::writeData(const QByteArray &data)
+{
+    if (QThread::currentThread() != thread()) {
+        // Hand the data over to the I/O thread
+        if (!m_sendQueue.enqueue(data)) {
+            qCWarning(dcZigbeeInterface()) << "Send queue full. Dropping data" << ZigbeeUtils::convertByteArrayToHexString(data);
+            return;
+        }
+
+        if (m_sendQueue.requestWakeUp()) {
+            QMetaObject::invokeMethod(this, "processSendQueue", Qt::QueuedConnection);
+        }
+        return;
+    }
+
+    if (!available()) {
+        qCWarning(dcZigbeeInterface()) << "Can not send data. The interface is not available";
+        return;
+    }
 
     // Send the data
     qCDebug(dcZigbeeInterfaceTraffic()) << "-->" << data.toHex();
     if (m_serialPort->write(data) < 0) {
         qCWarning(dcZigbeeInterface()) << "Could not stream byte" << ZigbeeUtils::convertByteArrayToHexString(data);
     }
-
-    //m_serialPort->flush();
 }
 
 bool ZigbeeInterfaceTi::enable(const QString &serialPort, qint32 baudrate)
 {
+    if (QThread::currentThread() != thread()) {
+        bool success = false;
+        QMetaObject::invokeMethod(this, "enable", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, success), Q_ARG(QString, serialPort), Q_ARG(qint32, baudrate));
+        return success;
+    }
+
     qCDebug(dcZigbeeInterface()) << "Start UART interface " << serialPort << baudrate;
 
     if (m_serialPort) {
@@ -215,6 +341,9 @@ bool ZigbeeInterfaceTi::enable(const QString &serialPort, qint32 baudrate)
     }
 
     m_serialPort = new QSerialPort(serialPort, this);
+    m_serialPortNameMutex.lock();
+    m_serialPortName = serialPort;
+    m_serialPortNameMutex.unlock();
     m_serialPort->setBaudRate(baudrate);
     m_serialPort->setDataBits(QSerialPort::Data8);
     m_serialPort->setStopBits(QSerialPort::OneStop);
@@ -240,6 +369,11 @@ bool ZigbeeInterfaceTi::enable(const QString &serialPort, qint32 baudrate)
 
 void ZigbeeInterfaceTi::reconnectController()
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "reconnectController", Qt::BlockingQueuedConnection);
+        return;
+    }
+
     if (!m_serialPort)
         return;
 
@@ -254,6 +388,11 @@ void ZigbeeInterfaceTi::reconnectController()
 
 void ZigbeeInterfaceTi::disable()
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, "disable", Qt::BlockingQueuedConnection);
+        return;
+    }
+
     if (!m_serialPort)
         return;
 
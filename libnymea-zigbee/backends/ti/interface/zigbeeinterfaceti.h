@@ -28,10 +28,14 @@
 #ifndef ZIGBEEINTERFACETI_H
 #define ZIGBEEINTERFACETI_H
 
-#include <QObject>
+#include <QMutex>
 #include <QTimer>
+#include <QObject>
+#include <QAtomicInt>
 #include <QSerialPort>
 #include "zigbeeinterfacetireply.h"
+#include "zigbeespscqueue.h"
+#include "zigbeeinterfacethread.h"
 
 #define SOF 0xFE
 
@@ -45,13 +49,19 @@ public:
     bool available() const;
     QString serialPort() const;
 
-    void sendMagicByte();
-    void setDTR(bool dtr);
-    void setRTS(bool rts);
+    // Optional dedicated I/O thread for reading, decoding and writing frames. Has to be started before enabling the interface.
+    void startIoThread();
+    bool ioThreadRunning() const;
+
+    // Monotonic timestamp of the packet currently delivered by packetReceived(), taken when it was read from the UART
+    qint64 receivedTimestamp() const;
 
+    void sendMagicByte();
     void sendPacket(Ti::CommandType type, Ti::SubSystem subSystem, quint8 command, const QByteArray &payload);
 
 public slots:
+    void setDTR(bool dtr);
+    void setRTS(bool rts);
     bool enable(const QString &serialPort = "/dev/ttyS0", qint32 baudrate = 38400);
     void reconnectController();
     void disable();
@@ -65,14 +75,36 @@ private slots:
     void onReadyRead();
     void onError(const QSerialPort::SerialPortError &error);
     void processBuffer();
+    void processReceiveQueue();
+    void processSendQueue();
 
 private:
+    typedef struct ReceivedPacket {
+        Ti::SubSystem subSystem = Ti::SubSystemReserved;
+        Ti::CommandType type = Ti::CommandTypePoll;
+        quint8 command = 0;
+        QByteArray payload;
+        qint64 timestamp = 0;
+    } ReceivedPacket;
+
     QTimer *m_reconnectTimer = nullptr;
     QSerialPort *m_serialPort = nullptr;
-    bool m_available = false;
+    // Written by the I/O thread, read from the controller thread
+    QAtomicInt m_available;
+    mutable QMutex m_serialPortNameMutex;
+    QString m_serialPortName;
     QByteArray m_dataBuffer;
+    int m_readOffset = 0;
+
+    ZigbeeInterfaceThread *m_ioThread = nullptr;
+    ZigbeeSpscQueue<ReceivedPacket> m_receiveQueue;
+    ZigbeeSpscQueue<QByteArray> m_sendQueue;
+    qint64 m_readTimestamp = 0;
+    qint64 m_receivedTimestamp = 0;
 
-    quint8 calculateChecksum(const QByteArray &data);
+    quint8 calculateChecksum(const char *data, int length);
+    void compactBuffer();
+    void writeData(const QByteArray &data);
 
     void setAvailable(bool available);
 };
@@ -64,18 +64,16 @@ bool ZigbeeInterfaceTiReply::aborted() const
 
 void ZigbeeInterfaceTiReply::abort()
 {
-    m_timer->stop();
+    m_timer.stop();
     m_aborted = true;
     emit finished();
 }
 
 ZigbeeInterfaceTiReply::ZigbeeInterfaceTiReply(QObject *parent, int timeout):
-    QObject(parent),
-    m_timer(new QTimer(this))
+    QObject(parent)
 {
-    m_timer->setInterval(timeout);
-    m_timer->setSingleShot(true);
-    connect(m_timer, &QTimer::timeout, this, &ZigbeeInterfaceTiReply::onTimeout);
+    m_timer.setInterval(timeout);
+    m_timer.setCallback([this](){ onTimeout(); });
 
     // We'll auto-delete ourselves.
     connect(this, &ZigbeeInterfaceTiReply::finished, this, &QObject::deleteLater, Qt::QueuedConnection);
@@ -29,9 +29,9 @@
 #define ZIGBEEINTERFACETIREPLY_H
 
 #include <QObject>
-#include <QTimer>
 
 #include "ti.h"
+#include "zigbeetimerwheel.h"
 #include "zigbeenetworkrequest.h"
 
 class ZigbeeInterfaceTiReply: public QObject
@@ -67,7 +67,7 @@ private slots:
     void finish(Ti::StatusCode statusCode = Ti::StatusCodeSuccess);
 
 private:
-    QTimer *m_timer = nullptr;
+    ZigbeeTimeout m_timer;
     bool m_timeout = false;
     bool m_aborted = false;
 
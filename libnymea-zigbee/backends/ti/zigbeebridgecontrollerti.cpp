@@ -345,7 +345,7 @@ void ZigbeeBridgeControllerTi::postStartup()
             stream << static_cast<quint16>(0x0000); // dstaddr
             stream << static_cast<quint16>(0x0000); // networkOfInterest
             sendCommand(Ti::SubSystemZDO, Ti::ZDOCommandActiveEpReq, payload);
-            waitFor(reply, Ti::SubSystemZDO, Ti::ZDOCommandActiveEpRsp);
+            waitFor(reply, Ti::SubSystemZDO, Ti::ZDOCommandActiveEpRsp, 0x0000);
             connect(reply, &ZigbeeInterfaceTiReply::finished, this, [=](){
                 PAYLOAD_STREAM(reply->responsePayload());
                 quint8 status, activeEpCount;
@@ -433,7 +433,7 @@ ZigbeeInterfaceTiReply *ZigbeeBridgeControllerTi::requestSendRequest(const Zigbe
         for (int i = 0; i < asdu.length(); i++) {
             stream << static_cast<quint8>(asdu.at(i));
         }
-        return sendCommand(Ti::SubSystemAF, Ti::AFCommandDataRequestExt, payload);
+        return sendCommand(Ti::SubSystemAF, Ti::AFCommandDataRequestExt, payload, 5000, request.priority(), request.destinationKey());
     }
 
     // NOTE: Leaving those prints as warnings for now as I didn't get the chance to test this much
@@ -450,11 +450,16 @@ ZigbeeInterfaceTiReply *ZigbeeBridgeControllerTi::requestSendRequest(const Zigbe
         NEW_PAYLOAD;
         stream << static_cast<quint16>(i++);
         stream << static_cast<quint8>(chunk.length());
-        lastReply = sendCommand(Ti::SubSystemAF, Ti::AFCommandDataStore, chunk);
+        lastReply = sendCommand(Ti::SubSystemAF, Ti::AFCommandDataStore, chunk, 5000, request.priority(), request.destinationKey());
     }
     return lastReply;
 }
 
+int ZigbeeBridgeControllerTi::requestQueueDepth(Zigbee::RequestPriority priority) const
+{
+    return m_replyQueue.count(priority);
+}
+
 void ZigbeeBridgeControllerTi::sendNextRequest()
 {
     // Check if there is a reply request to send
@@ -481,10 +486,10 @@ void ZigbeeBridgeControllerTi::sendNextRequest()
         << m_currentReply->requestPayload().toHex();
 
     m_interface->sendPacket(Ti::CommandTypeSReq, m_currentReply->subSystem(), m_currentReply->command(), m_currentReply->requestPayload());
-    m_currentReply->m_timer->start();
+    m_currentReply->m_timer.start();
 }
 
-ZigbeeInterfaceTiReply *ZigbeeBridgeControllerTi::sendCommand(Ti::SubSystem subSystem, quint8 command, const QByteArray &payload, int timeout)
+ZigbeeInterfaceTiReply *ZigbeeBridgeControllerTi::sendCommand(Ti::SubSystem subSystem, quint8 command, const QByteArray &payload, int timeout, Zigbee::RequestPriority priority, quint64 destination)
 {
     // Create the reply
     ZigbeeInterfaceTiReply *reply = new ZigbeeInterfaceTiReply(subSystem, command, this, payload, timeout);
@@ -500,10 +505,13 @@ ZigbeeInterfaceTiReply *ZigbeeBridgeControllerTi::sendCommand(Ti::SubSystem subS
         if (m_currentReply == reply) {
             m_currentReply = nullptr;
             QMetaObject::invokeMethod(this, "sendNextRequest", Qt::QueuedConnection);
+        } else {
+            // The reply finished before it has been sent
+            m_replyQueue.remove(reply);
         }
     });
 
-    m_replyQueue.enqueue(reply);
+    m_replyQueue.enqueue(reply, priority, destination);
 
     QMetaObject::invokeMethod(this, "sendNextRequest", Qt::QueuedConnection);
     return reply;
@@ -578,7 +586,7 @@ void ZigbeeBridgeControllerTi::retrieveHugeMessage(const Zigbee::ApsdeDataIndica
         stream << timestamp;
         stream << i;
         stream << chunkSize;
-        ZigbeeInterfaceTiReply *reply = sendCommand(Ti::SubSystemAF, Ti::AFCommandDataRetrieve, payload);
+        ZigbeeInterfaceTiReply *reply = sendCommand(Ti::SubSystemAF, Ti::AFCommandDataRetrieve, payload, 5000, Zigbee::RequestPriorityInbound);
         // Note, capturing copies of i and chunksize, but a
         connect(reply, &ZigbeeInterfaceTiReply::finished, this, [this, reply, indication, i, maxChunkSize, dataLength](){
             PAYLOAD_STREAM(reply->responsePayload());
@@ -694,37 +702,113 @@ ZigbeeInterfaceTiReply *ZigbeeBridgeControllerTi::requestPermitJoin(quint8 secon
 
 void ZigbeeBridgeControllerTi::waitFor(ZigbeeInterfaceTiReply *reply, Ti::SubSystem subSystem, quint8 command)
 {
-    WaitData waitData;
-    waitData.subSystem = subSystem;
-    waitData.command = command;
+    insertWaitFor(waitKey(subSystem, command), reply);
+}
 
-    m_waitFors.insert(reply, waitData);
-    connect(reply, &ZigbeeInterfaceTiReply::finished, this, [=](){
-        m_waitFors.remove(reply);
-    });
+void ZigbeeBridgeControllerTi::waitFor(ZigbeeInterfaceTiReply *reply, Ti::SubSystem subSystem, quint8 command, quint16 secondaryKey)
+{
+    insertWaitFor(waitKey(subSystem, command, secondaryKey), reply);
+}
+
+quint32 ZigbeeBridgeControllerTi::waitKey(Ti::SubSystem subSystem, quint8 command)
+{
+    return (static_cast<quint32>(subSystem) << 24) | (static_cast<quint32>(command) << 16);
+}
+
+quint32 ZigbeeBridgeControllerTi::waitKey(Ti::SubSystem subSystem, quint8 command, quint16 secondaryKey)
+{
+    // The top bit marks keys with a secondary key, so they never collide with a plain subsystem and command key
+    return 0x80000000 | waitKey(subSystem, command) | secondaryKey;
 }
 
-void ZigbeeBridgeControllerTi::waitFor(ZigbeeInterfaceTiReply *reply, Ti::SubSystem subSystem, quint8 command, const QByteArray &payload)
+bool ZigbeeBridgeControllerTi::secondaryWaitKey(Ti::SubSystem subSystem, quint8 command, const QByteArray &payload, quint16 *secondaryKey)
+{
+    // Address responses: status, IEEE address, NWK address
+    if (subSystem == Ti::SubSystemZDO && payload.length() >= 11 &&
+            (command == static_cast<quint8>(Ti::ZDOCommandNwkAddrRsp) || command == static_cast<quint8>(Ti::ZDOCommandNwkIeeeAddrRsp))) {
+        *secondaryKey = static_cast<quint16>(static_cast<quint8>(payload.at(9)) | (static_cast<quint8>(payload.at(10)) << 8));
+        return true;
+    }
+
+    // All other ZDO responses start with the source address
+    if (subSystem == Ti::SubSystemZDO && payload.length() >= 2 &&
+            command >= static_cast<quint8>(Ti::ZDOCommandNodeDescRsp) && command <= static_cast<quint8>(Ti::ZDOCommandMgmtPermitJoinRsp)) {
+        *secondaryKey = static_cast<quint16>(static_cast<quint8>(payload.at(0)) | (static_cast<quint8>(payload.at(1)) << 8));
+        return true;
+    }
+
+    // AF data confirm: status, endpoint, transaction id
+    if (subSystem == Ti::SubSystemAF && command == static_cast<quint8>(Ti::AFCommandDataConfirm) && payload.length() >= 3) {
+        *secondaryKey = static_cast<quint8>(payload.at(2));
+        return true;
+    }
+
+    return false;
+}
+
+void ZigbeeBridgeControllerTi::insertWaitFor(quint32 key, ZigbeeInterfaceTiReply *reply)
 {
     WaitData waitData;
-    waitData.subSystem = subSystem;
-    waitData.command = command;
-    waitData.payload = payload;
-    waitData.comparePayload = true;
+    waitData.reply = reply;
+    waitData.timestamp = ZigbeeUtils::monotonicMilliseconds();
+    m_waitFors[key].append(waitData);
 
-    m_waitFors.insert(reply, waitData);
-    connect(reply, &ZigbeeInterfaceTiReply::finished, this, [=](){
-        m_waitFors.remove(reply);
+    // Drop the wait if the reply finishes without the awaited event, i.e. on timeout
+    connect(reply, &ZigbeeInterfaceTiReply::finished, this, [this, key, reply](){
+        if (!m_waitFors.contains(key))
+            return;
+
+        QList<WaitData> &waits = m_waitFors[key];
+        for (int i = 0; i < waits.count(); i++) {
+            if (waits.at(i).reply == reply) {
+                if (reply->timendOut())
+                    recordWaitDuration(key, ZigbeeUtils::monotonicMilliseconds() - waits.at(i).timestamp, true);
+
+                waits.removeAt(i);
+                break;
+            }
+        }
+
+        if (waits.isEmpty())
+            m_waitFors.remove(key);
     });
 }
 
+void ZigbeeBridgeControllerTi::finishWaitFors(quint32 key, const QByteArray &payload)
+{
+    // Take the waits out of the table first, since finishing a reply removes it from there
+    QList<WaitData> waits = m_waitFors.take(key);
+    foreach (const WaitData &waitData, waits) {
+        recordWaitDuration(key, ZigbeeUtils::monotonicMilliseconds() - waitData.timestamp, false);
+        waitData.reply->m_responsePayload = payload;
+        waitData.reply->finish();
+    }
+}
+
+void ZigbeeBridgeControllerTi::recordWaitDuration(quint32 key, qint64 duration, bool timedOut)
+{
+    Ti::SubSystem subSystem = static_cast<Ti::SubSystem>((key >> 24) & 0x7f);
+    quint8 command = static_cast<quint8>(key >> 16);
+
+    WaitStatistics &statistics = m_waitStatistics[static_cast<quint16>((key >> 16) & 0x7fff)];
+    statistics.count++;
+    if (timedOut)
+        statistics.timeouts++;
+
+    statistics.totalDuration += duration;
+    statistics.maxDuration = qMax(statistics.maxDuration, duration);
+    qCDebug(dcZigbeeController()) << "Awaited event" << subSystem << ZigbeeUtils::convertByteToHexString(command)
+                                  << (timedOut ? "timed out after" : "received after") << duration << "ms."
+                                  << "Average:" << statistics.totalDuration / statistics.count << "ms, max:" << statistics.maxDuration
+                                  << "ms, timeouts:" << statistics.timeouts << "/" << statistics.count;
+}
+
 void ZigbeeBridgeControllerTi::onInterfaceAvailableChanged(bool available)
 {
     qCDebug(dcZigbeeController()) << "Interface available changed" << available;
     if (!available) {
         // Clean up any pending replies
-        while (!m_replyQueue.isEmpty()) {
-            ZigbeeInterfaceTiReply *reply = m_replyQueue.dequeue();
+        foreach (ZigbeeInterfaceTiReply *reply, m_replyQueue.takeAll()) {
             reply->abort();
         }
     }
@@ -1015,15 +1099,11 @@ void ZigbeeBridgeControllerTi::onInterfacePacketReceived(Ti::SubSystem subSystem
             qCWarning(dcZigbeeController()) << "Unhandled AREQ notification";
         }
 
-        foreach (ZigbeeInterfaceTiReply *reply, m_waitFors.keys()) {
-            WaitData waitData = m_waitFors.value(reply);
-            if (waitData.subSystem == subSystem && waitData.command == command) {
-                if (!waitData.comparePayload || waitData.payload == payload) {
-                    qCDebug(dcZigbeeController()) << "awaited event received.";
-                    reply->m_responsePayload = payload;
-                    reply->finish();
-                }
-            }
+        finishWaitFors(waitKey(subSystem, command), payload);
+
+        quint16 secondaryKey = 0;
+        if (secondaryWaitKey(subSystem, command, payload, &secondaryKey)) {
+            finishWaitFors(waitKey(subSystem, command, secondaryKey), payload);
         }
     }
 
@@ -1034,6 +1114,9 @@ void ZigbeeBridgeControllerTi::onInterfacePacketReceived(Ti::SubSystem subSystem
 
 bool ZigbeeBridgeControllerTi::enable(const QString &serialPort, qint32 baudrate)
 {
+    if (m_ioThreadEnabled)
+        m_interface->startIoThread();
+
     return m_interface->enable(serialPort, baudrate);
 }
 
@@ -38,6 +38,7 @@
 #include "zigbeeaddress.h"
 #include "zigbeenetworkkey.h"
 #include "zigbeenetworkrequest.h"
+#include "zigbeerequestscheduler.h"
 #include "zigbeebridgecontroller.h"
 
 #include "interface/ti.h"
@@ -93,6 +94,8 @@ public:
     // Send APS request data
     ZigbeeInterfaceTiReply *requestSendRequest(const ZigbeeNetworkRequest &request);
 
+    int requestQueueDepth(Zigbee::RequestPriority priority) const override;
+
 public slots:
     bool enable(const QString &serialPort, qint32 baudrate);
     void disable();
@@ -116,21 +119,36 @@ private slots:
     void postStartup();
 
 private:
-    ZigbeeInterfaceTiReply *sendCommand(Ti::SubSystem subSystem, quint8 command, const QByteArray &payload = QByteArray(), int timeout = 5000);
+    ZigbeeInterfaceTiReply *sendCommand(Ti::SubSystem subSystem, quint8 command, const QByteArray &payload = QByteArray(), int timeout = 5000,
+                                        Zigbee::RequestPriority priority = Zigbee::RequestPriorityUser, quint64 destination = 0);
     ZigbeeInterfaceTiReply *readNvItem(Ti::NvItemId itemId, quint16 offset = 0);
     ZigbeeInterfaceTiReply *writeNvItem(Ti::NvItemId itemId, const QByteArray &data, quint16 offset = 0);
     ZigbeeInterfaceTiReply *deleteNvItem(Ti::NvItemId itemId);
     void retrieveHugeMessage(const Zigbee::ApsdeDataIndication &pendingIndication, quint32 timestamp, quint16 dataLength);
 
+    // Replies waiting for an AREQ, indexed by subsystem and command id. The optional secondary key narrows the
+    // match down to the source address of a ZDO response or the transaction id of an AF data confirm.
     void waitFor(ZigbeeInterfaceTiReply *reply, Ti::SubSystem subSystem, quint8 command);
-    void waitFor(ZigbeeInterfaceTiReply *reply, Ti::SubSystem subSystem, quint8 command, const QByteArray &payload);
+    void waitFor(ZigbeeInterfaceTiReply *reply, Ti::SubSystem subSystem, quint8 command, quint16 secondaryKey);
     struct WaitData {
-        Ti::SubSystem subSystem;
-        quint8 command;
-        QByteArray payload;
-        bool comparePayload = false;
+        ZigbeeInterfaceTiReply *reply = nullptr;
+        qint64 timestamp = 0;
+    };
+    struct WaitStatistics {
+        quint32 count = 0;
+        quint32 timeouts = 0;
+        qint64 totalDuration = 0;
+        qint64 maxDuration = 0;
     };
-    QHash<ZigbeeInterfaceTiReply*, WaitData> m_waitFors;
+    QHash<quint32, QList<WaitData>> m_waitFors;
+    QHash<quint16, WaitStatistics> m_waitStatistics;
+
+    static quint32 waitKey(Ti::SubSystem subSystem, quint8 command);
+    static quint32 waitKey(Ti::SubSystem subSystem, quint8 command, quint16 secondaryKey);
+    static bool secondaryWaitKey(Ti::SubSystem subSystem, quint8 command, const QByteArray &payload, quint16 *secondaryKey);
+    void insertWaitFor(quint32 key, ZigbeeInterfaceTiReply *reply);
+    void finishWaitFors(quint32 key, const QByteArray &payload);
+    void recordWaitDuration(quint32 key, qint64 duration, bool timedOut);
 
     ZigbeeInterfaceTi *m_interface = nullptr;
 
@@ -139,7 +157,7 @@ private:
 
     ZigbeeInterfaceTiReply *m_currentReply = nullptr;
 
-    QQueue<ZigbeeInterfaceTiReply *> m_replyQueue;
+    ZigbeeRequestScheduler<ZigbeeInterfaceTiReply *> m_replyQueue;
 
     QTimer m_permitJoinTimer;
 
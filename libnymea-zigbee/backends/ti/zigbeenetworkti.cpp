@@ -64,6 +64,8 @@ Zigbee::ZigbeeBackendType ZigbeeNetworkTi::backendType() const
 ZigbeeNetworkReply *ZigbeeNetworkTi::sendRequest(const ZigbeeNetworkRequest &request)
 {
     ZigbeeNetworkReply *reply = createNetworkReply(request);
+    if (!reserveRequestId(reply))
+        return reply;
 
     // Finish the reply right away if the network is offline
     if (!m_controller->available() || state() == ZigbeeNetwork::StateOffline || state() == ZigbeeNetwork::StateStopping) {
@@ -491,6 +493,7 @@ void ZigbeeNetworkTi::startNetwork()
 {
     loadNetwork();
 
+    m_controller->setIoThreadEnabled(serialIoThreadEnabled());
     if (!m_controller->enable(serialPortName(), serialBaudrate())) {
         setPermitJoiningState(false);
         setState(StateOffline);
@@ -58,6 +58,7 @@ SOURCES += \
     zcl/zigbeeclusterattribute.cpp \
     zcl/zigbeeclusterlibrary.cpp \
     zcl/zigbeeclusterreply.cpp \
+    zcl/zigbeegrouptarget.cpp \
     zcl/general/zigbeeclusterbasic.cpp \
     zdo/zigbeedeviceobject.cpp \
     zdo/zigbeedeviceobjectreply.cpp \
@@ -66,6 +67,7 @@ SOURCES += \
     zigbeebridgecontroller.cpp \
     zigbeechannelmask.cpp \
     zigbeedatatype.cpp \
+    zigbeedatatypereader.cpp \
     zigbeemanufacturer.cpp \
     zigbeenetwork.cpp \
     zigbeenetworkdatabase.cpp \
@@ -78,11 +80,14 @@ SOURCES += \
     zigbeenodeendpoint.cpp \
     zigbeereply.cpp \
     zigbeesecurityconfiguration.cpp \
+    zigbeeslipframer.cpp \
     zigbeeuartadapter.cpp \
     zigbeeuartadaptermonitor.cpp \
     zigbeeutils.cpp \
+    zigbeetimerwheel.cpp \
     zigbeenode.cpp \
-    zigbeeaddress.cpp
+    zigbeeaddress.cpp \
+    zigbeeinterfacethread.cpp
 
 HEADERS += \
     backends/deconz/interface/deconz.h \
@@ -131,6 +136,7 @@ HEADERS += \
     zcl/zigbeeclusterattribute.h \
     zcl/zigbeeclusterlibrary.h \
     zcl/zigbeeclusterreply.h \
+    zcl/zigbeegrouptarget.h \
     zcl/general/zigbeeclusterbasic.h \
     zdo/zigbeedeviceobject.h \
     zdo/zigbeedeviceobjectreply.h \
@@ -139,6 +145,7 @@ HEADERS += \
     zigbeebridgecontroller.h \
     zigbeechannelmask.h \
     zigbeedatatype.h \
+    zigbeedatatypereader.h \
     zigbeemanufacturer.h \
     zigbeenetwork.h \
     zigbeenetworkdatabase.h \
@@ -151,11 +158,16 @@ HEADERS += \
     zigbeenodeendpoint.h \
     zigbeereply.h \
     zigbeesecurityconfiguration.h \
+    zigbeeslipframer.h \
     zigbeeuartadapter.h \
     zigbeeuartadaptermonitor.h \
     zigbeeutils.h \
+    zigbeetimerwheel.h \
     zigbeenode.h \
-    zigbeeaddress.h
+    zigbeeaddress.h \
+    zigbeeinterfacethread.h \
+    zigbeespscqueue.h \
+    zigbeerequestscheduler.h
 
 # install header file with relative subdirectory
 for (header, HEADERS) {
@@ -37,6 +37,42 @@ ZigbeeClusterScenes::ZigbeeClusterScenes(ZigbeeNetwork *network, ZigbeeNode *nod
 
 }
 
+ZigbeeClusterReply *ZigbeeClusterScenes::commandRemoveScene(quint16 groupId, quint8 sceneId)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << groupId << sceneId;
+    return executeClusterCommand(ZigbeeClusterScenes::CommandRemoveScene, payload);
+}
+
+ZigbeeClusterReply *ZigbeeClusterScenes::commandRemoveAllScenes(quint16 groupId)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << groupId;
+    return executeClusterCommand(ZigbeeClusterScenes::CommandRemoveAllScenes, payload);
+}
+
+ZigbeeClusterReply *ZigbeeClusterScenes::commandStoreScene(quint16 groupId, quint8 sceneId)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << groupId << sceneId;
+    return executeClusterCommand(ZigbeeClusterScenes::CommandStoreScene, payload);
+}
+
+ZigbeeClusterReply *ZigbeeClusterScenes::commandRecallScene(quint16 groupId, quint8 sceneId)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << groupId << sceneId;
+    return executeClusterCommand(ZigbeeClusterScenes::CommandRecallScene, payload);
+}
+
 void ZigbeeClusterScenes::processDataIndication(ZigbeeClusterLibrary::Frame frame)
 {
     switch (m_direction) {
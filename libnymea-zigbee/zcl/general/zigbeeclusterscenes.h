@@ -62,6 +62,11 @@ public:
 
     explicit ZigbeeClusterScenes(ZigbeeNetwork *network, ZigbeeNode *node, ZigbeeNodeEndpoint *endpoint, Direction direction, QObject *parent = nullptr);
 
+    ZigbeeClusterReply *commandRemoveScene(quint16 groupId, quint8 sceneId);
+    ZigbeeClusterReply *commandRemoveAllScenes(quint16 groupId);
+    ZigbeeClusterReply *commandStoreScene(quint16 groupId, quint8 sceneId);
+    ZigbeeClusterReply *commandRecallScene(quint16 groupId, quint8 sceneId);
+
 signals:
     void commandSent(ZigbeeClusterScenes::Command command, quint16 groupId, quint8 sceneId, quint8 transactionSequenceNumber);
 
@@ -32,6 +32,7 @@
 #include "zigbeenetworkreply.h"
 #include "zigbeeclusterlibrary.h"
 #include "zigbeenetworkrequest.h"
+#include "zigbeedatatypereader.h"
 
 #include <QDataStream>
 #include <QMetaEnum>
@@ -57,6 +58,16 @@ ZigbeeNodeEndpoint *ZigbeeCluster::endpoint() const
     return m_endpoint;
 }
 
+bool ZigbeeCluster::isGroupBound() const
+{
+    return m_groupBound;
+}
+
+quint16 ZigbeeCluster::groupId() const
+{
+    return m_groupId;
+}
+
 ZigbeeCluster::Direction ZigbeeCluster::direction() const
 {
     return m_direction;
@@ -93,13 +104,90 @@ ZigbeeClusterAttribute ZigbeeCluster::attribute(quint16 attributeId)
 void ZigbeeCluster::setAttribute(const ZigbeeClusterAttribute &attribute)
 {
     qCDebug(dcZigbeeCluster()) << "Update attribute" << m_node << m_endpoint << this << attribute;
-    if (hasAttribute(attribute.id())) {
-        m_attributes[attribute.id()] = attribute;
-        emit attributeChanged(attribute);
-    } else {
-        m_attributes.insert(attribute.id(), attribute);
-        emit attributeChanged(attribute);
+    m_attributes.insert(attribute.id(), attribute);
+    emit attributeChanged(attribute);
+}
+
+bool ZigbeeCluster::updateAttribute(const ZigbeeClusterAttribute &attribute, bool applyDeadband)
+{
+    QHash<quint16, ZigbeeClusterAttribute>::const_iterator it = m_attributes.constFind(attribute.id());
+    if (it == m_attributes.constEnd()) {
+        setAttribute(attribute);
+        emit attributeUpdated(attribute, true);
+        return true;
+    }
+
+    const ZigbeeDataType currentValue = it.value().dataType();
+    const ZigbeeDataType newValue = attribute.dataType();
+    if (currentValue == newValue) {
+        // Repeated reports of the same value can be events (i.e. button presses or alarms), so they are still emitted.
+        // Only the database write is skipped.
+        qCDebug(dcZigbeeCluster()) << "Attribute value did not change" << m_node << m_endpoint << this << attribute;
+        setAttribute(attribute);
+        emit attributeUpdated(attribute, false);
+        return false;
+    }
+
+    if (applyDeadband && m_network && currentValue.dataType() == newValue.dataType() && m_network->hasAttributeDeadband(m_clusterId, attribute.id())) {
+        double current = 0; double value = 0;
+        if (numericValue(currentValue, &current) && numericValue(newValue, &value)) {
+            ZigbeeClusterAttributeDeadband deadband = m_network->attributeDeadband(m_clusterId, attribute.id());
+            double change = qAbs(value - current);
+            bool absoluteExceeded = deadband.absoluteChange > 0 && change >= deadband.absoluteChange;
+            bool relativeExceeded = deadband.relativeChange > 0 && change >= deadband.relativeChange * qAbs(current);
+            if (!absoluteExceeded && !relativeExceeded) {
+                qCDebug(dcZigbeeCluster()) << "Attribute change within deadband" << m_node << m_endpoint << this << attribute << "change:" << change;
+                return false;
+            }
+        }
+    }
+
+    setAttribute(attribute);
+    emit attributeUpdated(attribute, true);
+    return true;
+}
+
+bool ZigbeeCluster::numericValue(const ZigbeeDataType &dataType, double *value)
+{
+    bool valueOk = false;
+    switch (dataType.dataType()) {
+    case Zigbee::Uint8:
+        *value = dataType.toUInt8(&valueOk);
+        break;
+    case Zigbee::Uint16:
+        *value = dataType.toUInt16(&valueOk);
+        break;
+    case Zigbee::Uint24:
+    case Zigbee::Uint32:
+        *value = dataType.toUInt32(&valueOk);
+        break;
+    case Zigbee::Uint40:
+    case Zigbee::Uint48:
+    case Zigbee::Uint56:
+    case Zigbee::Uint64:
+        *value = dataType.toUInt64(&valueOk);
+        break;
+    case Zigbee::Int8:
+        *value = dataType.toInt8(&valueOk);
+        break;
+    case Zigbee::Int16:
+        *value = dataType.toInt16(&valueOk);
+        break;
+    case Zigbee::Int24:
+    case Zigbee::Int32:
+        *value = dataType.toInt32(&valueOk);
+        break;
+    case Zigbee::Int40:
+    case Zigbee::Int48:
+    case Zigbee::Int56:
+    case Zigbee::Int64:
+        *value = dataType.toInt64(&valueOk);
+        break;
+    default:
+        break;
     }
+
+    return valueOk;
 }
 
 ZigbeeClusterReply *ZigbeeCluster::readAttributes(QList<quint16> attributes, quint16 manufacturerCode)
@@ -141,11 +229,15 @@ ZigbeeClusterReply *ZigbeeCluster::configureReporting(QList<ZigbeeClusterLibrary
 }
 
 
-ZigbeeClusterReply *ZigbeeCluster::executeGlobalCommand(quint8 command, const QByteArray &payload, quint16 manufacturerCode, quint8 transactionSequenceNumber)
+ZigbeeClusterReply *ZigbeeCluster::executeGlobalCommand(quint8 command, const QByteArray &payload, quint16 manufacturerCode)
 {
     // Build the request
     ZigbeeNetworkRequest request = createGeneralRequest();
 
+    quint8 transactionSequenceNumber = 0;
+    if (!newTransactionSequenceNumber(&transactionSequenceNumber))
+        return createFailedClusterReply(request, ZigbeeClusterReply::ErrorTransactionSequenceNumberUnavailable);
+
     // Build ZCL frame
 
     // Note: for basic commands the frame control files has to be zero accoring to spec ZCL 2.4.1.1
@@ -178,11 +270,11 @@ ZigbeeClusterReply *ZigbeeCluster::executeGlobalCommand(quint8 command, const QB
     frame.header = header;
     frame.payload = payload;
 
-    request.setTxOptions(Zigbee::ZigbeeTxOptions(Zigbee::ZigbeeTxOptionAckTransmission));
     request.setAsdu(ZigbeeClusterLibrary::buildFrame(frame));
 
     ZigbeeClusterReply *zclReply = createClusterReply(request, frame);
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    holdTransactionSequenceNumber(zclReply);
+    ZigbeeNetworkReply *networkReply = m_network->sendRateLimitedRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, this, [this, networkReply, zclReply](){
         if (!verifyNetworkError(zclReply, networkReply)) {
             finishZclReply(zclReply);
@@ -190,11 +282,13 @@ ZigbeeClusterReply *ZigbeeCluster::executeGlobalCommand(quint8 command, const QB
         }
 
         // The request was successfully sent to the device
-        // Now check if the expected indication response received already
-        if (zclReply->isComplete()) {
+        // Now check if the expected indication response received already. Groupcasts have no response.
+        if (zclReply->isComplete() || m_groupBound) {
             finishZclReply(zclReply);
             return;
         }
+
+        zclReply->m_timeoutTimer.start();
     });
 
     return zclReply;
@@ -205,7 +299,25 @@ ZigbeeClusterReply *ZigbeeCluster::createClusterReply(const ZigbeeNetworkRequest
     ZigbeeClusterReply *zclReply = new ZigbeeClusterReply(request, frame, this);
     connect(zclReply, &ZigbeeClusterReply::finished, zclReply, &ZigbeeClusterReply::deleteLater, Qt::QueuedConnection);
     zclReply->m_transactionSequenceNumber = frame.header.transactionSequenceNumber;
-    m_pendingReplies.insert(zclReply->transactionSequenceNumber(), zclReply);
+    zclReply->m_timeoutTimer.setCallback([this, zclReply](){
+        qCWarning(dcZigbeeCluster()) << "No response received for" << zclReply->request() << m_node << this;
+        zclReply->m_error = ZigbeeClusterReply::ErrorTimeout;
+        finishZclReply(zclReply);
+    });
+    return zclReply;
+}
+
+ZigbeeClusterReply *ZigbeeCluster::createFailedClusterReply(const ZigbeeNetworkRequest &request, ZigbeeClusterReply::Error error)
+{
+    qCWarning(dcZigbeeCluster()) << "Cannot send" << request << "to" << m_node << this << error;
+    ZigbeeClusterReply *zclReply = new ZigbeeClusterReply(request, ZigbeeClusterLibrary::Frame(), this);
+    connect(zclReply, &ZigbeeClusterReply::finished, zclReply, &ZigbeeClusterReply::deleteLater, Qt::QueuedConnection);
+    zclReply->m_error = error;
+
+    // Finish from the event loop, the caller did not connect to the reply yet
+    QTimer::singleShot(0, zclReply, [zclReply](){
+        emit zclReply->finished();
+    });
     return zclReply;
 }
 
@@ -213,30 +325,35 @@ ZigbeeClusterReply *ZigbeeCluster::executeClusterCommand(quint8 command, const Q
 {
     ZigbeeNetworkRequest request = createGeneralRequest();
 
+    quint8 transactionSequenceNumber = 0;
+    if (!newTransactionSequenceNumber(&transactionSequenceNumber))
+        return createFailedClusterReply(request, ZigbeeClusterReply::ErrorTransactionSequenceNumberUnavailable);
+
     // Build ZCL frame control
     ZigbeeClusterLibrary::FrameControl frameControl;
     frameControl.frameType = ZigbeeClusterLibrary::FrameTypeClusterSpecific;
     frameControl.manufacturerSpecific = false;
     frameControl.direction = ZigbeeClusterLibrary::DirectionClientToServer;
-    frameControl.disableDefaultResponse = false;
+    // Default responses of all group members would flood the network
+    frameControl.disableDefaultResponse = m_groupBound;
 
     // Build ZCL header
     ZigbeeClusterLibrary::Header header;
     header.frameControl = frameControl;
     header.command = command;
-    header.transactionSequenceNumber = newTransactionSequenceNumber();
+    header.transactionSequenceNumber = transactionSequenceNumber;
 
     // Build ZCL frame
     ZigbeeClusterLibrary::Frame frame;
     frame.header = header;
     frame.payload = payload;
 
-    request.setTxOptions(Zigbee::ZigbeeTxOptions(Zigbee::ZigbeeTxOptionAckTransmission));
     request.setAsdu(ZigbeeClusterLibrary::buildFrame(frame));
 
     ZigbeeClusterReply *zclReply = createClusterReply(request, frame);
+    holdTransactionSequenceNumber(zclReply);
     qCDebug(dcZigbeeCluster()) << "Executing command" << ZigbeeUtils::convertByteToHexString(command) << ZigbeeUtils::convertByteArrayToHexString(payload);
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = m_network->sendRateLimitedRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, this, [this, networkReply, zclReply](){
         if (!verifyNetworkError(zclReply, networkReply)) {
             finishZclReply(zclReply);
@@ -244,11 +361,13 @@ ZigbeeClusterReply *ZigbeeCluster::executeClusterCommand(quint8 command, const Q
         }
 
         // The request was successfully sent to the device
-        // Now check if the expected indication response received already
-        if (zclReply->isComplete()) {
+        // Now check if the expected indication response received already. Groupcasts have no response.
+        if (zclReply->isComplete() || m_groupBound) {
             finishZclReply(zclReply);
             return;
         }
+
+        zclReply->m_timeoutTimer.start();
     });
 
     return zclReply;
@@ -346,6 +465,19 @@ ZigbeeNetworkRequest ZigbeeCluster::createGeneralRequest()
     // Build the request
     ZigbeeNetworkRequest request;
     request.setRequestId(m_network->generateSequenceNumber());
+
+    if (m_groupBound) {
+        // Groupcasts are not acknowledged on APS level by the group members
+        request.setDestinationAddressMode(Zigbee::DestinationAddressModeGroup);
+        request.setDestinationShortAddress(m_groupId);
+        request.setProfileId(m_groupProfile);
+        request.setClusterId(m_clusterId);
+        request.setSourceEndpoint(0x01);
+        request.setRadius(0);
+        request.setTxOptions(Zigbee::ZigbeeTxOptions());
+        return request;
+    }
+
     request.setDestinationAddressMode(Zigbee::DestinationAddressModeShortAddress);
     request.setDestinationShortAddress(m_node->shortAddress());
     request.setProfileId(Zigbee::ZigbeeProfileHomeAutomation); // Note: in Zigbee 3.0 this is the Application Profile (0x0104)
@@ -354,6 +486,11 @@ ZigbeeNetworkRequest ZigbeeCluster::createGeneralRequest()
     request.setDestinationEndpoint(m_endpoint->endpointId());
     request.setRadius(0);
     request.setTxOptions(Zigbee::ZigbeeTxOptions(Zigbee::ZigbeeTxOptionAckTransmission));
+
+    // Requests to a node which is not initialized yet belong to the interview
+    if (m_node->state() != ZigbeeNode::StateInitialized)
+        request.setPriority(Zigbee::RequestPriorityInterview);
+
     return request;
 }
 
@@ -379,6 +516,10 @@ bool ZigbeeCluster::verifyNetworkError(ZigbeeClusterReply *zclReply, ZigbeeNetwo
         zclReply->m_error = ZigbeeClusterReply::ErrorNetworkOffline;
         qCWarning(dcZigbeeClusterLibrary()) << "Failed to send request to" << m_node << zclReply->error();
         break;
+    case ZigbeeNetworkReply::ErrorRequestIdUnavailable:
+        zclReply->m_error = ZigbeeClusterReply::ErrorInterfaceError;
+        qCWarning(dcZigbeeClusterLibrary()) << "Failed to send request to" << m_node << networkReply->error();
+        break;
     case ZigbeeNetworkReply::ErrorZigbeeApsStatusError:
         zclReply->m_apsConfirmReceived = true;
         zclReply->m_error = ZigbeeClusterReply::ErrorZigbeeApsStatusError;
@@ -404,7 +545,10 @@ bool ZigbeeCluster::verifyNetworkError(ZigbeeClusterReply *zclReply, ZigbeeNetwo
 
 void ZigbeeCluster::finishZclReply(ZigbeeClusterReply *zclReply)
 {
-    m_pendingReplies.remove(zclReply->transactionSequenceNumber());
+    zclReply->m_timeoutTimer.stop();
+    if (m_pendingReplies.value(zclReply->transactionSequenceNumber()) == zclReply)
+        m_pendingReplies.remove(zclReply->transactionSequenceNumber());
+
     qCDebug(dcZigbeeCluster()) << "ZigbeeClusterReply finished" << zclReply->request() << zclReply->requestFrame() << zclReply->responseFrame();
     // FIXME: Set the status
     emit zclReply->finished();
@@ -416,19 +560,48 @@ void ZigbeeCluster::processDataIndication(ZigbeeClusterLibrary::Frame frame)
     qCWarning(dcZigbeeCluster()) << "Unhandled ZCL indication in" << m_node << m_endpoint << this << frame;
 }
 
-quint8 ZigbeeCluster::newTransactionSequenceNumber()
+void ZigbeeCluster::bindToGroup(quint16 groupId, Zigbee::ZigbeeProfile profile)
+{
+    m_groupBound = true;
+    m_groupId = groupId;
+    m_groupProfile = profile;
+}
+
+quint64 ZigbeeCluster::transactionDestination() const
+{
+    if (m_groupBound)
+        return (static_cast<quint64>(Zigbee::DestinationAddressModeGroup) << 16) | m_groupId;
+
+    return m_node->extendedAddress().toUInt64();
+}
+
+bool ZigbeeCluster::newTransactionSequenceNumber(quint8 *transactionSequenceNumber)
 {
-    static quint8 tsn = 1;
-    return tsn++;
+    return m_network->acquireTransactionSequenceNumber(transactionDestination(), transactionSequenceNumber);
 }
 
-void ZigbeeCluster::processApsDataIndication(const QByteArray &asdu, const ZigbeeClusterLibrary::Frame &frame)
+void ZigbeeCluster::holdTransactionSequenceNumber(ZigbeeClusterReply *zclReply)
+{
+    // Only transactions started here are matched with incoming frames. Responses to the peer carry
+    // the peer's number, which has not been reserved and would shadow our own transactions.
+    m_pendingReplies.insert(zclReply->transactionSequenceNumber(), zclReply);
+
+    // Keep the number reserved until the transaction finished, successful, failed or timed out
+    ZigbeeNetwork *network = m_network;
+    quint64 destination = transactionDestination();
+    quint8 transactionSequenceNumber = zclReply->transactionSequenceNumber();
+    connect(zclReply, &ZigbeeClusterReply::finished, network, [network, destination, transactionSequenceNumber](){
+        network->releaseTransactionSequenceNumber(destination, transactionSequenceNumber);
+    });
+}
+
+void ZigbeeCluster::processApsDataIndication(const ZigbeeClusterLibrary::FrameView &frame)
 {
     // Check if this indication is for a pending reply
     if (m_pendingReplies.contains(frame.header.transactionSequenceNumber)) {
         ZigbeeClusterReply *reply = m_pendingReplies.value(frame.header.transactionSequenceNumber);
-        reply->m_responseData = asdu;
-        reply->m_responseFrame = frame;
+        reply->m_responseData = frame.frameData;
+        reply->m_responseFrame = frame.toFrame();
         reply->m_zclIndicationReceived = true;
         if (reply->isComplete())
             finishZclReply(reply);
@@ -438,11 +611,11 @@ void ZigbeeCluster::processApsDataIndication(const QByteArray &asdu, const Zigbe
             ZigbeeClusterLibrary::Command globalCommand = static_cast<ZigbeeClusterLibrary::Command>(frame.header.command);
             if (globalCommand == ZigbeeClusterLibrary::CommandReadAttributesResponse) {
                 // Update the attributes from the attribut status reports internally
-                QList<ZigbeeClusterLibrary::ReadAttributeStatusRecord> attributeStatusRecords = ZigbeeClusterLibrary::parseAttributeStatusRecords(frame.payload);
+                QList<ZigbeeClusterLibrary::ReadAttributeStatusRecord> attributeStatusRecords = ZigbeeClusterLibrary::parseAttributeStatusRecords(frame.payload());
                 foreach (const ZigbeeClusterLibrary::ReadAttributeStatusRecord &attributeStatusRecord, attributeStatusRecords) {
                     qCDebug(dcZigbeeCluster()) << "Received read attribute status record" << this << attributeStatusRecord;
                     if (attributeStatusRecord.attributeStatus == ZigbeeClusterLibrary::StatusSuccess) {
-                        setAttribute(ZigbeeClusterAttribute(attributeStatusRecord.attributeId, attributeStatusRecord.dataType));
+                        updateAttribute(ZigbeeClusterAttribute(attributeStatusRecord.attributeId, attributeStatusRecord.dataType), false);
                     } else {
                         qCWarning(dcZigbeeCluster()) << "Reading attribute status record returned an error" << attributeStatusRecord;
                     }
@@ -458,14 +631,17 @@ void ZigbeeCluster::processApsDataIndication(const QByteArray &asdu, const Zigbe
         ZigbeeClusterLibrary::Command globalCommand = static_cast<ZigbeeClusterLibrary::Command>(frame.header.command);
         if (globalCommand == ZigbeeClusterLibrary::CommandReportAttributes) {
             // Read the attribute reports and update/set the attributes
-            QDataStream stream(frame.payload);
-            stream.setByteOrder(QDataStream::LittleEndian);
-            while (!stream.atEnd()) {
+            ZigbeeDataTypeReader reader(frame.payload());
+            while (!reader.atEnd()) {
                 quint16 attributeId = 0; quint8 type = 0;
-                stream >> attributeId >> type;
-                ZigbeeDataType dataType = ZigbeeClusterLibrary::readDataType(&stream, static_cast<Zigbee::DataType>(type));
+                ZigbeeDataType dataType;
+                if (!reader.readUInt16(&attributeId) || !reader.readUInt8(&type) || !reader.readDataType(static_cast<Zigbee::DataType>(type), &dataType)) {
+                    qCWarning(dcZigbeeCluster()) << "Could not read attribute report" << (reader.truncated() ? "(truncated)" : "(unknown data type)") << this << frame;
+                    break;
+                }
+
                 qCDebug(dcZigbeeCluster()) << "Received attributes report" << this << frame;
-                setAttribute(ZigbeeClusterAttribute(attributeId, dataType));
+                updateAttribute(ZigbeeClusterAttribute(attributeId, dataType));
             }
 
             return;
@@ -473,7 +649,7 @@ void ZigbeeCluster::processApsDataIndication(const QByteArray &asdu, const Zigbe
     }
 
     // Not for a reply or not an attribute report, let the cluster process this message internally
-    processDataIndication(frame);
+    processDataIndication(frame.toFrame());
 }
 
 QDebug operator<<(QDebug debug, ZigbeeCluster *cluster)
@@ -481,6 +657,9 @@ QDebug operator<<(QDebug debug, ZigbeeCluster *cluster)
     debug.nospace().noquote() << "ZigbeeCluster("
                               << ZigbeeUtils::convertUint16ToHexString(static_cast<quint16>(cluster->clusterId())) << ", "
                               << cluster->clusterName() << ", ";
+    if (cluster->isGroupBound())
+        debug.nospace().noquote() << "Group " << ZigbeeUtils::convertUint16ToHexString(cluster->groupId()) << ", ";
+
     switch (cluster->direction()) {
     case ZigbeeCluster::Server:
         debug.nospace().noquote() << "Server)";
@@ -45,6 +45,13 @@ struct ZigbeeClusterReportConfigurationRecord {
     quint8 change;
 };
 
+// Minimum change of a numeric attribute value before a report counts as attribute change.
+// A value of 0 disables the respective threshold, the relative change is a fraction of the current value.
+typedef struct ZigbeeClusterAttributeDeadband {
+    double absoluteChange = 0;
+    double relativeChange = 0;
+} ZigbeeClusterAttributeDeadband;
+
 typedef struct ZigbeeClusterAttributeReport {
     quint16 sourceAddress;
     quint8 endpointId;
@@ -67,6 +74,7 @@ class ZigbeeCluster : public QObject
     friend class ZigbeeNode;
     friend class ZigbeeNetwork;
     friend class ZigbeeNetworkDatabase;
+    friend class ZigbeeGroupTarget;
 
 public:
     enum Direction {
@@ -80,6 +88,10 @@ public:
     ZigbeeNode *node() const;
     ZigbeeNodeEndpoint *endpoint() const;
 
+    // Group bound clusters address all members of the group with one groupcast and have no node or endpoint
+    bool isGroupBound() const;
+    quint16 groupId() const;
+
     Direction direction() const;
 
     ZigbeeClusterLibrary::ClusterId clusterId() const;
@@ -103,15 +115,20 @@ protected:
     Direction m_direction = Server;
     QHash<quint16, ZigbeeClusterAttribute> m_attributes;
 
+    bool m_groupBound = false;
+    quint16 m_groupId = 0;
+    Zigbee::ZigbeeProfile m_groupProfile = Zigbee::ZigbeeProfileHomeAutomation;
+
     // Helper methods for sending cluster specific commands
     ZigbeeNetworkRequest createGeneralRequest();
     QHash<quint8, ZigbeeClusterReply *> m_pendingReplies;
 
     // Global commands
-    ZigbeeClusterReply *executeGlobalCommand(quint8 command, const QByteArray &payload = QByteArray(), quint16 manufacturerCode = 0x0000, quint8 transactionSequenceNumber = newTransactionSequenceNumber());
+    ZigbeeClusterReply *executeGlobalCommand(quint8 command, const QByteArray &payload = QByteArray(), quint16 manufacturerCode = 0x0000);
 
     // Cluster specific
     ZigbeeClusterReply *createClusterReply(const ZigbeeNetworkRequest &request, ZigbeeClusterLibrary::Frame frame);
+    ZigbeeClusterReply *createFailedClusterReply(const ZigbeeNetworkRequest &request, ZigbeeClusterReply::Error error);
     ZigbeeClusterReply *executeClusterCommand(quint8 command, const QByteArray &payload = QByteArray());
 
     ZigbeeClusterReply *sendClusterServerResponse(quint8 command, quint8 transactionSequenceNumber, const QByteArray &payload = QByteArray());
@@ -124,13 +141,28 @@ protected:
 
     virtual void setAttribute(const ZigbeeClusterAttribute &attribute);
 
-    static quint8 newTransactionSequenceNumber();
+    // Returns false if the value did not change or the update has been suppressed by the deadband.
+    // Unchanged values are still emitted, attributeUpdated tells whether the value changed.
+    bool updateAttribute(const ZigbeeClusterAttribute &attribute, bool applyDeadband = true);
+
+    // Transaction sequence numbers are unique among the transactions in flight to the same destination
+    quint64 transactionDestination() const;
+    bool newTransactionSequenceNumber(quint8 *transactionSequenceNumber);
+    // Registers the reply for the incoming response and keeps its number reserved until it finished
+    void holdTransactionSequenceNumber(ZigbeeClusterReply *zclReply);
+
+private:
+    void bindToGroup(quint16 groupId, Zigbee::ZigbeeProfile profile);
+
+    static bool numericValue(const ZigbeeDataType &dataType, double *value);
 
 signals:
     void attributeChanged(const ZigbeeClusterAttribute &attribute);
+    // Emitted for attribute values received from the node, valueChanged is false for repeated values
+    void attributeUpdated(const ZigbeeClusterAttribute &attribute, bool valueChanged);
 
 public slots:
-    void processApsDataIndication(const QByteArray &asdu, const ZigbeeClusterLibrary::Frame &frame);
+    void processApsDataIndication(const ZigbeeClusterLibrary::FrameView &frame);
 
 };
 
@@ -28,6 +28,7 @@
 #include "zigbeeclusterlibrary.h"
 #include "loggingcategory.h"
 #include "zigbeedatatype.h"
+#include "zigbeedatatypereader.h"
 #include "zigbeeutils.h"
 
 #include <QDataStream>
@@ -95,47 +96,58 @@ QByteArray ZigbeeClusterLibrary::buildHeader(const ZigbeeClusterLibrary::Header
     return headerData;
 }
 
-QList<ZigbeeClusterLibrary::ReadAttributeStatusRecord> ZigbeeClusterLibrary::parseAttributeStatusRecords(const QByteArray &payload)
+QList<ZigbeeClusterLibrary::ReadAttributeStatusRecord> ZigbeeClusterLibrary::parseAttributeStatusRecords(const QByteArray &payload, bool includeFailedRecords)
 {
     // Read attribute status records
     QList<ReadAttributeStatusRecord> attributeStatusRecords;
 
     qCDebug(dcZigbeeClusterLibrary()) << "Parse attribute status records from" << ZigbeeUtils::convertByteArrayToHexString(payload);
 
-    QDataStream stream(payload);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    quint16 attributeId; quint8 statusInt; quint8 dataTypeInt;
-
-    while (!stream.atEnd()) {
-        // Reset variables
-        attributeId = 0; statusInt = 0; dataTypeInt = 0;
-
+    ZigbeeDataTypeReader reader(payload);
+    while (!reader.atEnd()) {
         // Read attribute id and status
-        stream >> attributeId >> statusInt;
-        ZigbeeClusterLibrary::Status status = static_cast<ZigbeeClusterLibrary::Status>(statusInt);
+        quint16 attributeId = 0; quint8 statusInt = 0;
+        if (!reader.readUInt16(&attributeId) || !reader.readUInt8(&statusInt)) {
+            qCWarning(dcZigbeeClusterLibrary()) << "Attribute status record truncated" << ZigbeeUtils::convertByteArrayToHexString(payload);
+            break;
+        }
 
+        ZigbeeClusterLibrary::Status status = static_cast<ZigbeeClusterLibrary::Status>(statusInt);
         qCDebug(dcZigbeeClusterLibrary()) << "Parse:" << ZigbeeUtils::convertUint16ToHexString(attributeId) << status;
 
         if (status != ZigbeeClusterLibrary::StatusSuccess) {
             qCWarning(dcZigbeeCluster()) << "Attribute status record" << ZigbeeUtils::convertUint16ToHexString(attributeId) << "finished with error" << status;
+            if (includeFailedRecords) {
+                ReadAttributeStatusRecord attributeRecord;
+                attributeRecord.attributeId = attributeId;
+                attributeRecord.attributeStatus = status;
+                attributeStatusRecords.append(attributeRecord);
+            }
             // If not success, we are done and can continue with the next status record
             continue;
-        } else {
-            stream >> dataTypeInt;
-            Zigbee::DataType dataType = static_cast<Zigbee::DataType>(dataTypeInt);
-
-            qCDebug(dcZigbeeClusterLibrary()) << "Parse data type:" << dataType;
-            ZigbeeDataType type = readDataType(&stream, dataType);
-            if (!type.isValid())
-                continue;
-
-            ReadAttributeStatusRecord attributeRecord;
-            attributeRecord.attributeId = attributeId;
-            attributeRecord.attributeStatus = status;
-            attributeRecord.dataType = type;
-            qCDebug(dcZigbeeClusterLibrary()) << attributeRecord;
-            attributeStatusRecords.append(attributeRecord);
         }
+
+        quint8 dataTypeInt = 0;
+        ZigbeeDataType type;
+        if (!reader.readUInt8(&dataTypeInt) || !reader.readDataType(static_cast<Zigbee::DataType>(dataTypeInt), &type)) {
+            if (reader.truncated()) {
+                qCWarning(dcZigbeeClusterLibrary()) << "Attribute status record" << ZigbeeUtils::convertUint16ToHexString(attributeId) << "truncated" << ZigbeeUtils::convertByteArrayToHexString(payload);
+            } else {
+                qCWarning(dcZigbeeClusterLibrary()) << "Attribute status record" << ZigbeeUtils::convertUint16ToHexString(attributeId) << "has unknown data type" << ZigbeeUtils::convertByteToHexString(dataTypeInt);
+            }
+            break;
+        }
+
+        qCDebug(dcZigbeeClusterLibrary()) << "Parsed data type:" << type;
+        if (!type.isValid())
+            continue;
+
+        ReadAttributeStatusRecord attributeRecord;
+        attributeRecord.attributeId = attributeId;
+        attributeRecord.attributeStatus = status;
+        attributeRecord.dataType = type;
+        qCDebug(dcZigbeeClusterLibrary()) << attributeRecord;
+        attributeStatusRecords.append(attributeRecord);
     }
 
     return attributeStatusRecords;
@@ -198,7 +210,6 @@ ZigbeeDataType ZigbeeClusterLibrary::readDataType(QDataStream *stream, Zigbee::D
         for (int i = 0; i < length; i++) {
             quint8 element = 0;
             *stream >> element;
-            data.append(element);
             dataStream << element;
         }
     } else {
@@ -218,34 +229,59 @@ ZigbeeDataType ZigbeeClusterLibrary::readDataType(QDataStream *stream, Zigbee::D
 
 ZigbeeClusterLibrary::Frame ZigbeeClusterLibrary::parseFrameData(const QByteArray &frameData)
 {
-    QDataStream stream(frameData);
-    stream.setByteOrder(QDataStream::LittleEndian);
-
-    // Read the header and then the payload
-    quint8 offset = 0;
-    quint8 frameControlByte = 0;
-    quint8 commandByte = 0;
+    return parseFrameView(frameData).toFrame();
+}
 
-    Header header;
-    stream >> frameControlByte;
+ZigbeeClusterLibrary::FrameView ZigbeeClusterLibrary::parseFrameView(const QByteArray &frameData)
+{
+    FrameView frameView;
+    frameView.frameData = frameData;
+    if (frameData.isEmpty())
+        return frameView;
+
+    // Read the header, the payload starts right after it
+    const quint8 *data = reinterpret_cast<const quint8 *>(frameData.constData());
+    int offset = 0;
+    frameView.header.frameControl = parseFrameControlByte(data[offset]);
     offset += 1;
 
-    header.frameControl = parseFrameControlByte(frameControlByte);
-    if (header.frameControl.manufacturerSpecific) {
-        stream >> header.manufacturerCode;
+    int headerLength = frameView.header.frameControl.manufacturerSpecific ? 5 : 3;
+    if (frameData.length() < headerLength) {
+        qCWarning(dcZigbeeClusterLibrary()) << "Frame too short for the ZCL header" << ZigbeeUtils::convertByteArrayToHexString(frameData);
+        return frameView;
+    }
+
+    if (frameView.header.frameControl.manufacturerSpecific) {
+        frameView.header.manufacturerCode = static_cast<quint16>(data[offset] | (data[offset + 1] << 8));
         offset += 2;
     }
 
-    stream >> header.transactionSequenceNumber;
+    frameView.header.transactionSequenceNumber = data[offset];
     offset += 1;
 
-    stream >> commandByte;
-    header.command = static_cast<Command>(commandByte);
+    frameView.header.command = data[offset];
     offset += 1;
 
+    frameView.payloadOffset = offset;
+    frameView.valid = true;
+    return frameView;
+}
+
+QByteArray ZigbeeClusterLibrary::FrameView::payload() const
+{
+    if (!valid)
+        return QByteArray();
+
+    return QByteArray::fromRawData(frameData.constData() + payloadOffset, frameData.length() - payloadOffset);
+}
+
+ZigbeeClusterLibrary::Frame ZigbeeClusterLibrary::FrameView::toFrame() const
+{
     Frame frame;
     frame.header = header;
-    frame.payload = frameData.right(frameData.length() - offset);
+    if (valid)
+        frame.payload = frameData.mid(payloadOffset);
+
     return frame;
 }
 
@@ -348,6 +384,14 @@ QDebug operator<<(QDebug debug, const ZigbeeClusterLibrary::Frame &frame)
     return debug.space();
 }
 
+QDebug operator<<(QDebug debug, const ZigbeeClusterLibrary::FrameView &frameView)
+{
+    debug.nospace() << "Frame(";
+    debug.nospace() << frameView.header;
+    debug.nospace() << ZigbeeUtils::convertByteArrayToHexString(frameView.payload()) << ")";
+    return debug.space();
+}
+
 QDebug operator<<(QDebug debug, const ZigbeeClusterLibrary::ReadAttributeStatusRecord &attributeStatusRecord)
 {
     debug.nospace() << "ReadAttributeStatusRecord("
@@ -246,6 +246,19 @@ public:
         QByteArray payload;
     } Frame;
 
+    // Parsed header of a received frame. The payload gets not copied, it gets referenced
+    // within the implicitly shared frame data.
+    typedef struct FrameView {
+        Header header;
+        QByteArray frameData;
+        int payloadOffset = 0;
+        bool valid = false;
+
+        // Note: the returned payload references the frame data and must not outlive this view
+        QByteArray payload() const;
+        Frame toFrame() const;
+    } FrameView;
+
 
     // Read attribute
     typedef struct ReadAttributeStatusRecord {
@@ -286,12 +299,14 @@ public:
 
     static QByteArray buildHeader(const Header &header);
 
-    static QList<ReadAttributeStatusRecord> parseAttributeStatusRecords(const QByteArray &payload);
+    // Records with a failure status have no data type and are only returned if requested
+    static QList<ReadAttributeStatusRecord> parseAttributeStatusRecords(const QByteArray &payload, bool includeFailedRecords = false);
 
     //static QByteArray readAttributeData(const QDataStream &stream, Zigbee::DataType dataType);
     static ZigbeeDataType readDataType(QDataStream *stream, Zigbee::DataType dataType);
 
     static Frame parseFrameData(const QByteArray &frameData);
+    static FrameView parseFrameView(const QByteArray &frameData);
     static QByteArray buildFrame(const Frame &frame);
 
     // AttributeReportingConfiguration
@@ -306,6 +321,7 @@ public:
 QDebug operator<<(QDebug debug, const ZigbeeClusterLibrary::FrameControl &frameControl);
 QDebug operator<<(QDebug debug, const ZigbeeClusterLibrary::Header &header);
 QDebug operator<<(QDebug debug, const ZigbeeClusterLibrary::Frame &frame);
+QDebug operator<<(QDebug debug, const ZigbeeClusterLibrary::FrameView &frameView);
 QDebug operator<<(QDebug debug, const ZigbeeClusterLibrary::ReadAttributeStatusRecord &attributeStatusRecord);
 QDebug operator<<(QDebug debug, const ZigbeeClusterLibrary::AttributeReportingConfiguration &attributeReportingConfiguration);
 QDebug operator<<(QDebug debug, const ZigbeeClusterLibrary::AttributeReportingStatusRecord &attributeReportingStatusRecord);
@@ -82,5 +82,5 @@ ZigbeeClusterReply::ZigbeeClusterReply(const ZigbeeNetworkRequest &request, Zigb
     m_request(request),
     m_requestFrame(requestFrame)
 {
-
+    m_timeoutTimer.setInterval(10000);
 }
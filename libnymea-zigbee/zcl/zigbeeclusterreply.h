@@ -30,6 +30,7 @@
 
 #include <QObject>
 
+#include "zigbeetimerwheel.h"
 #include "zigbeenetworkrequest.h"
 #include "zigbeeclusterlibrary.h"
 
@@ -48,7 +49,8 @@ public:
         ErrorZigbeeMacStatusError, // A MAC layer error occured. See zigbeeNwkStatus()
         ErrorZigbeeClusterLibraryError, // A ZCL error occured. See zigbeeClusterLibraryStatus()
         ErrorInterfaceError, // A transport interface error occured. Could not communicate with the hardware.
-        ErrorNetworkOffline // The network is offline. Cannot send any requests
+        ErrorNetworkOffline, // The network is offline. Cannot send any requests
+        ErrorTransactionSequenceNumberUnavailable // All transaction sequence numbers of the destination are in flight
     };
     Q_ENUM(Error)
 
@@ -73,6 +75,9 @@ private:
 
     Error m_error = ErrorNoError;
 
+    // Time to wait for the response once the request has been sent
+    ZigbeeTimeout m_timeoutTimer;
+
     // Request
     quint8 m_transactionSequenceNumber = 0;
     ZigbeeNetworkRequest m_request;
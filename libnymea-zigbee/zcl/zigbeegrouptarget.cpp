@@ -0,0 +1,97 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright 2013 - 2020, nymea GmbH
+* Contact: contact@nymea.io
+*
+* This file is part of nymea-zigbee.
+* This project including source code and documentation is protected by copyright law, and
+* remains the property of nymea GmbH. All rights, including reproduction, publication,
+* editing and translation, are reserved. The use of this project is subject to the terms of a
+* license agreement to be concluded with nymea GmbH in accordance with the terms
+* of use of nymea GmbH, available under https://nymea.io/license
+*
+* GNU Lesser General Public License Usage
+* Alternatively, this project may be redistributed and/or modified under the terms of the GNU
+* Lesser General Public License as published by the Free Software Foundation; version 3.
+* this project is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License along with this project.
+* If not, see <https://www.gnu.org/licenses/>.
+*
+* For any further details and any questions please contact us under contact@nymea.io
+* or see our FAQ/Licensing Information on https://nymea.io/license/faq
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "zigbeegrouptarget.h"
+#include "zigbeeutils.h"
+
+#include <QDebug>
+
+ZigbeeGroupTarget::ZigbeeGroupTarget(ZigbeeNetwork *network, quint16 groupId, Zigbee::ZigbeeProfile profile, QObject *parent) :
+    QObject(parent),
+    m_network(network),
+    m_groupId(groupId),
+    m_profile(profile)
+{
+    m_onOffCluster = new ZigbeeClusterOnOff(m_network, nullptr, nullptr, ZigbeeCluster::Server, this);
+    bindCluster(m_onOffCluster);
+
+    m_levelControlCluster = new ZigbeeClusterLevelControl(m_network, nullptr, nullptr, ZigbeeCluster::Server, this);
+    bindCluster(m_levelControlCluster);
+
+    m_colorControlCluster = new ZigbeeClusterColorControl(m_network, nullptr, nullptr, ZigbeeCluster::Server, this);
+    bindCluster(m_colorControlCluster);
+
+    m_scenesCluster = new ZigbeeClusterScenes(m_network, nullptr, nullptr, ZigbeeCluster::Server, this);
+    bindCluster(m_scenesCluster);
+}
+
+ZigbeeNetwork *ZigbeeGroupTarget::network() const
+{
+    return m_network;
+}
+
+quint16 ZigbeeGroupTarget::groupId() const
+{
+    return m_groupId;
+}
+
+Zigbee::ZigbeeProfile ZigbeeGroupTarget::profile() const
+{
+    return m_profile;
+}
+
+ZigbeeClusterOnOff *ZigbeeGroupTarget::onOffCluster() const
+{
+    return m_onOffCluster;
+}
+
+ZigbeeClusterLevelControl *ZigbeeGroupTarget::levelControlCluster() const
+{
+    return m_levelControlCluster;
+}
+
+ZigbeeClusterColorControl *ZigbeeGroupTarget::colorControlCluster() const
+{
+    return m_colorControlCluster;
+}
+
+ZigbeeClusterScenes *ZigbeeGroupTarget::scenesCluster() const
+{
+    return m_scenesCluster;
+}
+
+void ZigbeeGroupTarget::bindCluster(ZigbeeCluster *cluster)
+{
+    cluster->bindToGroup(m_groupId, m_profile);
+}
+
+QDebug operator<<(QDebug debug, ZigbeeGroupTarget *groupTarget)
+{
+    debug.nospace().noquote() << "ZigbeeGroupTarget(" << ZigbeeUtils::convertUint16ToHexString(groupTarget->groupId());
+    debug.nospace().noquote() << ", " << groupTarget->profile() << ")";
+    return debug.space();
+}
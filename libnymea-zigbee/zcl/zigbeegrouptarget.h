@@ -0,0 +1,76 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright 2013 - 2020, nymea GmbH
+* Contact: contact@nymea.io
+*
+* This file is part of nymea-zigbee.
+* This project including source code and documentation is protected by copyright law, and
+* remains the property of nymea GmbH. All rights, including reproduction, publication,
+* editing and translation, are reserved. The use of this project is subject to the terms of a
+* license agreement to be concluded with nymea GmbH in accordance with the terms
+* of use of nymea GmbH, available under https://nymea.io/license
+*
+* GNU Lesser General Public License Usage
+* Alternatively, this project may be redistributed and/or modified under the terms of the GNU
+* Lesser General Public License as published by the Free Software Foundation; version 3.
+* this project is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License along with this project.
+* If not, see <https://www.gnu.org/licenses/>.
+*
+* For any further details and any questions please contact us under contact@nymea.io
+* or see our FAQ/Licensing Information on https://nymea.io/license/faq
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ZIGBEEGROUPTARGET_H
+#define ZIGBEEGROUPTARGET_H
+
+#include <QObject>
+
+#include "zigbee.h"
+#include "zcl/general/zigbeeclusteronoff.h"
+#include "zcl/general/zigbeeclusterscenes.h"
+#include "zcl/general/zigbeeclusterlevelcontrol.h"
+#include "zcl/lighting/zigbeeclustercolorcontrol.h"
+
+class ZigbeeNetwork;
+
+// Sends cluster commands to all members of a group with one single groupcast instead of
+// one unicast per node. The replies finish once the groupcast has been sent, the group
+// members neither acknowledge nor respond to the commands.
+class ZigbeeGroupTarget : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ZigbeeGroupTarget(ZigbeeNetwork *network, quint16 groupId, Zigbee::ZigbeeProfile profile = Zigbee::ZigbeeProfileHomeAutomation, QObject *parent = nullptr);
+
+    ZigbeeNetwork *network() const;
+    quint16 groupId() const;
+    Zigbee::ZigbeeProfile profile() const;
+
+    ZigbeeClusterOnOff *onOffCluster() const;
+    ZigbeeClusterLevelControl *levelControlCluster() const;
+    ZigbeeClusterColorControl *colorControlCluster() const;
+    ZigbeeClusterScenes *scenesCluster() const;
+
+private:
+    ZigbeeNetwork *m_network = nullptr;
+    quint16 m_groupId = 0;
+    Zigbee::ZigbeeProfile m_profile = Zigbee::ZigbeeProfileHomeAutomation;
+
+    ZigbeeClusterOnOff *m_onOffCluster = nullptr;
+    ZigbeeClusterLevelControl *m_levelControlCluster = nullptr;
+    ZigbeeClusterColorControl *m_colorControlCluster = nullptr;
+    ZigbeeClusterScenes *m_scenesCluster = nullptr;
+
+    void bindCluster(ZigbeeCluster *cluster);
+
+};
+
+QDebug operator<<(QDebug debug, ZigbeeGroupTarget *groupTarget);
+
+#endif // ZIGBEEGROUPTARGET_H
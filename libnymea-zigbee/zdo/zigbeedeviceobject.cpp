@@ -55,6 +55,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestNetworkAddress()
     request.setProfileId(Zigbee::ZigbeeProfileDevice); // ZDP
     request.setClusterId(ZigbeeDeviceProfile::NetworkAddressRequest);
     request.setSourceEndpoint(0); // ZDO
+    request.setPriority(Zigbee::RequestPriorityBackground); // Used for reachability probes
 
     // Generate a new transaction sequence number for this device object
     quint8 transactionSequenceNumber = m_transactionSequenceNumber++;
@@ -75,7 +76,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestNetworkAddress()
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -120,7 +121,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestIeeeAddress()
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -163,7 +164,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestNodeDescriptor()
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -206,7 +207,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestPowerDescriptor()
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -248,7 +249,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestActiveEndpoints()
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -290,7 +291,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestSimpleDescriptor(quint8 endp
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -338,7 +339,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestBindGroupAddress(quint8 sour
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -388,7 +389,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestBindIeeeAddress(quint8 sourc
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -440,7 +441,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestUnbind(const ZigbeeDevicePro
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -483,7 +484,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestBindRegister(const ZigbeeAdd
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -534,7 +535,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestMgmtLeaveNetwork(bool rejoin
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -559,6 +560,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestMgmtLqi(quint8 startIndex)
 
     // Build APS request
     ZigbeeNetworkRequest request = buildZdoRequest(ZigbeeDeviceProfile::MgmtLqiRequest);
+    request.setPriority(Zigbee::RequestPriorityBackground);
 
     // Generate a new transaction sequence number for this device object
     quint8 transactionSequenceNumber = m_transactionSequenceNumber++;
@@ -575,7 +577,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestMgmtLqi(quint8 startIndex)
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -601,6 +603,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestMgmtBind(quint8 startIndex)
 
     // Build APS request
     ZigbeeNetworkRequest request = buildZdoRequest(ZigbeeDeviceProfile::MgmtBindRequest);
+    request.setPriority(Zigbee::RequestPriorityBackground);
 
     // Generate a new transaction sequence number for this device object
     quint8 transactionSequenceNumber = m_transactionSequenceNumber++;
@@ -617,7 +620,7 @@ ZigbeeDeviceObjectReply *ZigbeeDeviceObject::requestMgmtBind(quint8 startIndex)
     ZigbeeDeviceObjectReply *zdoReply = createZigbeeDeviceObjectReply(request, transactionSequenceNumber);
 
     // Send the request, on finished read the confirm information
-    ZigbeeNetworkReply *networkReply = m_network->sendRequest(request);
+    ZigbeeNetworkReply *networkReply = sendRequest(request);
     connect(networkReply, &ZigbeeNetworkReply::finished, zdoReply, [this, networkReply, zdoReply](){
         if (!verifyNetworkError(zdoReply, networkReply)) {
             finishZdoReply(zdoReply);
@@ -650,6 +653,15 @@ ZigbeeNetworkRequest ZigbeeDeviceObject::buildZdoRequest(quint16 zdoRequest)
     return request;
 }
 
+ZigbeeNetworkReply *ZigbeeDeviceObject::sendRequest(ZigbeeNetworkRequest request)
+{
+    // Requests to a node which is not initialized yet belong to the interview
+    if (request.priority() == Zigbee::RequestPriorityUser && m_node->state() != ZigbeeNode::StateInitialized)
+        request.setPriority(Zigbee::RequestPriorityInterview);
+
+    return m_network->sendRequest(request);
+}
+
 ZigbeeDeviceObjectReply *ZigbeeDeviceObject::createZigbeeDeviceObjectReply(const ZigbeeNetworkRequest &request, quint8 transactionSequenceNumber)
 {
     ZigbeeDeviceObjectReply *zdoReply = new ZigbeeDeviceObjectReply(request, this);
@@ -685,6 +697,10 @@ bool ZigbeeDeviceObject::verifyNetworkError(ZigbeeDeviceObjectReply *zdoReply, Z
         zdoReply->m_error = ZigbeeDeviceObjectReply::ErrorNetworkOffline;
         qCWarning(dcZigbeeDeviceObject()) << "Failed to send request" << static_cast<ZigbeeDeviceProfile::ZdoCommand>(networkReply->request().clusterId()) << m_node << networkReply->error();
         break;
+    case ZigbeeNetworkReply::ErrorRequestIdUnavailable:
+        zdoReply->m_error = ZigbeeDeviceObjectReply::ErrorInterfaceError;
+        qCWarning(dcZigbeeDeviceObject()) << "Failed to send request" << static_cast<ZigbeeDeviceProfile::ZdoCommand>(networkReply->request().clusterId()) << m_node << networkReply->error();
+        break;
     case ZigbeeNetworkReply::ErrorZigbeeMacStatusError:
         zdoReply->setZigbeeMacLayerStatus(networkReply->zigbeeMacStatus());
         qCWarning(dcZigbeeDeviceObject()) << "Failed to send request" << static_cast<ZigbeeDeviceProfile::ZdoCommand>(networkReply->request().clusterId()) << m_node << networkReply->zigbeeMacStatus();
@@ -73,6 +73,7 @@ private:
 
     // Helper methods for replies
     ZigbeeNetworkRequest buildZdoRequest(quint16 zdoRequest);
+    ZigbeeNetworkReply *sendRequest(ZigbeeNetworkRequest request);
     ZigbeeDeviceObjectReply *createZigbeeDeviceObjectReply(const ZigbeeNetworkRequest &request, quint8 transactionSequenceNumber);
     bool verifyNetworkError(ZigbeeDeviceObjectReply *zdoReply, ZigbeeNetworkReply *networkReply);
     void finishZdoReply(ZigbeeDeviceObjectReply *zdoReply);
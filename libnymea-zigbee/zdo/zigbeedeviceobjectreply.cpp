@@ -27,14 +27,12 @@
 
 #include "zigbeedeviceobjectreply.h"
 
-#include <QTimer>
-
 ZigbeeDeviceObjectReply::ZigbeeDeviceObjectReply(const ZigbeeNetworkRequest &request, QObject *parent) :
     QObject(parent),
     m_request(request)
 {
     m_timeoutTimer.setInterval(5000);
-    connect(&m_timeoutTimer, &QTimer::timeout, this, [this](){
+    m_timeoutTimer.setCallback([this](){
         m_error = ErrorTimeout;
         emit finished();
     });
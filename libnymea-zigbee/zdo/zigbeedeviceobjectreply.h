@@ -29,8 +29,8 @@
 #define ZIGBEEDEVICEOBJECTREPLY_H
 
 #include <QObject>
-#include <QTimer>
 
+#include "zigbeetimerwheel.h"
 #include "zigbeedeviceprofile.h"
 #include "zigbeenetworkrequest.h"
 
@@ -73,7 +73,7 @@ private:
 
     Error m_error = ErrorNoError;
 
-    QTimer m_timeoutTimer;
+    ZigbeeTimeout m_timeoutTimer;
 
     // Request information
     ZigbeeNetworkRequest m_request;
@@ -273,6 +273,15 @@ public:
     Q_ENUM(ZigbeeTxOption)
     Q_DECLARE_FLAGS(ZigbeeTxOptions, ZigbeeTxOption)
 
+    // Traffic classes used for scheduling requests to the controller, ordered from highest to lowest priority
+    enum RequestPriority {
+        RequestPriorityInbound = 0, // Draining received data from the controller
+        RequestPriorityUser = 1, // User initiated commands
+        RequestPriorityInterview = 2, // Node initialization and configuration
+        RequestPriorityBackground = 3 // Maintenance like reachability probes and binding table reads
+    };
+    Q_ENUM(RequestPriority)
+
     enum Manufacturer {
         // RF4CE
         PanasonicRF4CE          = 0x0001,
@@ -58,6 +58,22 @@ bool ZigbeeBridgeController::updateRunning() const
     return m_updateRunning;
 }
 
+bool ZigbeeBridgeController::ioThreadEnabled() const
+{
+    return m_ioThreadEnabled;
+}
+
+void ZigbeeBridgeController::setIoThreadEnabled(bool ioThreadEnabled)
+{
+    m_ioThreadEnabled = ioThreadEnabled;
+}
+
+int ZigbeeBridgeController::requestQueueDepth(Zigbee::RequestPriority priority) const
+{
+    Q_UNUSED(priority)
+    return 0;
+}
+
 bool ZigbeeBridgeController::updateAvailable(const QString &currentVersion)
 {
     Q_UNUSED(currentVersion)
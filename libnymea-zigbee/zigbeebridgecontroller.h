@@ -52,6 +52,13 @@ public:
     bool initiallyFlashed() const;
     bool updateRunning() const;
 
+    // Optional dedicated serial I/O thread, has to be configured before enabling the controller
+    bool ioThreadEnabled() const;
+    void setIoThreadEnabled(bool ioThreadEnabled);
+
+    // Number of requests waiting in the controller queue for the given traffic class
+    virtual int requestQueueDepth(Zigbee::RequestPriority priority) const;
+
     // Optional update/initialize procedure for the zigbee controller
     virtual bool updateAvailable(const QString &currentVersion);
     virtual QString updateFirmwareVersion() const;
@@ -64,6 +71,7 @@ protected:
     bool m_canUpdate = false;
     bool m_initiallyFlashed = false;
     bool m_updateRunning = false;
+    bool m_ioThreadEnabled = false;
     QDir m_settingsDirectory = QDir("/etc/nymea/");
 
     void setAvailable(bool available);
@@ -31,21 +31,125 @@
 #include <QtGlobal>
 #include <QDataStream>
 
+#include <string.h>
+
+// Meta information of each data type indexed by the type id. The encoded length of variable
+// length types is negative: -1: 1 length byte, -2: 2 length bytes, -3: array and structure,
+// -4: set and bag. Reserved type ids have the length 0.
+typedef struct DataTypeInfo {
+    qint8 length;
+    const char *name;
+    const char *className;
+} DataTypeInfo;
+
+static constexpr DataTypeInfo s_reserved = { 0, "Unknown", "Null" };
+
+static constexpr DataTypeInfo s_dataTypeInfos[256] = {
+    { 0, "No data", "Null" }, // 0x00 NoData
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x01 - 0x07
+    { 1, "8-bit data", "General data discrete" }, // 0x08 Data8
+    { 2, "16-bit data", "General data discrete" }, // 0x09 Data16
+    { 3, "24-bit data", "General data discrete" }, // 0x0a Data24
+    { 4, "32-bit data", "General data discrete" }, // 0x0b Data32
+    { 5, "40-bit data", "General data discrete" }, // 0x0c Data40
+    { 6, "48-bit data", "General data discrete" }, // 0x0d Data48
+    { 7, "56-bit data", "General data discrete" }, // 0x0e Data56
+    { 8, "64-bit data", "General data discrete" }, // 0x0f Data64
+    { 1, "Bool", "Logical discrete" }, // 0x10 Bool
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x11 - 0x17
+    { 1, "8-bit bitmap", "Bitmap discrete" }, // 0x18 BitMap8
+    { 2, "16-bit bitmap", "Bitmap discrete" }, // 0x19 BitMap16
+    { 3, "24-bit bitmap", "Bitmap discrete" }, // 0x1a BitMap24
+    { 4, "32-bit bitmap", "Bitmap discrete" }, // 0x1b BitMap32
+    { 5, "40-bit bitmap", "Bitmap discrete" }, // 0x1c BitMap40
+    { 6, "48-bit bitmap", "Bitmap discrete" }, // 0x1d BitMap48
+    { 7, "56-bit bitmap", "Bitmap discrete" }, // 0x1e BitMap56
+    { 8, "64-bit bitmap", "Bitmap discrete" }, // 0x1f BitMap64
+    { 1, "Unsigned 8-bit integer", "Unsigned integer analog" }, // 0x20 Uint8
+    { 2, "Unsigned 16-bit integer", "Unsigned integer analog" }, // 0x21 Uint16
+    { 3, "Unsigned 24-bit integer", "Unsigned integer analog" }, // 0x22 Uint24
+    { 4, "Unsigned 32-bit integer", "Unsigned integer analog" }, // 0x23 Uint32
+    { 5, "Unsigned 40-bit integer", "Unsigned integer analog" }, // 0x24 Uint40
+    { 6, "Unsigned 48-bit integer", "Unsigned integer analog" }, // 0x25 Uint48
+    { 7, "Unsigned 56-bit integer", "Unsigned integer analog" }, // 0x26 Uint56
+    { 8, "Unsigned 64-bit integer", "Unsigned integer analog" }, // 0x27 Uint64
+    { 1, "Signed 8-bit integer", "Signed integer analog" }, // 0x28 Int8
+    { 2, "Signed 16-bit integer", "Signed integer analog" }, // 0x29 Int16
+    { 3, "Signed 24-bit integer", "Signed integer analog" }, // 0x2a Int24
+    { 4, "Signed 32-bit integer", "Signed integer analog" }, // 0x2b Int32
+    { 5, "Signed 40-bit integer", "Signed integer analog" }, // 0x2c Int40
+    { 6, "Signed 48-bit integer", "Signed integer analog" }, // 0x2d Int48
+    { 7, "Signed 56-bit integer", "Signed integer analog" }, // 0x2e Int56
+    { 8, "Signed 64-bit integer", "Signed integer analog" }, // 0x2f Int64
+    { 1, "8-bit enumeration", "Enumeration discrete" }, // 0x30 Enum8
+    { 2, "16-bit enumeration", "Enumeration discrete" }, // 0x31 Enum16
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x32 - 0x37
+    { 2, "Semi-precision", "Floating point analog" }, // 0x38 FloatSemi
+    { 4, "Single precision", "Floating point analog" }, // 0x39 FloatSingle
+    { 8, "Double precision", "Floating point analog" }, // 0x3a FloatDouble
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x3b - 0x40
+    { -1, "Octet string", "String discrete" }, // 0x41 OctetString
+    { -1, "Character string", "String discrete" }, // 0x42 CharString
+    { -2, "Long octet string", "String discrete" }, // 0x43 LongOctetString
+    { -2, "Long character string", "String discrete" }, // 0x44 LongCharString
+    s_reserved, s_reserved, s_reserved, // 0x45 - 0x47
+    { -3, "Array", "Ordered sequence discrete" }, // 0x48 Array
+    s_reserved, s_reserved, s_reserved, // 0x49 - 0x4b
+    { -3, "Structure", "Ordered sequence discrete" }, // 0x4c Structure
+    s_reserved, s_reserved, s_reserved, // 0x4d - 0x4f
+    { -4, "Set", "Collection discrete" }, // 0x50 Set
+    { -4, "Bag", "Collection discrete" }, // 0x51 Bag
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x52 - 0x59
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x5a - 0x61
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x62 - 0x69
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x6a - 0x71
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x72 - 0x79
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x7a - 0x81
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x82 - 0x89
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x8a - 0x91
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x92 - 0x99
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0x9a - 0xa1
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0xa2 - 0xa9
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0xaa - 0xb1
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0xb2 - 0xb9
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0xba - 0xc1
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0xc2 - 0xc9
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0xca - 0xd1
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0xd2 - 0xd9
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0xda - 0xdf
+    { 4, "Time of day", "Time analog" }, // 0xe0 TimeOfDay
+    { 4, "Date", "Time analog" }, // 0xe1 Date
+    { 4, "UTC time", "Time analog" }, // 0xe2 UtcTime
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0xe3 - 0xe7
+    { 2, "Cluster ID", "Identifier discrete" }, // 0xe8 Cluster
+    { 2, "Attribute ID", "Identifier discrete" }, // 0xe9 Attribute
+    { 4, "BACnet OID", "Identifier discrete" }, // 0xea BacnetId
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0xeb - 0xef
+    { 8, "IEEE address", "Miscellaneous discrete" }, // 0xf0 IeeeAddress
+    { 16, "128-bit security key", "Miscellaneous discrete" }, // 0xf1 BitKey128
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, // 0xf2 - 0xf9
+    s_reserved, s_reserved, s_reserved, s_reserved, s_reserved, s_reserved // 0xfa - 0xff
+};
+
 ZigbeeDataType::ZigbeeDataType()
 {
-    setDataType(Zigbee::NoData);
+
 }
 
-ZigbeeDataType::ZigbeeDataType(const ZigbeeDataType &other)
+ZigbeeDataType::ZigbeeDataType(const ZigbeeDataType &other) :
+    m_dataType(other.m_dataType),
+    m_inlineSize(other.m_inlineSize),
+    m_null(other.m_null),
+    m_data(other.m_data)
 {
-    setDataType(other.dataType());
-    m_data = other.data();
+    memcpy(m_inlineData, other.m_inlineData, m_inlineSize);
 }
 
 ZigbeeDataType::ZigbeeDataType(Zigbee::DataType dataType, const QByteArray &data):
-    m_data(data)
+    m_dataType(dataType)
 {
-    setDataType(dataType);
+    if (m_dataType != Zigbee::NoData)
+        setData(data.constData(), data.size(), data.isNull());
 
     // TODO: verify data length and consistency
 
@@ -169,121 +273,77 @@ ZigbeeDataType::ZigbeeDataType(Zigbee::DataType dataType, const QByteArray &data
 
 }
 
-ZigbeeDataType::ZigbeeDataType(quint8 value)
+ZigbeeDataType::ZigbeeDataType(Zigbee::DataType dataType, const char *data, int size) :
+    m_dataType(dataType)
 {
-    setDataType(Zigbee::Uint8);
-    m_data.clear();
-    QDataStream stream(&m_data, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream << value;
+    if (m_dataType != Zigbee::NoData)
+        setData(data, size, false);
 }
 
-ZigbeeDataType::ZigbeeDataType(quint16 value)
+ZigbeeDataType::ZigbeeDataType(quint8 value) :
+    m_dataType(Zigbee::Uint8)
 {
-    setDataType(Zigbee::Uint16);
-    m_data.clear();
-    QDataStream stream(&m_data, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream << value;
+    setLittleEndianValue(value, 1);
 }
 
-ZigbeeDataType::ZigbeeDataType(quint32 value, Zigbee::DataType dataType)
+ZigbeeDataType::ZigbeeDataType(quint16 value) :
+    m_dataType(Zigbee::Uint16)
 {
-    Q_ASSERT_X(dataType == Zigbee::Uint24 || dataType == Zigbee::Uint32, "ZigbeeDataType", "invalid data type for quint32 constructor");
-    setDataType(dataType);
-    m_data.clear();
-    QDataStream stream(&m_data, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream << value;
+    setLittleEndianValue(value, 2);
+}
 
-    if (m_dataType == Zigbee::Uint24) {
-        m_data.chop(1);
-    }
+ZigbeeDataType::ZigbeeDataType(quint32 value, Zigbee::DataType dataType) :
+    m_dataType(dataType)
+{
+    Q_ASSERT_X(dataType == Zigbee::Uint24 || dataType == Zigbee::Uint32, "ZigbeeDataType", "invalid data type for quint32 constructor");
+    setLittleEndianValue(value, m_dataType == Zigbee::Uint24 ? 3 : 4);
 }
 
-ZigbeeDataType::ZigbeeDataType(quint64 value, Zigbee::DataType dataType)
+ZigbeeDataType::ZigbeeDataType(quint64 value, Zigbee::DataType dataType) :
+    m_dataType(dataType)
 {
     Q_ASSERT_X(dataType == Zigbee::Uint40 || dataType == Zigbee::Uint48 || dataType == Zigbee::Uint56 || dataType == Zigbee::Uint64, "ZigbeeDataType", "invalid data type for quint64 constructor");
-    setDataType(dataType);
-    m_data.clear();
-    QDataStream stream(&m_data, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream << value;
-
-    if (m_dataType == Zigbee::Uint40) {
-        m_data.chop(3);
-    } else if (m_dataType == Zigbee::Uint48) {
-        m_data.chop(2);
-    } else if (m_dataType == Zigbee::Uint56) {
-        m_data.chop(1);
-    }
+    setLittleEndianValue(value, typeLength(m_dataType));
 }
 
-ZigbeeDataType::ZigbeeDataType(qint8 value)
+ZigbeeDataType::ZigbeeDataType(qint8 value) :
+    m_dataType(Zigbee::Int8)
 {
-    setDataType(Zigbee::Int8);
-    m_data.clear();
-    QDataStream stream(&m_data, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream << value;
+    setLittleEndianValue(static_cast<quint8>(value), 1);
 }
 
-ZigbeeDataType::ZigbeeDataType(qint16 value)
+ZigbeeDataType::ZigbeeDataType(qint16 value) :
+    m_dataType(Zigbee::Int16)
 {
-    setDataType(Zigbee::Int16);
-    m_data.clear();
-    QDataStream stream(&m_data, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream << value;
+    setLittleEndianValue(static_cast<quint16>(value), 2);
 }
 
-ZigbeeDataType::ZigbeeDataType(qint32 value, Zigbee::DataType dataType)
+ZigbeeDataType::ZigbeeDataType(qint32 value, Zigbee::DataType dataType) :
+    m_dataType(dataType)
 {
     Q_ASSERT_X(dataType == Zigbee::Int24 || dataType == Zigbee::Int32, "ZigbeeDataType", "invalid data type for qint32 constructor");
-    setDataType(dataType);
-    m_data.clear();
-    QDataStream stream(&m_data, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream << value;
-
-    if (m_dataType == Zigbee::Int24) {
-        m_data.chop(1);
-    }
+    setLittleEndianValue(static_cast<quint32>(value), m_dataType == Zigbee::Int24 ? 3 : 4);
 }
 
-ZigbeeDataType::ZigbeeDataType(qint64 value, Zigbee::DataType dataType)
+ZigbeeDataType::ZigbeeDataType(qint64 value, Zigbee::DataType dataType) :
+    m_dataType(dataType)
 {
     Q_ASSERT_X(dataType == Zigbee::Int40 || dataType == Zigbee::Int48 || dataType == Zigbee::Int56 || dataType == Zigbee::Int64, "ZigbeeDataType", "invalid data type for qint64 constructor");
-    setDataType(dataType);
-    m_data.clear();
-    QDataStream stream(&m_data, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream << value;
-
-    if (m_dataType == Zigbee::Int40) {
-        m_data.chop(3);
-    } else if (m_dataType == Zigbee::Int48) {
-        m_data.chop(2);
-    } else if (m_dataType == Zigbee::Int56) {
-        m_data.chop(1);
-    }
+    setLittleEndianValue(static_cast<quint64>(value), typeLength(m_dataType));
 }
 
-ZigbeeDataType::ZigbeeDataType(bool value)
+ZigbeeDataType::ZigbeeDataType(bool value) :
+    m_dataType(Zigbee::Bool)
 {
-    setDataType(Zigbee::Bool);
-    m_data.clear();
-    QDataStream stream(&m_data, QIODevice::WriteOnly);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream << (value ? static_cast<quint8>(1) : static_cast<quint8>(0));
+    setLittleEndianValue(value ? 1 : 0, 1);
 }
 
-ZigbeeDataType::ZigbeeDataType(const QString &value, Zigbee::DataType dataType)
+ZigbeeDataType::ZigbeeDataType(const QString &value, Zigbee::DataType dataType) :
+    m_dataType(dataType)
 {
     Q_ASSERT_X(dataType == Zigbee::OctetString || dataType == Zigbee::CharString || dataType == Zigbee::LongOctetString || dataType == Zigbee::LongCharString, "ZigbeeDataType", "invalid data type for QString constructor");
-    setDataType(dataType);
-    m_data.clear();
-    QDataStream stream(&m_data, QIODevice::WriteOnly);
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
     stream.setByteOrder(QDataStream::LittleEndian);
 
     if (dataType == Zigbee::OctetString || dataType == Zigbee::CharString) {
@@ -299,268 +359,108 @@ ZigbeeDataType::ZigbeeDataType(const QString &value, Zigbee::DataType dataType)
             stream << static_cast<quint16>(value.at(i).toLatin1());
         }
     }
+
+    setData(data.constData(), data.size(), data.isNull());
 }
 
 quint8 ZigbeeDataType::toUInt8(bool *ok) const
 {
     if (ok) *ok = true;
-    if (m_data.count() != 1) {
+    if (size() != 1) {
         if (ok) *ok = false;
         return 0;
     }
 
-    return static_cast<quint8>(m_data.at(0));
+    return static_cast<quint8>(byteAt(0));
 }
 
 quint16 ZigbeeDataType::toUInt16(bool *ok) const
 {
     if (ok) *ok = true;
-
-    quint16 value = 0;
-    if (m_data.count() != 2) {
+    if (size() != 2) {
         if (ok) *ok = false;
-        return value;
+        return 0;
     }
 
-    QDataStream stream(m_data);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream >> value;
-    return value;
+    return static_cast<quint16>(littleEndianValue(2));
 }
 
 quint32 ZigbeeDataType::toUInt32(bool *ok) const
 {
     if (ok) *ok = true;
-    quint32 value = 0;
 
-    // Verify the data type
-    if (m_dataType != Zigbee::Uint24 && m_dataType != Zigbee::Uint32) {
+    // Verify the data type and make sure there is enought data
+    if ((m_dataType != Zigbee::Uint24 && m_dataType != Zigbee::Uint32) || (size() != 3 && size() != 4)) {
         if (ok) *ok = false;
-        return value;
-    }
-
-    // Make sure there is enought data
-    if (m_data.count() != 3 && m_data.count() != 4) {
-        if (ok) *ok = false;
-        return value;
-    }
-
-    if (m_data.count() == 3) {
-        // Make it 32 bit for converting
-        QByteArray convertedData(m_data);
-        convertedData.append(static_cast<char>(0));
-        QDataStream stream(convertedData);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> value;
-    } else {
-        QDataStream stream(m_data);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> value;
+        return 0;
     }
 
-    return value;
+    return static_cast<quint32>(littleEndianValue(size()));
 }
 
 quint64 ZigbeeDataType::toUInt64(bool *ok) const
 {
     if (ok) *ok = true;
-    quint64 value = 0;
-
-    switch (m_dataType) {
-    case Zigbee::Uint40: {
-        if (m_data.count() != 5) {
-            if (ok) *ok = false;
-            break;
-        }
-
-        // Make it 64 bit for converting
-        QByteArray convertedData(m_data);
-        for (int i = 0; i < 3; i++)
-            convertedData.append(static_cast<char>(0));
-
-        QDataStream stream(convertedData);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> value;
-        break;
-    }
-    case Zigbee::Uint48: {
-        if (m_data.count() != 6) {
-            if (ok) *ok = false;
-            break;
-        }
 
-        // Make it 64 bit for converting
-        QByteArray convertedData(m_data);
-        for (int i = 0; i < 2; i++)
-            convertedData.append(static_cast<char>(0));
-
-        QDataStream stream(convertedData);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> value;
-        break;
-    }
-    case Zigbee::Uint56: {
-        if (m_data.count() != 7) {
-            if (ok) *ok = false;
-            break;
-        }
-
-        // Make it 64 bit for converting
-        QByteArray convertedData(m_data);
-        convertedData.append(static_cast<char>(0));
-        QDataStream stream(convertedData);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> value;
-        break;
-    }
-    case Zigbee::Uint64: {
-        if (m_data.count() != 8) {
-            if (ok) *ok = false;
-            break;
-        }
-
-        QDataStream stream(m_data);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> value;
-        break;
-    }
-    default:
+    // Verify the data type and make sure there is enought data
+    bool validType = m_dataType == Zigbee::Uint40 || m_dataType == Zigbee::Uint48 || m_dataType == Zigbee::Uint56 || m_dataType == Zigbee::Uint64;
+    if (!validType || size() != typeLength(m_dataType)) {
         if (ok) *ok = false;
-        break;
+        return 0;
     }
 
-    return value;
+    return littleEndianValue(size());
 }
 
 qint8 ZigbeeDataType::toInt8(bool *ok) const
 {
     if (ok) *ok = true;
-    if (m_data.count() != 1) {
+    if (size() != 1) {
         if (ok) *ok = false;
         return 0;
     }
 
-    return static_cast<qint8>(m_data.at(0));
+    return static_cast<qint8>(byteAt(0));
 }
 
 qint16 ZigbeeDataType::toInt16(bool *ok) const
 {
     if (ok) *ok = true;
-
-    qint16 value = 0;
-    if (m_data.count() != 2 || m_dataType != Zigbee::Int16) {
+    if (size() != 2 || m_dataType != Zigbee::Int16) {
         if (ok) *ok = false;
-        return value;
+        return 0;
     }
 
-    QDataStream stream(m_data);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    stream >> value;
-    return value;
+    return static_cast<qint16>(littleEndianValue(2));
 }
 
 qint32 ZigbeeDataType::toInt32(bool *ok) const
 {
     if (ok) *ok = true;
-    qint32 value = 0;
 
-    // Verify the data type
-    if (m_dataType != Zigbee::Int24 && m_dataType != Zigbee::Int32) {
+    // Verify the data type and make sure there is enought data
+    if ((m_dataType != Zigbee::Int24 && m_dataType != Zigbee::Int32) || (size() != 3 && size() != 4)) {
         if (ok) *ok = false;
-        return value;
-    }
-
-    // Make sure there is enought data
-    if (m_data.count() != 3 && m_data.count() != 4) {
-        if (ok) *ok = false;
-        return value;
-    }
-
-    if (m_data.count() == 3) {
-        // Make it 32 bit for converting
-        QByteArray convertedData(m_data);
-        convertedData.append(static_cast<char>(0));
-        QDataStream stream(convertedData);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> value;
-    } else {
-        QDataStream stream(m_data);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> value;
+        return 0;
     }
 
-    return value;
+    // Note: 24-bit values are not sign extended
+    return static_cast<qint32>(littleEndianValue(size()));
 }
 
 qint64 ZigbeeDataType::toInt64(bool *ok) const
 {
     if (ok) *ok = true;
-    qint64 value = 0;
-
-    switch (m_dataType) {
-    case Zigbee::Int40: {
-        if (m_data.count() != 5) {
-            if (ok) *ok = false;
-            break;
-        }
-
-        // Make it 64 bit for converting
-        QByteArray convertedData(m_data);
-        for (int i = 0; i < 3; i++)
-            convertedData.append(static_cast<char>(0));
 
-        QDataStream stream(convertedData);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> value;
-        break;
-    }
-    case Zigbee::Int48: {
-        if (m_data.count() != 6) {
-            if (ok) *ok = false;
-            break;
-        }
-
-        // Make it 64 bit for converting
-        QByteArray convertedData(m_data);
-        for (int i = 0; i < 2; i++)
-            convertedData.append(static_cast<char>(0));
-
-        QDataStream stream(convertedData);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> value;
-        break;
-    }
-    case Zigbee::Int56: {
-        if (m_data.count() != 7) {
-            if (ok) *ok = false;
-            break;
-        }
-
-        // Make it 64 bit for converting
-        QByteArray convertedData(m_data);
-        convertedData.append(static_cast<char>(0));
-        QDataStream stream(convertedData);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> value;
-        break;
-    }
-    case Zigbee::Int64: {
-        if (m_data.count() != 8) {
-            if (ok) *ok = false;
-            break;
-        }
-
-        QDataStream stream(m_data);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> value;
-        break;
-    }
-    default:
+    // Verify the data type and make sure there is enought data
+    bool validType = m_dataType == Zigbee::Int40 || m_dataType == Zigbee::Int48 || m_dataType == Zigbee::Int56 || m_dataType == Zigbee::Int64;
+    if (!validType || size() != typeLength(m_dataType)) {
         if (ok) *ok = false;
-        break;
+        return 0;
     }
 
-    return value;
+    // Note: values shorter than 64-bit are not sign extended
+    return static_cast<qint64>(littleEndianValue(size()));
 }
 
 bool ZigbeeDataType::toBool(bool *ok) const
@@ -568,12 +468,12 @@ bool ZigbeeDataType::toBool(bool *ok) const
     if (ok) *ok = true;
     bool value = false;
 
-    if (m_data.count() != 1) {
+    if (size() != 1) {
         if (ok) *ok = false;
         return value;
     }
 
-    if (m_data.at(0) != 0) {
+    if (byteAt(0) != 0) {
         value = true;
     }
 
@@ -586,14 +486,11 @@ QString ZigbeeDataType::toString(bool *ok) const
     QString value;
 
     if (m_dataType == Zigbee::OctetString || m_dataType == Zigbee::CharString) {
-        quint8 length = m_data.at(0);
-        value = QString::fromUtf8(m_data.right(length));
+        int length = qMin<int>(size() > 0 ? static_cast<quint8>(byteAt(0)) : 0, size());
+        value = QString::fromUtf8(constData() + size() - length, length);
     } else if (m_dataType == Zigbee::LongOctetString || m_dataType == Zigbee::LongCharString) {
-        quint16 length = 0;
-        QDataStream lengthStream(m_data.left(2));
-        lengthStream.setByteOrder(QDataStream::LittleEndian);
-        lengthStream >> length;
-        value = QString::fromUtf8(m_data.right(length));
+        int length = qMin<int>(size() >= 2 ? static_cast<quint16>(littleEndianValue(2)) : 0, size());
+        value = QString::fromUtf8(constData() + size() - length, length);
     } else {
         if (ok) *ok = false;
     }
@@ -604,14 +501,14 @@ float ZigbeeDataType::toFloat(bool *ok) const
 {
     if (ok) *ok = true;
     float value = 0;
-    if (m_dataType == Zigbee::FloatSemi && m_data.length() == 2) {
-        value = (m_data.at(0) & 0xFF)
-                | ((m_data.at(1) & 0xFF00) << 8);
-    } else if (m_dataType == Zigbee::FloatSingle && m_data.length() == 4) {
-        value = (m_data.at(0) & 0xFF)
-                | ((m_data.at(1) & 0xFF00) << 8)
-                | ((m_data.at(2) & 0xFF0000) << 16)
-                | ((m_data.at(3) & 0xFF000000) << 24);
+    if (m_dataType == Zigbee::FloatSemi && size() == 2) {
+        value = (byteAt(0) & 0xFF)
+                | ((byteAt(1) & 0xFF00) << 8);
+    } else if (m_dataType == Zigbee::FloatSingle && size() == 4) {
+        value = (byteAt(0) & 0xFF)
+                | ((byteAt(1) & 0xFF00) << 8)
+                | ((byteAt(2) & 0xFF0000) << 16)
+                | ((byteAt(3) & 0xFF000000) << 24);
     } else {
         if (ok) *ok = false;
     }
@@ -622,23 +519,23 @@ double ZigbeeDataType::toDouble(bool *ok) const
 {
     if (ok) *ok = true;
     double value = 0;
-    if (m_dataType == Zigbee::FloatSemi && m_data.length() == 2) {
-        value = (m_data.at(0) & 0xFF)
-                | ((m_data.at(1) & 0xFF00) << 8);
-    } else if (m_dataType == Zigbee::FloatSingle && m_data.length() == 4) {
-        value = (m_data.at(0) & 0xFF)
-                | ((m_data.at(1) & 0xFF00) << 8)
-                | ((m_data.at(2) & 0xFF0000) << 16)
-                | ((m_data.at(3) & 0xFF000000) << 24);
-    } else if (m_dataType == Zigbee::FloatDouble && m_data.length() == 8) {
-        value = (m_data.at(0) & 0xFF)
-                | ((m_data.at(1) & 0xFF00) << 8)
-                | ((m_data.at(2) & 0xFF0000) << 16)
-                | ((m_data.at(3) & 0xFF000000) << 24)
-                | ((m_data.at(4) & 0xFF00000000) << 32)
-                | ((m_data.at(5) & 0xFF0000000000) << 40)
-                | ((m_data.at(6) & 0xFF000000000000) << 48)
-                | ((m_data.at(7) & 0xFF00000000000000) << 56);
+    if (m_dataType == Zigbee::FloatSemi && size() == 2) {
+        value = (byteAt(0) & 0xFF)
+                | ((byteAt(1) & 0xFF00) << 8);
+    } else if (m_dataType == Zigbee::FloatSingle && size() == 4) {
+        value = (byteAt(0) & 0xFF)
+                | ((byteAt(1) & 0xFF00) << 8)
+                | ((byteAt(2) & 0xFF0000) << 16)
+                | ((byteAt(3) & 0xFF000000) << 24);
+    } else if (m_dataType == Zigbee::FloatDouble && size() == 8) {
+        value = (byteAt(0) & 0xFF)
+                | ((byteAt(1) & 0xFF00) << 8)
+                | ((byteAt(2) & 0xFF0000) << 16)
+                | ((byteAt(3) & 0xFF000000) << 24)
+                | ((byteAt(4) & 0xFF00000000) << 32)
+                | ((byteAt(5) & 0xFF0000000000) << 40)
+                | ((byteAt(6) & 0xFF000000000000) << 48)
+                | ((byteAt(7) & 0xFF00000000000000) << 56);
     } else {
         if (ok) *ok = false;
     }
@@ -652,17 +549,23 @@ Zigbee::DataType ZigbeeDataType::dataType() const
 
 QString ZigbeeDataType::name() const
 {
-    return m_name;
+    return QString::fromLatin1(s_dataTypeInfos[static_cast<quint8>(m_dataType)].name);
 }
 
 QString ZigbeeDataType::className() const
 {
-    return m_className;
+    return QString::fromLatin1(s_dataTypeInfos[static_cast<quint8>(m_dataType)].className);
 }
 
 QByteArray ZigbeeDataType::data() const
 {
-    return m_data;
+    if (m_null)
+        return QByteArray();
+
+    if (!m_data.isNull())
+        return m_data;
+
+    return QByteArray(m_inlineData, m_inlineSize);
 }
 
 int ZigbeeDataType::dataLength() const
@@ -673,202 +576,27 @@ int ZigbeeDataType::dataLength() const
 bool ZigbeeDataType::isValid() const
 {
     // FIXME: implement validate data depending on the type
-    return m_dataType != Zigbee::NoData && !m_data.isNull();
+    return m_dataType != Zigbee::NoData && !m_null;
 }
 
 int ZigbeeDataType::typeLength(Zigbee::DataType dataType)
 {
-    int length = 0;
-    switch (dataType) {
-    case Zigbee::NoData:
-        break;
-    case Zigbee::Data8:
-        length = 1;
-        break;
-    case Zigbee::Data16:
-        length = 2;
-        break;
-    case Zigbee::Data24:
-        length = 3;
-        break;
-    case Zigbee::Data32:
-        length = 4;
-        break;
-    case Zigbee::Data40:
-        length = 5;
-        break;
-    case Zigbee::Data48:
-        length = 6;
-        break;
-    case Zigbee::Data56:
-        length = 7;
-        break;
-    case Zigbee::Data64:
-        length = 8;
-        break;
-    case Zigbee::Bool:
-        length = 1;
-        break;
-    case Zigbee::BitMap8:
-        length = 1;
-        break;
-    case Zigbee::BitMap16:
-        length = 2;
-        break;
-    case Zigbee::BitMap24:
-        length = 3;
-        break;
-    case Zigbee::BitMap32:
-        length = 4;
-        break;
-    case Zigbee::BitMap40:
-        length = 5;
-        break;
-    case Zigbee::BitMap48:
-        length = 6;
-        break;
-    case Zigbee::BitMap56:
-        length = 7;
-        break;
-    case Zigbee::BitMap64:
-        length = 8;
-        break;
-    case Zigbee::Uint8:
-        length = 1;
-        break;
-    case Zigbee::Uint16:
-        length = 2;
-        break;
-    case Zigbee::Uint24:
-        length = 3;
-        break;
-    case Zigbee::Uint32:
-        length = 4;
-        break;
-    case Zigbee::Uint40:
-        length = 5;
-        break;
-    case Zigbee::Uint48:
-        length = 6;
-        break;
-    case Zigbee::Uint56:
-        length = 7;
-        break;
-    case Zigbee::Uint64:
-        length = 8;
-        break;
-    case Zigbee::Int8:
-        length = 1;
-        break;
-    case Zigbee::Int16:
-        length = 2;
-        break;
-    case Zigbee::Int24:
-        length = 3;
-        break;
-    case Zigbee::Int32:
-        length = 4;
-        break;
-    case Zigbee::Int40:
-        length = 5;
-        break;
-    case Zigbee::Int48:
-        length = 6;
-        break;
-    case Zigbee::Int56:
-        length = 7;
-        break;
-    case Zigbee::Int64:
-        length = 8;
-        break;
-    case Zigbee::Enum8:
-        length = 1;
-        break;
-    case Zigbee::Enum16:
-        length = 2;
-        break;
-    case Zigbee::FloatSemi:
-        length = 2;
-        break;
-    case Zigbee::FloatSingle:
-        length = 4;
-        break;
-    case Zigbee::FloatDouble:
-        length = 8;
-        break;
-    case Zigbee::OctetString:
-        // first byte is length
-        length = -1;
-        break;
-    case Zigbee::CharString:
-        // first byte is length
-        length = -1;
-        break;
-    case Zigbee::LongOctetString:
-        // first 2 byte is length
-        length = -2;
-        break;
-    case Zigbee::LongCharString:
-        // first 2 byte is length
-        length = -2;
-        break;
-    case Zigbee::Array:
-        // 2 + sum of lengths of content
-        length = -3;
-        break;
-    case Zigbee::Structure:
-        // 2 + sum of lengths of content
-        length = -3;
-        break;
-    case Zigbee::Set:
-        // sum of lengths of content
-        length = -4;
-        break;
-    case Zigbee::Bag:
-        // sum of lengths of content
-        length = -4;
-        break;
-    case Zigbee::TimeOfDay:
-        length = 4;
-        break;
-    case Zigbee::Date:
-        length = 4;
-        break;
-    case Zigbee::UtcTime:
-        length = 4;
-        break;
-    case Zigbee::Cluster:
-        length = 2;
-        break;
-    case Zigbee::Attribute:
-        length = 2;
-        break;
-    case Zigbee::BacnetId:
-        length = 4;
-        break;
-    case Zigbee::IeeeAddress:
-        length = 8;
-        break;
-    case Zigbee::BitKey128:
-        length = 16;
-        break;
-    case Zigbee::Unknown:
-        break;
-    }
-
-    return length;
+    return s_dataTypeInfos[static_cast<quint8>(dataType)].length;
 }
 
 ZigbeeDataType &ZigbeeDataType::operator=(const ZigbeeDataType &other)
 {
-    setDataType(other.dataType());
-    m_data = other.data();
+    m_dataType = other.m_dataType;
+    m_inlineSize = other.m_inlineSize;
+    m_null = other.m_null;
+    m_data = other.m_data;
+    memcpy(m_inlineData, other.m_inlineData, m_inlineSize);
     return *this;
 }
 
 bool ZigbeeDataType::operator==(const ZigbeeDataType &other) const
 {
-    return m_dataType == other.dataType() && m_data == other.data();
+    return m_dataType == other.m_dataType && size() == other.size() && memcmp(constData(), other.constData(), size()) == 0;
 }
 
 bool ZigbeeDataType::operator!=(const ZigbeeDataType &other) const
@@ -876,289 +604,54 @@ bool ZigbeeDataType::operator!=(const ZigbeeDataType &other) const
     return !operator==(other);
 }
 
-void ZigbeeDataType::setDataType(Zigbee::DataType dataType)
+int ZigbeeDataType::size() const
 {
-    m_dataType = dataType;
+    return m_data.isNull() ? m_inlineSize : m_data.size();
+}
 
-    switch (dataType) {
-    case Zigbee::NoData:
-        m_name = "No data";
-        m_className = "Null";
-        m_typeLength = typeLength(m_dataType);
-        m_data.clear();
-        break;
-    case Zigbee::Data8:
-        m_name = "8-bit data";
-        m_className = "General data discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Data16:
-        m_name = "16-bit data";
-        m_className = "General data discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Data24:
-        m_name = "24-bit data";
-        m_className = "General data discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Data32:
-        m_name = "32-bit data";
-        m_className = "General data discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Data40:
-        m_name = "40-bit data";
-        m_className = "General data discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Data48:
-        m_name = "48-bit data";
-        m_className = "General data discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Data56:
-        m_name = "56-bit data";
-        m_className = "General data discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Data64:
-        m_name = "64-bit data";
-        m_className = "General data discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Bool:
-        m_name = "Bool";
-        m_className = "Logical discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::BitMap8:
-        m_name = "8-bit bitmap";
-        m_className = "Bitmap discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::BitMap16:
-        m_name = "16-bit bitmap";
-        m_className = "Bitmap discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::BitMap24:
-        m_name = "24-bit bitmap";
-        m_className = "Bitmap discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::BitMap32:
-        m_name = "32-bit bitmap";
-        m_className = "Bitmap discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::BitMap40:
-        m_name = "40-bit bitmap";
-        m_className = "Bitmap discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::BitMap48:
-        m_name = "48-bit bitmap";
-        m_className = "Bitmap discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::BitMap56:
-        m_name = "56-bit bitmap";
-        m_className = "Bitmap discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::BitMap64:
-        m_name = "64-bit bitmap";
-        m_className = "Bitmap discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Uint8:
-        m_name = "Unsigned 8-bit integer";
-        m_className = "Unsigned integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Uint16:
-        m_name = "Unsigned 16-bit integer";
-        m_className = "Unsigned integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Uint24:
-        m_name = "Unsigned 24-bit integer";
-        m_className = "Unsigned integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Uint32:
-        m_name = "Unsigned 32-bit integer";
-        m_className = "Unsigned integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Uint40:
-        m_name = "Unsigned 40-bit integer";
-        m_className = "Unsigned integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Uint48:
-        m_name = "Unsigned 48-bit integer";
-        m_className = "Unsigned integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Uint56:
-        m_name = "Unsigned 56-bit integer";
-        m_className = "Unsigned integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Uint64:
-        m_name = "Unsigned 64-bit integer";
-        m_className = "Unsigned integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Int8:
-        m_name = "Signed 8-bit integer";
-        m_className = "Signed integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Int16:
-        m_name = "Signed 16-bit integer";
-        m_className = "Signed integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Int24:
-        m_name = "Signed 24-bit integer";
-        m_className = "Signed integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Int32:
-        m_name = "Signed 32-bit integer";
-        m_className = "Signed integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Int40:
-        m_name = "Signed 40-bit integer";
-        m_className = "Signed integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Int48:
-        m_name = "Signed 48-bit integer";
-        m_className = "Signed integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Int56:
-        m_name = "Signed 56-bit integer";
-        m_className = "Signed integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Int64:
-        m_name = "Signed 64-bit integer";
-        m_className = "Signed integer analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Enum8:
-        m_name = "8-bit enumeration";
-        m_className = "Enumeration discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Enum16:
-        m_name = "16-bit enumeration";
-        m_className = "Enumeration discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::FloatSemi:
-        m_name = "Semi-precision";
-        m_className = "Floating point analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::FloatSingle:
-        m_name = "Single precision";
-        m_className = "Floating point analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::FloatDouble:
-        m_name = "Double precision";
-        m_className = "Floating point analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::OctetString:
-        m_name = "Octet string";
-        m_className = "String discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::CharString:
-        m_name = "Character string";
-        m_className = "String discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::LongOctetString:
-        m_name = "Long octet string";
-        m_className = "String discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::LongCharString:
-        m_name = "Long character string";
-        m_className = "String discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Array:
-        m_name = "Array";
-        m_className = "Ordered sequence discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Structure:
-        m_name = "Structure";
-        m_className = "Ordered sequence discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Set:
-        m_name = "Set";
-        m_className = "Collection discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Bag:
-        m_name = "Bag";
-        m_className = "Collection discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::TimeOfDay:
-        m_name = "Time of day";
-        m_className = "Time analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Date:
-        m_name = "Date";
-        m_className = "Time analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::UtcTime:
-        m_name = "UTC time";
-        m_className = "Time analog";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Cluster:
-        m_name = "Cluster ID";
-        m_className = "Identifier discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Attribute:
-        m_name = "Attribute ID";
-        m_className = "Identifier discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::BacnetId:
-        m_name = "BACnet OID";
-        m_className = "Identifier discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::IeeeAddress:
-        m_name = "IEEE address";
-        m_className = "Miscellaneous discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::BitKey128:
-        m_name = "128-bit security key";
-        m_className = "Miscellaneous discrete";
-        m_typeLength = typeLength(m_dataType);
-        break;
-    case Zigbee::Unknown:
-        break;
+const char *ZigbeeDataType::constData() const
+{
+    return m_data.isNull() ? m_inlineData : m_data.constData();
+}
+
+char ZigbeeDataType::byteAt(int index) const
+{
+    Q_ASSERT_X(index >= 0 && index < size(), "ZigbeeDataType", "index out of range");
+    return constData()[index];
+}
+
+void ZigbeeDataType::setData(const char *data, int size, bool null)
+{
+    m_null = null;
+    if (size <= InlineCapacity) {
+        m_inlineSize = static_cast<quint8>(size);
+        if (size > 0)
+            memcpy(m_inlineData, data, size);
+
+        m_data = QByteArray();
+    } else {
+        m_inlineSize = 0;
+        m_data = QByteArray(data, size);
+    }
+}
+
+quint64 ZigbeeDataType::littleEndianValue(int length) const
+{
+    quint64 value = 0;
+    const char *data = constData();
+    for (int i = length - 1; i >= 0; i--) {
+        value = (value << 8) | static_cast<quint8>(data[i]);
+    }
+    return value;
+}
+
+void ZigbeeDataType::setLittleEndianValue(quint64 value, int length)
+{
+    m_null = false;
+    m_inlineSize = static_cast<quint8>(length);
+    m_data = QByteArray();
+    for (int i = 0; i < length; i++) {
+        m_inlineData[i] = static_cast<char>((value >> (8 * i)) & 0xff);
     }
 }
 
@@ -37,6 +37,7 @@ public:
     ZigbeeDataType();
     ZigbeeDataType(const ZigbeeDataType &other);
     ZigbeeDataType(Zigbee::DataType dataType, const QByteArray &data = QByteArray());
+    ZigbeeDataType(Zigbee::DataType dataType, const char *data, int size);
 
     // From uint
     ZigbeeDataType(quint8 value);
@@ -87,13 +88,22 @@ public:
     bool operator!=(const ZigbeeDataType &other) const;
 
 private:
+    // Values up to 8 bytes are stored inline, only longer values like strings use m_data
+    static const int InlineCapacity = 8;
+
     Zigbee::DataType m_dataType = Zigbee::NoData;
+    quint8 m_inlineSize = 0;
+    bool m_null = true;
+    char m_inlineData[InlineCapacity];
     QByteArray m_data;
-    QString m_name = "Unknown";
-    QString m_className = "Null";
-    int m_typeLength = 0;
 
-    void setDataType(Zigbee::DataType dataType);
+    int size() const;
+    const char *constData() const;
+    char byteAt(int index) const;
+    void setData(const char *data, int size, bool null);
+
+    quint64 littleEndianValue(int length) const;
+    void setLittleEndianValue(quint64 value, int length);
 };
 
 QDebug operator<<(QDebug debug, const ZigbeeDataType &dataType);
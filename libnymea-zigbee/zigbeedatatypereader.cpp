@@ -0,0 +1,202 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright 2013 - 2020, nymea GmbH
+* Contact: contact@nymea.io
+*
+* This file is part of nymea-zigbee.
+* This project including source code and documentation is protected by copyright law, and
+* remains the property of nymea GmbH. All rights, including reproduction, publication,
+* editing and translation, are reserved. The use of this project is subject to the terms of a
+* license agreement to be concluded with nymea GmbH in accordance with the terms
+* of use of nymea GmbH, available under https://nymea.io/license
+*
+* GNU Lesser General Public License Usage
+* Alternatively, this project may be redistributed and/or modified under the terms of the GNU
+* Lesser General Public License as published by the Free Software Foundation; version 3.
+* this project is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License along with this project.
+* If not, see <https://www.gnu.org/licenses/>.
+*
+* For any further details and any questions please contact us under contact@nymea.io
+* or see our FAQ/Licensing Information on https://nymea.io/license/faq
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "zigbeedatatypereader.h"
+
+// Nested arrays and structures deeper than this are not supported
+static const int s_maxNestingDepth = 8;
+
+ZigbeeDataTypeReader::ZigbeeDataTypeReader(const QByteArray &data) :
+    m_data(data)
+{
+
+}
+
+int ZigbeeDataTypeReader::position() const
+{
+    return m_position;
+}
+
+int ZigbeeDataTypeReader::remaining() const
+{
+    return m_data.length() - m_position;
+}
+
+bool ZigbeeDataTypeReader::atEnd() const
+{
+    return m_position >= m_data.length();
+}
+
+bool ZigbeeDataTypeReader::truncated() const
+{
+    return m_truncated;
+}
+
+bool ZigbeeDataTypeReader::readUInt8(quint8 *value)
+{
+    if (remaining() < 1) {
+        m_truncated = true;
+        return false;
+    }
+
+    *value = static_cast<quint8>(m_data.at(m_position));
+    m_position += 1;
+    return true;
+}
+
+bool ZigbeeDataTypeReader::readUInt16(quint16 *value)
+{
+    if (remaining() < 2) {
+        m_truncated = true;
+        return false;
+    }
+
+    *value = uint16At(m_position);
+    m_position += 2;
+    return true;
+}
+
+bool ZigbeeDataTypeReader::readDataType(Zigbee::DataType dataType, ZigbeeDataType *value)
+{
+    int length = encodedLength(dataType, m_position);
+    if (length == EncodedLengthTruncated) {
+        m_truncated = true;
+        return false;
+    }
+
+    if (length == EncodedLengthUnknown)
+        return false;
+
+    // Collections with 0xffff elements are marked as invalid and carry no value
+    bool invalidCollection = false;
+    if (dataType == Zigbee::Structure) {
+        invalidCollection = uint16At(m_position) == 0xffff;
+    } else if (dataType == Zigbee::Array || dataType == Zigbee::Set || dataType == Zigbee::Bag) {
+        invalidCollection = uint16At(m_position + 1) == 0xffff;
+    }
+
+    if (invalidCollection) {
+        *value = ZigbeeDataType(dataType);
+    } else {
+        *value = ZigbeeDataType(dataType, m_data.constData() + m_position, length);
+    }
+
+    m_position += length;
+    return true;
+}
+
+quint16 ZigbeeDataTypeReader::uint16At(int position) const
+{
+    return static_cast<quint16>(static_cast<quint8>(m_data.at(position)) | (static_cast<quint8>(m_data.at(position + 1)) << 8));
+}
+
+int ZigbeeDataTypeReader::encodedLength(Zigbee::DataType dataType, int position, int depth) const
+{
+    int available = m_data.length() - position;
+    int typeLength = ZigbeeDataType::typeLength(dataType);
+    if (typeLength > 0)
+        return typeLength <= available ? typeLength : EncodedLengthTruncated;
+
+    if (depth > s_maxNestingDepth)
+        return EncodedLengthUnknown;
+
+    switch (dataType) {
+    case Zigbee::OctetString:
+    case Zigbee::CharString: {
+        if (available < 1)
+            return EncodedLengthTruncated;
+
+        // Note: 0xff marks an invalid string without content
+        quint8 stringLength = static_cast<quint8>(m_data.at(position));
+        int length = 1 + (stringLength == 0xff ? 0 : stringLength);
+        return length <= available ? length : EncodedLengthTruncated;
+    }
+    case Zigbee::LongOctetString:
+    case Zigbee::LongCharString: {
+        if (available < 2)
+            return EncodedLengthTruncated;
+
+        quint16 stringLength = uint16At(position);
+        int length = 2 + (stringLength == 0xffff ? 0 : stringLength);
+        return length <= available ? length : EncodedLengthTruncated;
+    }
+    case Zigbee::Array:
+    case Zigbee::Set:
+    case Zigbee::Bag: {
+        // Element type, number of elements and the elements
+        if (available < 3)
+            return EncodedLengthTruncated;
+
+        Zigbee::DataType elementType = static_cast<Zigbee::DataType>(static_cast<quint8>(m_data.at(position)));
+        quint16 numberOfElements = uint16At(position + 1);
+        if (numberOfElements == 0xffff)
+            return 3;
+
+        int elementLength = ZigbeeDataType::typeLength(elementType);
+        if (elementLength > 0) {
+            int length = 3 + numberOfElements * elementLength;
+            return length <= available ? length : EncodedLengthTruncated;
+        }
+
+        int length = 3;
+        for (int i = 0; i < numberOfElements; i++) {
+            elementLength = encodedLength(elementType, position + length, depth + 1);
+            if (elementLength < 0)
+                return elementLength;
+
+            length += elementLength;
+        }
+        return length;
+    }
+    case Zigbee::Structure: {
+        // Number of elements, each element with its type and value
+        if (available < 2)
+            return EncodedLengthTruncated;
+
+        quint16 numberOfElements = uint16At(position);
+        if (numberOfElements == 0xffff)
+            return 2;
+
+        int length = 2;
+        for (int i = 0; i < numberOfElements; i++) {
+            if (length >= available)
+                return EncodedLengthTruncated;
+
+            Zigbee::DataType elementType = static_cast<Zigbee::DataType>(static_cast<quint8>(m_data.at(position + length)));
+            length += 1;
+            int elementLength = encodedLength(elementType, position + length, depth + 1);
+            if (elementLength < 0)
+                return elementLength;
+
+            length += elementLength;
+        }
+        return length;
+    }
+    default:
+        return EncodedLengthUnknown;
+    }
+}
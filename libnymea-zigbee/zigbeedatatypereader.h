@@ -0,0 +1,72 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright 2013 - 2020, nymea GmbH
+* Contact: contact@nymea.io
+*
+* This file is part of nymea-zigbee.
+* This project including source code and documentation is protected by copyright law, and
+* remains the property of nymea GmbH. All rights, including reproduction, publication,
+* editing and translation, are reserved. The use of this project is subject to the terms of a
+* license agreement to be concluded with nymea GmbH in accordance with the terms
+* of use of nymea GmbH, available under https://nymea.io/license
+*
+* GNU Lesser General Public License Usage
+* Alternatively, this project may be redistributed and/or modified under the terms of the GNU
+* Lesser General Public License as published by the Free Software Foundation; version 3.
+* this project is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License along with this project.
+* If not, see <https://www.gnu.org/licenses/>.
+*
+* For any further details and any questions please contact us under contact@nymea.io
+* or see our FAQ/Licensing Information on https://nymea.io/license/faq
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ZIGBEEDATATYPEREADER_H
+#define ZIGBEEDATATYPEREADER_H
+
+#include <QByteArray>
+
+#include "zigbee.h"
+#include "zigbeedatatype.h"
+
+// Bounds checked reader for ZCL encoded values. The length of a value gets determined from
+// the type before reading, so the value can be sliced from the data at once. Reading past
+// the end fails and marks the reader as truncated instead of returning zeros.
+
+class ZigbeeDataTypeReader
+{
+public:
+    explicit ZigbeeDataTypeReader(const QByteArray &data);
+
+    int position() const;
+    int remaining() const;
+    bool atEnd() const;
+
+    bool truncated() const;
+
+    bool readUInt8(quint8 *value);
+    bool readUInt16(quint16 *value);
+
+    // Returns false if the data is truncated or the length of the type is unknown
+    bool readDataType(Zigbee::DataType dataType, ZigbeeDataType *value);
+
+private:
+    enum EncodedLength {
+        EncodedLengthTruncated = -1,
+        EncodedLengthUnknown = -2
+    };
+
+    QByteArray m_data;
+    int m_position = 0;
+    bool m_truncated = false;
+
+    quint16 uint16At(int position) const;
+    int encodedLength(Zigbee::DataType dataType, int position, int depth = 0) const;
+
+};
+
+#endif // ZIGBEEDATATYPEREADER_H
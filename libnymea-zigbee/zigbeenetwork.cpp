@@ -35,6 +35,17 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QDataStream>
+#include <algorithm>
+
+static QString interviewTemplateKey(quint16 manufacturerCode, const QString &modelName, const QString &version)
+{
+    return QString("%1:%2:%3").arg(manufacturerCode).arg(modelName).arg(version);
+}
+
+static QString interviewTemplateKey(const ZigbeeNodeInterviewTemplate &interviewTemplate)
+{
+    return interviewTemplateKey(interviewTemplate.manufacturerCode, interviewTemplate.modelName, interviewTemplate.version);
+}
 
 ZigbeeNetwork::ZigbeeNetwork(const QUuid &networkUuid, QObject *parent) :
     QObject(parent),
@@ -58,6 +69,15 @@ ZigbeeNetwork::ZigbeeNetwork(const QUuid &networkUuid, QObject *parent) :
     m_reachableRefreshTimer->setSingleShot(false);
     connect(m_reachableRefreshTimer, &QTimer::timeout, this, &ZigbeeNetwork::evaluateNodeReachableStates);
 
+    m_reachableProbeTimer = new QTimer(this);
+    m_reachableProbeTimer->setInterval(250);
+    m_reachableProbeTimer->setSingleShot(true);
+    connect(m_reachableProbeTimer, &QTimer::timeout, this, &ZigbeeNetwork::evaluateNextNodeReachableState);
+
+    m_broadcastTimer = new QTimer(this);
+    m_broadcastTimer->setSingleShot(true);
+    connect(m_broadcastTimer, &QTimer::timeout, this, &ZigbeeNetwork::sendPendingBroadcasts);
+
     connect(this, &ZigbeeNetwork::stateChanged, this, [this](ZigbeeNetwork::State state){
         if (state == ZigbeeNetwork::StateRunning) {
             evaluateNodeReachableStates();
@@ -67,6 +87,9 @@ ZigbeeNetwork::ZigbeeNetwork(const QUuid &networkUuid, QObject *parent) :
                 node->setReachable(false);
             }
             m_reachableRefreshTimer->stop();
+            m_reachableProbeTimer->stop();
+            m_reachableRefreshAddresses.clear();
+            m_reachableSweepRunning = false;
         }
     });
 }
@@ -100,6 +123,148 @@ void ZigbeeNetwork::setSettingsDirectory(const QDir &settingsDirectory)
     bridgeController()->setSettingsDirectory(m_settingsDirectory);
 }
 
+int ZigbeeNetwork::databaseFlushInterval() const
+{
+    return m_databaseFlushInterval;
+}
+
+void ZigbeeNetwork::setDatabaseFlushInterval(int flushInterval)
+{
+    m_databaseFlushInterval = flushInterval;
+    if (m_database) {
+        m_database->setFlushInterval(m_databaseFlushInterval);
+    }
+}
+
+int ZigbeeNetwork::databaseMaxPendingWrites() const
+{
+    return m_databaseMaxPendingWrites;
+}
+
+void ZigbeeNetwork::setDatabaseMaxPendingWrites(int maxPendingWrites)
+{
+    m_databaseMaxPendingWrites = maxPendingWrites;
+    if (m_database) {
+        m_database->setMaxPendingWrites(m_databaseMaxPendingWrites);
+    }
+}
+
+int ZigbeeNetwork::reachabilityProbeConcurrency() const
+{
+    return m_reachabilityProbeConcurrency;
+}
+
+void ZigbeeNetwork::setReachabilityProbeConcurrency(int reachabilityProbeConcurrency)
+{
+    m_reachabilityProbeConcurrency = qMax(1, reachabilityProbeConcurrency);
+}
+
+int ZigbeeNetwork::reachabilityProbeInterval() const
+{
+    return m_reachableProbeTimer->interval();
+}
+
+void ZigbeeNetwork::setReachabilityProbeInterval(int reachabilityProbeInterval)
+{
+    m_reachableProbeTimer->setInterval(qMax(0, reachabilityProbeInterval));
+}
+
+ZigbeeNetwork::ReachabilityStatistics ZigbeeNetwork::reachabilityStatistics() const
+{
+    return m_reachabilityStatistics;
+}
+
+int ZigbeeNetwork::maxConcurrentInterviews() const
+{
+    return m_maxConcurrentInterviews;
+}
+
+void ZigbeeNetwork::setMaxConcurrentInterviews(int maxConcurrentInterviews)
+{
+    m_maxConcurrentInterviews = qMax(1, maxConcurrentInterviews);
+    admitNextInterviews();
+}
+
+int ZigbeeNetwork::interviewBacklog() const
+{
+    return m_pendingAnnouncements.count();
+}
+
+bool ZigbeeNetwork::interviewCacheEnabled() const
+{
+    return m_interviewCacheEnabled;
+}
+
+void ZigbeeNetwork::setInterviewCacheEnabled(bool interviewCacheEnabled)
+{
+    m_interviewCacheEnabled = interviewCacheEnabled;
+}
+
+int ZigbeeNetwork::lastSeenGranularity() const
+{
+    return m_lastSeenGranularity;
+}
+
+void ZigbeeNetwork::setLastSeenGranularity(int lastSeenGranularity)
+{
+    m_lastSeenGranularity = lastSeenGranularity;
+}
+
+int ZigbeeNetwork::broadcastRateLimit() const
+{
+    return m_broadcastRateLimit;
+}
+
+void ZigbeeNetwork::setBroadcastRateLimit(int broadcastRateLimit)
+{
+    m_broadcastRateLimit = qMax(1, broadcastRateLimit);
+    sendPendingBroadcasts();
+}
+
+int ZigbeeNetwork::broadcastRateWindow() const
+{
+    return m_broadcastRateWindow;
+}
+
+void ZigbeeNetwork::setBroadcastRateWindow(int broadcastRateWindow)
+{
+    m_broadcastRateWindow = qMax(0, broadcastRateWindow);
+    sendPendingBroadcasts();
+}
+
+int ZigbeeNetwork::broadcastBacklog() const
+{
+    return m_pendingBroadcasts.count();
+}
+
+bool ZigbeeNetwork::hasAttributeDeadband(ZigbeeClusterLibrary::ClusterId clusterId, quint16 attributeId) const
+{
+    return m_attributeDeadbands.contains(static_cast<quint32>(clusterId) << 16 | attributeId);
+}
+
+ZigbeeClusterAttributeDeadband ZigbeeNetwork::attributeDeadband(ZigbeeClusterLibrary::ClusterId clusterId, quint16 attributeId) const
+{
+    return m_attributeDeadbands.value(static_cast<quint32>(clusterId) << 16 | attributeId);
+}
+
+void ZigbeeNetwork::setAttributeDeadband(ZigbeeClusterLibrary::ClusterId clusterId, quint16 attributeId, double absoluteChange, double relativeChange)
+{
+    if (absoluteChange <= 0 && relativeChange <= 0) {
+        removeAttributeDeadband(clusterId, attributeId);
+        return;
+    }
+
+    ZigbeeClusterAttributeDeadband deadband;
+    deadband.absoluteChange = qMax(absoluteChange, 0.0);
+    deadband.relativeChange = qMax(relativeChange, 0.0);
+    m_attributeDeadbands.insert(static_cast<quint32>(clusterId) << 16 | attributeId, deadband);
+}
+
+void ZigbeeNetwork::removeAttributeDeadband(ZigbeeClusterLibrary::ClusterId clusterId, quint16 attributeId)
+{
+    m_attributeDeadbands.remove(static_cast<quint32>(clusterId) << 16 | attributeId);
+}
+
 QString ZigbeeNetwork::serialPortName() const
 {
     return m_serialPortName;
@@ -128,6 +293,20 @@ void ZigbeeNetwork::setSerialBaudrate(qint32 baudrate)
     emit serialBaudrateChanged(m_serialBaudrate);
 }
 
+bool ZigbeeNetwork::serialIoThreadEnabled() const
+{
+    return m_serialIoThreadEnabled;
+}
+
+void ZigbeeNetwork::setSerialIoThreadEnabled(bool serialIoThreadEnabled)
+{
+    if (m_serialIoThreadEnabled == serialIoThreadEnabled)
+        return;
+
+    m_serialIoThreadEnabled = serialIoThreadEnabled;
+    emit serialIoThreadEnabledChanged(m_serialIoThreadEnabled);
+}
+
 QString ZigbeeNetwork::serialNumber() const
 {
     return m_serialNumber;
@@ -248,9 +427,34 @@ quint8 ZigbeeNetwork::permitJoiningRemaining() const
 
 quint8 ZigbeeNetwork::generateSequenceNumber()
 {
+    // Skip the ids still in flight, a confirmation could not be matched any more otherwise
+    for (int i = 0; i < 256; i++) {
+        quint8 sequenceNumber = m_sequenceNumber++;
+        if (!m_requestIdsInFlight.contains(sequenceNumber)) {
+            return sequenceNumber;
+        }
+    }
+
+    qCWarning(dcZigbeeNetwork()) << "All request ids are in flight. The request will fail.";
     return m_sequenceNumber++;
 }
 
+ZigbeeNetworkReply *ZigbeeNetwork::sendRateLimitedRequest(const ZigbeeNetworkRequest &request)
+{
+    if (!isBroadcastRequest(request))
+        return sendRequest(request);
+
+    // Keep the order of the broadcasts, a new one may not overtake the waiting ones
+    if (m_pendingBroadcasts.isEmpty() && acquireBroadcastSlot())
+        return sendRequest(request);
+
+    PendingBroadcast pendingBroadcast;
+    pendingBroadcast.reply = createNetworkReply(request);
+    m_pendingBroadcasts.append(pendingBroadcast);
+    qCDebug(dcZigbeeNetwork()) << "Broadcast rate limit reached. Delaying" << request << "broadcasts waiting:" << m_pendingBroadcasts.count();
+    return pendingBroadcast.reply;
+}
+
 QList<ZigbeeNode *> ZigbeeNetwork::nodes() const
 {
     return m_nodes;
@@ -263,42 +467,12 @@ ZigbeeNode *ZigbeeNetwork::coordinatorNode() const
 
 ZigbeeNode *ZigbeeNetwork::getZigbeeNode(quint16 shortAddress) const
 {
-    foreach (ZigbeeNode *node, m_uninitializedNodes) {
-        if (node->shortAddress() == shortAddress) {
-            return node;
-        }
-    }
-
-    foreach (ZigbeeNode *node, m_nodes) {
-        if (node->shortAddress() == shortAddress) {
-            return node;
-        }
-    }
-
-    foreach (ZigbeeNode *node, m_temporaryNodes) {
-        if (node->shortAddress() == shortAddress) {
-            return node;
-        }
-    }
-
-    return nullptr;
+    return findIndexedNode(m_shortAddressIndex, shortAddress, NodeListTemporary);
 }
 
 ZigbeeNode *ZigbeeNetwork::getZigbeeNode(const ZigbeeAddress &address) const
 {
-    foreach (ZigbeeNode *node, m_uninitializedNodes) {
-        if (node->extendedAddress() == address) {
-            return node;
-        }
-    }
-
-    foreach (ZigbeeNode *node, m_nodes) {
-        if (node->extendedAddress() == address) {
-            return node;
-        }
-    }
-
-    return nullptr;
+    return findIndexedNode(m_ieeeAddressIndex, address.toUInt64(), NodeListInitialized);
 }
 
 bool ZigbeeNetwork::hasNode(quint16 shortAddress) const
@@ -378,6 +552,58 @@ void ZigbeeNetwork::printNetwork()
     }
 }
 
+void ZigbeeNetwork::indexNode(ZigbeeNode *node, NodeList list)
+{
+    NodeIndexEntry entry;
+    entry.node = node;
+    entry.list = list;
+    m_shortAddressIndex.insert(node->shortAddress(), entry);
+
+    // Note: temporary nodes are only known by their network address
+    if (list != NodeListTemporary) {
+        m_ieeeAddressIndex.insert(node->extendedAddress().toUInt64(), entry);
+    }
+}
+
+void ZigbeeNetwork::unindexNode(ZigbeeNode *node)
+{
+    QMultiHash<quint16, NodeIndexEntry>::iterator shortIt = m_shortAddressIndex.find(node->shortAddress());
+    while (shortIt != m_shortAddressIndex.end() && shortIt.key() == node->shortAddress()) {
+        if (shortIt.value().node == node) {
+            shortIt = m_shortAddressIndex.erase(shortIt);
+        } else {
+            ++shortIt;
+        }
+    }
+
+    QMultiHash<quint64, NodeIndexEntry>::iterator ieeeIt = m_ieeeAddressIndex.find(node->extendedAddress().toUInt64());
+    while (ieeeIt != m_ieeeAddressIndex.end() && ieeeIt.key() == node->extendedAddress().toUInt64()) {
+        if (ieeeIt.value().node == node) {
+            ieeeIt = m_ieeeAddressIndex.erase(ieeeIt);
+        } else {
+            ++ieeeIt;
+        }
+    }
+}
+
+template <typename Key>
+ZigbeeNode *ZigbeeNetwork::findIndexedNode(const QMultiHash<Key, NodeIndexEntry> &index, const Key &key, NodeList lastList) const
+{
+    ZigbeeNode *node = nullptr;
+    NodeList nodeList = lastList;
+    typename QMultiHash<Key, NodeIndexEntry>::const_iterator it = index.constFind(key);
+    while (it != index.constEnd() && it.key() == key) {
+        if (it.value().list <= nodeList) {
+            // On equal precedence the node added first wins, the hash iterates the most recent entry first
+            node = it.value().node;
+            nodeList = it.value().list;
+        }
+        ++it;
+    }
+
+    return node;
+}
+
 void ZigbeeNetwork::addNodeInternally(ZigbeeNode *node)
 {
     if (m_nodes.contains(node)) {
@@ -410,10 +636,11 @@ void ZigbeeNetwork::addNodeInternally(ZigbeeNode *node)
 
     // Note: if a cluster shows up after initialization (out of spec devices), save the cluster and it's attributes
     foreach (ZigbeeNodeEndpoint *endpoint, node->endpoints()) {
-        connect(endpoint, &ZigbeeNodeEndpoint::clusterAttributeChanged, this, &ZigbeeNetwork::onNodeClusterAttributeChanged);
+        connect(endpoint, &ZigbeeNodeEndpoint::clusterAttributeUpdated, this, &ZigbeeNetwork::onNodeClusterAttributeUpdated);
     }
 
     m_nodes.append(node);
+    indexNode(node, NodeListInitialized);
     emit nodeAdded(node);
 }
 
@@ -430,6 +657,8 @@ void ZigbeeNetwork::removeNodeInternally(ZigbeeNode *node)
 
     m_nodes.removeAll(node);
     m_uninitializedNodes.removeAll(node);
+    unindexNode(node);
+    m_transactionSequenceNumbers.remove(node->extendedAddress().toUInt64());
     emit nodeRemoved(node);
 
     m_database->removeNode(node);
@@ -441,6 +670,8 @@ void ZigbeeNetwork::initializeDatabase()
         QString networkDatabaseFileName = settingsDirectory().absolutePath() + QDir::separator() + QString("zigbee-network-%1.db").arg(networkUuid().toString().remove('{').remove('}'));
         qCDebug(dcZigbeeNetwork()) << "Using ZigBee network database" << QFileInfo(networkDatabaseFileName).fileName();
         m_database = new ZigbeeNetworkDatabase(this, networkDatabaseFileName, this);
+        m_database->setFlushInterval(m_databaseFlushInterval);
+        m_database->setMaxPendingWrites(m_databaseMaxPendingWrites);
     }
 }
 
@@ -458,31 +689,156 @@ ZigbeeNode *ZigbeeNetwork::createNode(quint16 shortAddress, const ZigbeeAddress
 
 void ZigbeeNetwork::evaluateNextNodeReachableState()
 {
-    if (m_reachableRefreshAddresses.isEmpty())
+    // Pace the probes in order to leave airtime for other requests
+    if (m_reachableProbeTimer->isActive())
         return;
 
-    ZigbeeNode *node = getZigbeeNode(m_reachableRefreshAddresses.takeFirst());
-    if (!node) {
-        // Not does not exit any more...continue
-        evaluateNextNodeReachableState();
+    while (!m_reachableRefreshAddresses.isEmpty() && m_reachableProbesInFlight < m_reachabilityProbeConcurrency) {
+        ZigbeeNode *node = getZigbeeNode(m_reachableRefreshAddresses.takeFirst());
+        if (!node) {
+            // Node does not exist any more...continue
+            continue;
+        }
+
+        // Traffic received from the node since the sweep started proofs it is reachable
+        if (node->reachable() && node->msecsSinceLastSeen() < m_reachableSweepTimer.elapsed()) {
+            qCDebug(dcZigbeeNetwork()) << node << "has been seen recently. Skipping reachable probe.";
+            m_reachabilityStatistics.probesSkipped++;
+            continue;
+        }
+
+        probeNodeReachableState(node);
+        m_reachableProbeTimer->start();
         return;
     }
 
-    // Make a lqi request in order to check if the node is reachable
+    if (m_reachableRefreshAddresses.isEmpty() && m_reachableProbesInFlight == 0) {
+        finishNodeReachableSweep();
+    }
+}
+
+void ZigbeeNetwork::probeNodeReachableState(ZigbeeNode *node)
+{
+    qCDebug(dcZigbeeNetwork()) << "Probe reachable state of" << node << "probes in flight:" << m_reachableProbesInFlight;
+    m_reachableProbesInFlight++;
+    m_reachabilityStatistics.lastSweepProbes++;
+
+    // Make a network address request in order to check if the node is reachable
     ZigbeeDeviceObjectReply *zdoReply = node->deviceObject()->requestNetworkAddress();
     connect(zdoReply, &ZigbeeDeviceObjectReply::finished, this, [=](){
         if (zdoReply->error()) {
             qCWarning(dcZigbeeNetwork()) << node << "seems not to be reachable" << zdoReply->error();
+            m_reachabilityStatistics.probesFailed++;
             setNodeReachable(node, false);
         } else {
+            m_reachabilityStatistics.probesSucceeded++;
             setNodeReachable(node, true);
         }
+    });
 
-        // Give some time for other requests to be processed
-        QTimer::singleShot(5000, this, &ZigbeeNetwork::evaluateNextNodeReachableState);
+    // The reply gets also destroyed if the node has been removed meanwhile
+    connect(zdoReply, &ZigbeeDeviceObjectReply::destroyed, this, [this](){
+        m_reachableProbesInFlight--;
+        evaluateNextNodeReachableState();
     });
 }
 
+void ZigbeeNetwork::finishNodeReachableSweep()
+{
+    if (!m_reachableSweepRunning)
+        return;
+
+    m_reachableSweepRunning = false;
+    m_reachabilityStatistics.sweeps++;
+    m_reachabilityStatistics.lastSweepDuration = m_reachableSweepTimer.elapsed();
+    qCDebug(dcZigbeeNetwork()) << "Evaluating reachable state of nodes finished after" << m_reachabilityStatistics.lastSweepDuration << "ms."
+                               << "Probes:" << m_reachabilityStatistics.lastSweepProbes
+                               << "succeeded:" << m_reachabilityStatistics.probesSucceeded
+                               << "failed:" << m_reachabilityStatistics.probesFailed
+                               << "skipped:" << m_reachabilityStatistics.probesSkipped;
+}
+
+bool ZigbeeNetwork::acquireTransactionSequenceNumber(quint64 destination, quint8 *transactionSequenceNumber)
+{
+    TransactionSequenceNumbers &numbers = m_transactionSequenceNumbers[destination];
+    if (numbers.inFlightCount >= 256) {
+        qCWarning(dcZigbeeNetwork()) << "All transaction sequence numbers for destination" << ZigbeeUtils::convertUint64ToHexString(destination) << "are in flight";
+        return false;
+    }
+
+    // Continue with the next free number, the previous ones may still be answered by the destination
+    while (numbers.inFlight[numbers.next >> 6] & (Q_UINT64_C(1) << (numbers.next & 0x3f)))
+        numbers.next++;
+
+    *transactionSequenceNumber = numbers.next++;
+    numbers.inFlight[*transactionSequenceNumber >> 6] |= Q_UINT64_C(1) << (*transactionSequenceNumber & 0x3f);
+    numbers.inFlightCount++;
+    return true;
+}
+
+void ZigbeeNetwork::releaseTransactionSequenceNumber(quint64 destination, quint8 transactionSequenceNumber)
+{
+    QHash<quint64, TransactionSequenceNumbers>::iterator it = m_transactionSequenceNumbers.find(destination);
+    if (it == m_transactionSequenceNumbers.end())
+        return;
+
+    quint64 mask = Q_UINT64_C(1) << (transactionSequenceNumber & 0x3f);
+    if (it->inFlight[transactionSequenceNumber >> 6] & mask) {
+        it->inFlight[transactionSequenceNumber >> 6] &= ~mask;
+        it->inFlightCount--;
+    }
+}
+
+bool ZigbeeNetwork::isBroadcastRequest(const ZigbeeNetworkRequest &request)
+{
+    if (request.destinationAddressMode() == Zigbee::DestinationAddressModeGroup)
+        return true;
+
+    // All addresses from 0xfff8 on are reserved for broadcasts
+    return request.destinationAddressMode() == Zigbee::DestinationAddressModeShortAddress && request.destinationShortAddress() >= 0xfff8;
+}
+
+bool ZigbeeNetwork::acquireBroadcastSlot()
+{
+    qint64 now = ZigbeeUtils::monotonicMilliseconds();
+    while (!m_broadcastTimestamps.isEmpty() && now - m_broadcastTimestamps.first() >= m_broadcastRateWindow)
+        m_broadcastTimestamps.removeFirst();
+
+    if (m_broadcastTimestamps.count() >= m_broadcastRateLimit) {
+        // Try again as soon as the oldest broadcast leaves the window
+        m_broadcastTimer->start(static_cast<int>(m_broadcastRateWindow - (now - m_broadcastTimestamps.first())));
+        return false;
+    }
+
+    m_broadcastTimestamps.append(now);
+    return true;
+}
+
+void ZigbeeNetwork::sendPendingBroadcasts()
+{
+    while (!m_pendingBroadcasts.isEmpty() && acquireBroadcastSlot()) {
+        PendingBroadcast pendingBroadcast = m_pendingBroadcasts.takeFirst();
+        ZigbeeNetworkReply *reply = pendingBroadcast.reply;
+        if (state() != StateRunning) {
+            finishNetworkReply(reply, ZigbeeNetworkReply::ErrorNetworkOffline);
+            continue;
+        }
+
+        // The id given while building the request might be in use by now, take a free one
+        reply->m_request.setRequestId(generateSequenceNumber());
+
+        // Hand the result of the sent request over to the reply returned to the caller
+        ZigbeeNetworkReply *networkReply = sendRequest(reply->request());
+        connect(networkReply, &ZigbeeNetworkReply::finished, reply, [reply, networkReply](){
+            reply->m_error = networkReply->error();
+            reply->m_zigbeeMacStatus = networkReply->zigbeeMacStatus();
+            reply->m_zigbeeNwkStatus = networkReply->zigbeeNwkStatus();
+            reply->m_zigbeeApsStatus = networkReply->zigbeeApsStatus();
+            emit reply->finished();
+        });
+    }
+}
+
 void ZigbeeNetwork::setPermitJoiningState(bool permitJoiningEnabled, quint8 duration)
 {
     if (permitJoiningEnabled) {
@@ -513,11 +869,7 @@ void ZigbeeNetwork::loadNetwork()
     }
 
     qCDebug(dcZigbeeNetwork()) << "Loading network from settings directory" << m_settingsDirectory.absolutePath();
-    if (!m_database) {
-        QString networkDatabaseFileName = m_settingsDirectory.absolutePath() + QDir::separator() + QString("zigbee-network-%1.db").arg(m_networkUuid.toString().remove('{').remove('}'));
-        qCDebug(dcZigbeeNetwork()) << "Using ZigBee network database" << QFileInfo(networkDatabaseFileName).fileName();
-        m_database = new ZigbeeNetworkDatabase(this, networkDatabaseFileName, this);
-    }
+    initializeDatabase();
 
     QList<ZigbeeNode *> nodes = m_database->loadNodes();
     foreach (ZigbeeNode *node, nodes) {
@@ -525,9 +877,65 @@ void ZigbeeNetwork::loadNetwork()
         addNodeInternally(node);
     }
 
+    foreach (const ZigbeeNodeInterviewTemplate &interviewTemplate, m_database->loadInterviewTemplates()) {
+        m_interviewTemplates.insert(interviewTemplateKey(interviewTemplate), interviewTemplate);
+    }
+
     m_networkLoaded = true;
 }
 
+bool ZigbeeNetwork::findInterviewTemplate(quint16 manufacturerCode, const QList<quint8> &endpoints, ZigbeeNodeInterviewTemplate *interviewTemplate) const
+{
+    // Devices report the endpoints in any order, compare them sorted
+    QList<quint8> sortedEndpoints = endpoints;
+    std::sort(sortedEndpoints.begin(), sortedEndpoints.end());
+    foreach (const ZigbeeNodeInterviewTemplate &candidate, m_interviewTemplates) {
+        if (candidate.manufacturerCode != manufacturerCode)
+            continue;
+
+        QList<quint8> candidateEndpoints = candidate.endpoints;
+        std::sort(candidateEndpoints.begin(), candidateEndpoints.end());
+        if (candidateEndpoints == sortedEndpoints) {
+            *interviewTemplate = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ZigbeeNetwork::findInterviewTemplate(quint16 manufacturerCode, const QString &modelName, const QString &version, ZigbeeNodeInterviewTemplate *interviewTemplate) const
+{
+    QString key = interviewTemplateKey(manufacturerCode, modelName, version);
+    if (!m_interviewTemplates.contains(key))
+        return false;
+
+    *interviewTemplate = m_interviewTemplates.value(key);
+    return true;
+}
+
+void ZigbeeNetwork::saveInterviewTemplate(const ZigbeeNodeInterviewTemplate &interviewTemplate)
+{
+    QString key = interviewTemplateKey(interviewTemplate);
+    if (m_interviewTemplates.contains(key))
+        return;
+
+    qCDebug(dcZigbeeNetwork()) << "Add interview template for" << interviewTemplate.manufacturerName << interviewTemplate.modelName << interviewTemplate.version;
+    m_interviewTemplates.insert(key, interviewTemplate);
+    if (m_database) {
+        m_database->saveInterviewTemplate(interviewTemplate);
+    }
+}
+
+void ZigbeeNetwork::removeInterviewTemplate(const ZigbeeNodeInterviewTemplate &interviewTemplate)
+{
+    qCDebug(dcZigbeeNetwork()) << "Remove interview template for" << interviewTemplate.manufacturerName << interviewTemplate.modelName << interviewTemplate.version;
+    m_interviewTemplates.remove(interviewTemplateKey(interviewTemplate));
+    if (m_database) {
+        m_database->removeInterviewTemplate(interviewTemplate);
+    }
+}
+
 void ZigbeeNetwork::clearSettings()
 {
     // Note: this clears the database
@@ -537,9 +945,12 @@ void ZigbeeNetwork::clearSettings()
     }
 
     qCDebug(dcZigbeeNetwork()) << "Clear all uninitialized nodes";
+    m_pendingAnnouncements.clear();
+    emit interviewBacklogChanged(0);
     foreach (ZigbeeNode *node, m_uninitializedNodes) {
         qCDebug(dcZigbeeNetwork()) << "Remove uninitialized" << node;
         m_uninitializedNodes.removeAll(node);
+        unindexNode(node);
         node->deleteLater();
     }
 
@@ -551,6 +962,7 @@ void ZigbeeNetwork::clearSettings()
         delete m_database;
         m_database = nullptr;
     }
+    m_interviewTemplates.clear();
 
     // Reset network configurations
     qCDebug(dcZigbeeNetwork()) << "Clear network properties";
@@ -565,13 +977,7 @@ void ZigbeeNetwork::clearSettings()
 
 bool ZigbeeNetwork::hasUninitializedNode(const ZigbeeAddress &address) const
 {
-    foreach (ZigbeeNode *node, m_uninitializedNodes) {
-        if (node->extendedAddress() == address) {
-            return true;
-        }
-    }
-
-    return false;
+    return findIndexedNode(m_ieeeAddressIndex, address.toUInt64(), NodeListUninitialized) != nullptr;
 }
 
 void ZigbeeNetwork::addNode(ZigbeeNode *node)
@@ -597,10 +1003,13 @@ void ZigbeeNetwork::addUnitializedNode(ZigbeeNode *node)
     connect(node, &ZigbeeNode::nodeInitializationFailed, this, [this, node](){
         qCWarning(dcZigbeeNetwork()) << "The initialization procedure for" << node << "failed. Please retry to add this node by restarting the init procedure.";
         m_uninitializedNodes.removeAll(node);
+        unindexNode(node);
         node->deleteLater();
+        admitNextInterviews();
     });
 
     m_uninitializedNodes.append(node);
+    indexNode(node, NodeListUninitialized);
     emit nodeJoined(node);
 }
 
@@ -615,7 +1024,9 @@ void ZigbeeNetwork::removeUninitializedNode(ZigbeeNode *node)
 {
     qCDebug(dcZigbeeNetwork()) << "Remove uninitialized node" << node;
     m_uninitializedNodes.removeAll(node);
+    unindexNode(node);
     node->deleteLater();
+    admitNextInterviews();
 }
 
 void ZigbeeNetwork::setNodeReachable(ZigbeeNode *node, bool reachable)
@@ -713,9 +1124,7 @@ void ZigbeeNetwork::handleZigbeeDeviceProfileIndication(const Zigbee::ApsdeDataI
 
 void ZigbeeNetwork::handleZigbeeClusterLibraryIndication(const Zigbee::ApsdeDataIndication &indication)
 {
-    ZigbeeClusterLibrary::Frame frame = ZigbeeClusterLibrary::parseFrameData(indication.asdu);
-    //qCDebug(dcZigbeeNetwork()) << "Handle ZCL indication" << indication << frame;
-
+    // Note: the frame gets parsed once by the node and handed down to the endpoint and cluster
     // Get the node
     ZigbeeNode *node = getZigbeeNode(indication.sourceShortAddress);
     if (!node) {
@@ -736,10 +1145,15 @@ void ZigbeeNetwork::onDeviceAnnounced(quint16 shortAddress, ZigbeeAddress ieeeAd
 {
     qCDebug(dcZigbeeNetwork()) << "Device announced" << ZigbeeUtils::convertUint16ToHexString(shortAddress) << ieeeAddress.toString() << ZigbeeUtils::convertByteToHexString(macCapabilities);
 
-    // Lets check if this device is in the uninitialized node list, if so, remove it and recreate the device
+    // Lets check if this device is in the uninitialized node list. If it announced with a new network address, remove it and recreate the device
     if (hasUninitializedNode(ieeeAddress)) {
-        qCWarning(dcZigbeeNetwork()) << "Device announced but there is already an initialization running for it. Remove the device and restart the initialization.";
         ZigbeeNode *uninitializedNode = getZigbeeNode(ieeeAddress);
+        if (uninitializedNode->shortAddress() == shortAddress) {
+            qCDebug(dcZigbeeNetwork()) << "Device announced again while the initialization is running. Continue with the running initialization.";
+            return;
+        }
+
+        qCWarning(dcZigbeeNetwork()) << "Device announced but there is already an initialization running for it. Remove the device and restart the initialization.";
         removeUninitializedNode(uninitializedNode);
     }
 
@@ -756,9 +1170,61 @@ void ZigbeeNetwork::onDeviceAnnounced(quint16 shortAddress, ZigbeeAddress ieeeAd
         }
     }
 
-    ZigbeeNode *node = createNode(shortAddress, ieeeAddress, macCapabilities, this);
-    addUnitializedNode(node);
-    node->startInitialization();
+    // Repeated announcements keep the position in the backlog
+    int pendingIndex = pendingAnnouncementIndex(ieeeAddress);
+    if (pendingIndex >= 0) {
+        qCDebug(dcZigbeeNetwork()) << "Device announced again while waiting for the initialization. Updating the pending announcement.";
+        m_pendingAnnouncements[pendingIndex].shortAddress = shortAddress;
+        m_pendingAnnouncements[pendingIndex].macCapabilities = macCapabilities;
+        return;
+    }
+
+    PendingAnnouncement announcement;
+    announcement.shortAddress = shortAddress;
+    announcement.ieeeAddress = ieeeAddress;
+    announcement.macCapabilities = macCapabilities;
+    m_pendingAnnouncements.append(announcement);
+    emit interviewBacklogChanged(m_pendingAnnouncements.count());
+
+    admitNextInterviews();
+}
+
+int ZigbeeNetwork::pendingAnnouncementIndex(quint16 shortAddress) const
+{
+    for (int i = 0; i < m_pendingAnnouncements.count(); i++) {
+        if (m_pendingAnnouncements.at(i).shortAddress == shortAddress) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+int ZigbeeNetwork::pendingAnnouncementIndex(const ZigbeeAddress &ieeeAddress) const
+{
+    for (int i = 0; i < m_pendingAnnouncements.count(); i++) {
+        if (m_pendingAnnouncements.at(i).ieeeAddress == ieeeAddress) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void ZigbeeNetwork::admitNextInterviews()
+{
+    int backlog = m_pendingAnnouncements.count();
+    while (!m_pendingAnnouncements.isEmpty() && m_uninitializedNodes.count() < m_maxConcurrentInterviews) {
+        PendingAnnouncement announcement = m_pendingAnnouncements.takeFirst();
+        ZigbeeNode *node = createNode(announcement.shortAddress, announcement.ieeeAddress, announcement.macCapabilities, this);
+        addUnitializedNode(node);
+        node->startInitialization();
+    }
+
+    if (backlog != m_pendingAnnouncements.count()) {
+        qCDebug(dcZigbeeNetwork()) << "Interviewing" << m_uninitializedNodes.count() << "nodes." << m_pendingAnnouncements.count() << "announced nodes are waiting for the initialization.";
+        emit interviewBacklogChanged(m_pendingAnnouncements.count());
+    }
 }
 
 void ZigbeeNetwork::verifyUnrecognizedNode(quint16 shortAddress)
@@ -769,8 +1235,15 @@ void ZigbeeNetwork::verifyUnrecognizedNode(quint16 shortAddress)
     //    Yes -> update the network address and save database
     //    No -> send management leave request to the node
 
+    // Announced nodes waiting for the initialization have no node yet, they must not be asked to leave
+    if (pendingAnnouncementIndex(shortAddress) >= 0) {
+        qCDebug(dcZigbeeNetwork()) << "Received a message from" << ZigbeeUtils::convertUint16ToHexString(shortAddress) << "which is waiting for the initialization. Ignoring message.";
+        return;
+    }
+
     ZigbeeNode *node = new ZigbeeNode(this, shortAddress, ZigbeeAddress(), this);
     m_temporaryNodes.append(node);
+    indexNode(node, NodeListTemporary);
 
     qCDebug(dcZigbeeNetwork()) << "Start verify process for unrecognized node" << node;
     qCDebug(dcZigbeeNetwork()) << "Request IEEE address from unrecognized node" << node;
@@ -778,6 +1251,14 @@ void ZigbeeNetwork::verifyUnrecognizedNode(quint16 shortAddress)
     connect(zdoReply, &ZigbeeDeviceObjectReply::finished, node, [=](){
         if (zdoReply->error() != ZigbeeDeviceObjectReply::ErrorNoError) {
             qCWarning(dcZigbeeNode()) << "Failed to request IEEE address from unrecognized" << node << zdoReply->error();
+            if (pendingAnnouncementIndex(shortAddress) >= 0) {
+                // The node announced meanwhile and is waiting for the initialization
+                m_temporaryNodes.removeAll(node);
+                unindexNode(node);
+                node->deleteLater();
+                return;
+            }
+
             // Remove and delete this temporary node since we did not know the IEEE address
             qCDebug(dcZigbeeNetwork()) << "Request unrecognized" << node << "to leave the newtork";
             ZigbeeDeviceObjectReply *zdoReply = node->deviceObject()->requestMgmtLeaveNetwork();
@@ -785,12 +1266,14 @@ void ZigbeeNetwork::verifyUnrecognizedNode(quint16 shortAddress)
                 if (zdoReply->error() != ZigbeeDeviceObjectReply::ErrorNoError) {
                     qCWarning(dcZigbeeNode()) << "Failed to request unrecognized node to leave the network" << node << zdoReply->error();
                     m_temporaryNodes.removeAll(node);
+                    unindexNode(node);
                     node->deleteLater();
                     return;
                 }
 
                 qCDebug(dcZigbeeNetwork()) << "Removed unrecognized node successfully from the network" << node;
                 m_temporaryNodes.removeAll(node);
+                unindexNode(node);
                 node->deleteLater();
             });
 
@@ -811,11 +1294,21 @@ void ZigbeeNetwork::verifyUnrecognizedNode(quint16 shortAddress)
             // We know this node with this IEEE address, let's update the network address and save the new address in the database
             qCDebug(dcZigbeeNetwork()) << "Found node for unrecognized network address with IEEE address" << ieeeAddress.toString() << "Updating the network address internally...";
             m_temporaryNodes.removeAll(node);
+            unindexNode(node);
             node->deleteLater();
 
             ZigbeeNode *existingNode = getZigbeeNode(ieeeAddress);
             updateNodeNetworkAddress(existingNode, shortAddress);
             return;
+        } else if (pendingAnnouncementIndex(ieeeAddress) >= 0) {
+            // The node is waiting for the initialization, continue with the new network address once admitted
+            qCDebug(dcZigbeeNetwork()) << "Unrecognized node" << ieeeAddress.toString() << "is waiting for the initialization. Updating the pending announcement.";
+            m_temporaryNodes.removeAll(node);
+            unindexNode(node);
+            node->deleteLater();
+
+            m_pendingAnnouncements[pendingAnnouncementIndex(ieeeAddress)].shortAddress = shortAddress;
+            return;
         } else {
             // We don't know any node with this ieeeAddress. Let's try to make it leave the network
             qCWarning(dcZigbeeNetwork()) << "Could not find any node with IEEE address" << ieeeAddress.toString() << "Requesting node to leave the network" << ZigbeeUtils::convertUint16ToHexString(shortAddress);
@@ -826,12 +1319,14 @@ void ZigbeeNetwork::verifyUnrecognizedNode(quint16 shortAddress)
                 if (zdoReply->error() != ZigbeeDeviceObjectReply::ErrorNoError) {
                     qCWarning(dcZigbeeNode()) << "Failed to request unrecognized node to leave the network" << node << zdoReply->error();
                     m_temporaryNodes.removeAll(node);
+                    unindexNode(node);
                     node->deleteLater();
                     return;
                 }
 
                 qCDebug(dcZigbeeNetwork()) << "Removed unrecognized node successfully from the network" << node;
                 m_temporaryNodes.removeAll(node);
+                unindexNode(node);
                 node->deleteLater();
             });
         }
@@ -841,7 +1336,16 @@ void ZigbeeNetwork::verifyUnrecognizedNode(quint16 shortAddress)
 void ZigbeeNetwork::updateNodeNetworkAddress(ZigbeeNode *node, quint16 shortAddress)
 {
     qCDebug(dcZigbeeNetwork()) << "Network address of" << node << "has changed to" << ZigbeeUtils::convertUint16ToHexString(shortAddress);
+    NodeList list = NodeListInitialized;
+    foreach (const NodeIndexEntry &entry, m_shortAddressIndex.values(node->shortAddress())) {
+        if (entry.node == node) {
+            list = entry.list;
+        }
+    }
+
+    unindexNode(node);
     node->m_shortAddress = shortAddress;
+    indexNode(node, list);
     emit node->shortAddressChanged(shortAddress);
 
     m_database->updateNodeNetworkAddress(node, shortAddress);
@@ -851,11 +1355,42 @@ void ZigbeeNetwork::updateNodeNetworkAddress(ZigbeeNode *node, quint16 shortAddr
 ZigbeeNetworkReply *ZigbeeNetwork::createNetworkReply(const ZigbeeNetworkRequest &request)
 {
     ZigbeeNetworkReply *reply = new ZigbeeNetworkReply(request, this);
+    if (reply->m_request.handle() == 0)
+        reply->m_request.setHandle(++m_requestHandle);
+
     // Make sure the reply will be deleted
     connect(reply, &ZigbeeNetworkReply::finished, reply, &ZigbeeNetworkReply::deleteLater, Qt::QueuedConnection);
     return reply;
 }
 
+bool ZigbeeNetwork::reserveRequestId(ZigbeeNetworkReply *reply)
+{
+    quint8 requestId = reply->request().requestId();
+    quint64 handle = reply->request().handle();
+    if (m_requestIdsInFlight.contains(requestId)) {
+        if (m_requestIdsInFlight.count() >= 256) {
+            qCWarning(dcZigbeeNetwork()) << "Cannot send" << reply->request() << "All request ids are in flight.";
+        } else {
+            qCWarning(dcZigbeeNetwork()) << "Cannot send" << reply->request() << "The request id is still in flight for request handle" << m_requestIdsInFlight.value(requestId);
+        }
+
+        // Finish from the event loop, the caller did not connect to the reply yet
+        QTimer::singleShot(0, reply, [this, reply](){
+            finishNetworkReply(reply, ZigbeeNetworkReply::ErrorRequestIdUnavailable);
+        });
+        return false;
+    }
+
+    m_requestIdsInFlight.insert(requestId, handle);
+    connect(reply, &ZigbeeNetworkReply::finished, this, [this, requestId, handle](){
+        if (m_requestIdsInFlight.value(requestId) == handle) {
+            m_requestIdsInFlight.remove(requestId);
+        }
+    });
+
+    return true;
+}
+
 void ZigbeeNetwork::setReplyResponseError(ZigbeeNetworkReply *reply, quint8 zigbeeStatus)
 {
     if (zigbeeStatus == Zigbee::ZigbeeApsStatusSuccess) {
@@ -898,7 +1433,7 @@ void ZigbeeNetwork::finishNetworkReply(ZigbeeNetworkReply *reply, ZigbeeNetworkR
     }
 
     // Stop the timer
-    reply->m_timer->stop();
+    reply->m_timer.stop();
 
     // Finish the reply
     reply->finished();
@@ -906,7 +1441,7 @@ void ZigbeeNetwork::finishNetworkReply(ZigbeeNetworkReply *reply, ZigbeeNetworkR
 
 void ZigbeeNetwork::startWaitingReply(ZigbeeNetworkReply *reply)
 {
-    reply->m_timer->start();
+    reply->m_timer.start();
 }
 
 void ZigbeeNetwork::onNodeStateChanged(ZigbeeNode::State state)
@@ -914,21 +1449,36 @@ void ZigbeeNetwork::onNodeStateChanged(ZigbeeNode::State state)
     ZigbeeNode *node = qobject_cast<ZigbeeNode *>(sender());
     if (state == ZigbeeNode::StateInitialized && m_uninitializedNodes.contains(node)) {
         m_uninitializedNodes.removeAll(node);
+        unindexNode(node);
         // Disconnect this slot since we don't need it any more
         disconnect(node, &ZigbeeNode::stateChanged, this, &ZigbeeNetwork::onNodeStateChanged);
         addNode(node);
+        admitNextInterviews();
     }
 }
 
-void ZigbeeNetwork::onNodeClusterAttributeChanged(ZigbeeCluster *cluster, const ZigbeeClusterAttribute &attribute)
+void ZigbeeNetwork::onNodeClusterAttributeUpdated(ZigbeeCluster *cluster, const ZigbeeClusterAttribute &attribute, bool valueChanged)
 {
+    // The stored value is up to date already
+    if (!valueChanged)
+        return;
+
     m_database->saveAttribute(cluster, attribute);
 }
 
 void ZigbeeNetwork::evaluateNodeReachableStates()
 {
+    if (m_reachableSweepRunning) {
+        qCDebug(dcZigbeeNetwork()) << "Evaluating reachable state of nodes is still running. Skipping this interval.";
+        return;
+    }
+
     qCDebug(dcZigbeeNetwork()) << "Evaluate reachable state of nodes";
     m_reachableRefreshAddresses.clear();
+    m_reachableSweepRunning = true;
+    m_reachableSweepTimer.start();
+    m_reachabilityStatistics.lastSweepProbes = 0;
+    QList<ZigbeeNode *> staleNodes;
 
     foreach (ZigbeeNode *node, m_nodes) {
         // Skip the coordinator
@@ -940,23 +1490,23 @@ void ZigbeeNetwork::evaluateNodeReachableStates()
             // Lets send a request to all things which are not reachable
             if (!node->reachable()) {
                 qCDebug(dcZigbeeNetwork()) << node << "enqueue evaluating reachable state";
-                m_reachableRefreshAddresses.append(node->extendedAddress());
+                staleNodes.append(node);
                 continue;
             }
 
             // Lets send a request to nodes which have not been seen more than 10 min
-            int msSinceLastSeen = node->lastSeen().msecsTo(QDateTime::currentDateTimeUtc());
-            qCDebug(dcZigbeeNetwork()) << node << "has been seen the last time" << QTime::fromMSecsSinceStartOfDay(msSinceLastSeen).toString() << "ago.";
+            qint64 msSinceLastSeen = node->msecsSinceLastSeen();
+            qCDebug(dcZigbeeNetwork()) << node << "has been seen the last time" << QTime::fromMSecsSinceStartOfDay(static_cast<int>(msSinceLastSeen)).toString() << "ago.";
             // 10 min = 10 * 60 * 1000 = 600000 ms
             if (msSinceLastSeen > 600000) {
                 qCDebug(dcZigbeeNetwork()) << node << "enqueue evaluating reachable state";
-                m_reachableRefreshAddresses.append(node->extendedAddress());
+                staleNodes.append(node);
             }
         } else {
             // Note: sleeping devices should send some message within 6 hours,
             // otherwise the device might not be reachable any more
-            int msSinceLastSeen = node->lastSeen().msecsTo(QDateTime::currentDateTimeUtc());
-            qCDebug(dcZigbeeNetwork()) << node << "has been seen the last time" << QTime::fromMSecsSinceStartOfDay(msSinceLastSeen).toString() << "ago.";
+            qint64 msSinceLastSeen = node->msecsSinceLastSeen();
+            qCDebug(dcZigbeeNetwork()) << node << "has been seen the last time" << QTime::fromMSecsSinceStartOfDay(static_cast<int>(msSinceLastSeen)).toString() << "ago.";
             // 6 Hours = 6 * 60 * 60 * 1000 = 21600000 ms
             if (msSinceLastSeen < 21600000) {
                 setNodeReachable(node, true);
@@ -966,6 +1516,18 @@ void ZigbeeNetwork::evaluateNodeReachableStates()
         }
     }
 
+    // Probe the unreachable nodes first, then the ones not seen for the longest time
+    std::sort(staleNodes.begin(), staleNodes.end(), [](ZigbeeNode *a, ZigbeeNode *b){
+        if (a->reachable() != b->reachable())
+            return !a->reachable();
+
+        return a->msecsSinceLastSeen() > b->msecsSinceLastSeen();
+    });
+
+    foreach (ZigbeeNode *node, staleNodes) {
+        m_reachableRefreshAddresses.append(node->extendedAddress());
+    }
+
     evaluateNextNodeReachableState();
 }
 
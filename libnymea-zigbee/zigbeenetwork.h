@@ -30,8 +30,10 @@
 
 #include <QDir>
 #include <QUuid>
+#include <QMultiHash>
 #include <QObject>
 #include <QSettings>
+#include <QElapsedTimer>
 
 #include "zigbeenode.h"
 #include "zigbeechannelmask.h"
@@ -44,6 +46,9 @@ class ZigbeeNetwork : public QObject
 {
     Q_OBJECT
 
+    friend class ZigbeeNode;
+    friend class ZigbeeCluster;
+
 public:
     enum State {
         StateUninitialized,
@@ -63,6 +68,15 @@ public:
     };
     Q_ENUM(Error)
 
+    typedef struct ReachabilityStatistics {
+        quint32 sweeps = 0;
+        qint64 lastSweepDuration = 0;
+        quint32 lastSweepProbes = 0;
+        quint32 probesSucceeded = 0;
+        quint32 probesFailed = 0;
+        quint32 probesSkipped = 0;
+    } ReachabilityStatistics;
+
     explicit ZigbeeNetwork(const QUuid &networkUuid, QObject *parent = nullptr);
 
     QUuid networkUuid() const;
@@ -74,6 +88,53 @@ public:
     QDir settingsDirectory() const;
     void setSettingsDirectory(const QDir &settingsDirectory);
 
+    // Write behind configuration of the network database
+    int databaseFlushInterval() const;
+    void setDatabaseFlushInterval(int flushInterval);
+
+    int databaseMaxPendingWrites() const;
+    void setDatabaseMaxPendingWrites(int maxPendingWrites);
+
+    // Reachability probes of mains powered nodes, the interval is the minimum time
+    // in milliseconds between sending two probes in order to limit the used airtime
+    int reachabilityProbeConcurrency() const;
+    void setReachabilityProbeConcurrency(int reachabilityProbeConcurrency);
+
+    int reachabilityProbeInterval() const;
+    void setReachabilityProbeInterval(int reachabilityProbeInterval);
+
+    ReachabilityStatistics reachabilityStatistics() const;
+
+    // Maximum number of nodes interviewed at the same time, further announced nodes wait in the backlog
+    int maxConcurrentInterviews() const;
+    void setMaxConcurrentInterviews(int maxConcurrentInterviews);
+
+    int interviewBacklog() const;
+
+    // Initialize joining nodes of already known device models from the interview results of the first one
+    bool interviewCacheEnabled() const;
+    void setInterviewCacheEnabled(bool interviewCacheEnabled);
+
+    // Minimum time in milliseconds between two lastSeenChanged notifications of a node
+    int lastSeenGranularity() const;
+    void setLastSeenGranularity(int lastSeenGranularity);
+
+    // Broadcasts and groupcasts occupy an entry in the broadcast transaction table of every router,
+    // at most broadcastRateLimit of them are sent within the broadcast rate window in milliseconds
+    int broadcastRateLimit() const;
+    void setBroadcastRateLimit(int broadcastRateLimit);
+
+    int broadcastRateWindow() const;
+    void setBroadcastRateWindow(int broadcastRateWindow);
+
+    int broadcastBacklog() const;
+
+    // Attribute reports changing a numeric value less than the deadband are not considered as attribute change
+    bool hasAttributeDeadband(ZigbeeClusterLibrary::ClusterId clusterId, quint16 attributeId) const;
+    ZigbeeClusterAttributeDeadband attributeDeadband(ZigbeeClusterLibrary::ClusterId clusterId, quint16 attributeId) const;
+    void setAttributeDeadband(ZigbeeClusterLibrary::ClusterId clusterId, quint16 attributeId, double absoluteChange, double relativeChange = 0);
+    void removeAttributeDeadband(ZigbeeClusterLibrary::ClusterId clusterId, quint16 attributeId);
+
     virtual ZigbeeBridgeController *bridgeController() const = 0;
     virtual Zigbee::ZigbeeBackendType backendType() const = 0;
 
@@ -84,6 +145,10 @@ public:
     qint32 serialBaudrate() const;
     void setSerialBaudrate(qint32 baudrate);
 
+    // Run the serial port reading, frame decoding and writing in a dedicated thread
+    bool serialIoThreadEnabled() const;
+    void setSerialIoThreadEnabled(bool serialIoThreadEnabled);
+
     QString serialNumber() const;
     void setSerialNumber(const QString &serialNumber);
 
@@ -128,6 +193,9 @@ public:
 
     virtual ZigbeeNetworkReply *sendRequest(const ZigbeeNetworkRequest &request) = 0;
 
+    // Delays broadcasts and groupcasts exceeding the broadcast rate limit, other requests are sent right away
+    ZigbeeNetworkReply *sendRateLimitedRequest(const ZigbeeNetworkRequest &request);
+
     void loadNetwork();
 
     void removeZigbeeNode(const ZigbeeAddress &address);
@@ -140,13 +208,69 @@ private:
     QString m_serialPortName = "/dev/ttyUSB0";
     QString m_serialNumber;
     qint32 m_serialBaudrate = 115200;
+    bool m_serialIoThreadEnabled = false;
     ZigbeeAddress m_macAddress;
 
     ZigbeeNetworkDatabase *m_database = nullptr;
+    int m_databaseFlushInterval = 5000;
+    int m_databaseMaxPendingWrites = 200;
     bool m_networkLoaded = false;
 
-    // Continuous ASP sequence number for network requests
+    int m_lastSeenGranularity = 60000;
+
+    // Announced nodes waiting for an interview slot, ordered by announce time
+    typedef struct PendingAnnouncement {
+        quint16 shortAddress = 0;
+        ZigbeeAddress ieeeAddress;
+        quint8 macCapabilities = 0;
+    } PendingAnnouncement;
+
+    int m_maxConcurrentInterviews = 4;
+    QList<PendingAnnouncement> m_pendingAnnouncements;
+    int pendingAnnouncementIndex(quint16 shortAddress) const;
+    int pendingAnnouncementIndex(const ZigbeeAddress &ieeeAddress) const;
+    void admitNextInterviews();
+
+    // Interview templates by manufacturer code, model and version
+    bool m_interviewCacheEnabled = true;
+    QHash<QString, ZigbeeNodeInterviewTemplate> m_interviewTemplates;
+    bool findInterviewTemplate(quint16 manufacturerCode, const QList<quint8> &endpoints, ZigbeeNodeInterviewTemplate *interviewTemplate) const;
+    bool findInterviewTemplate(quint16 manufacturerCode, const QString &modelName, const QString &version, ZigbeeNodeInterviewTemplate *interviewTemplate) const;
+    void saveInterviewTemplate(const ZigbeeNodeInterviewTemplate &interviewTemplate);
+    void removeInterviewTemplate(const ZigbeeNodeInterviewTemplate &interviewTemplate);
+
+    // Broadcasts waiting for the rate limit and the send times of the broadcasts within the current window
+    typedef struct PendingBroadcast {
+        ZigbeeNetworkReply *reply = nullptr;
+    } PendingBroadcast;
+
+    int m_broadcastRateLimit = 8;
+    int m_broadcastRateWindow = 9000;
+    QTimer *m_broadcastTimer = nullptr;
+    QList<qint64> m_broadcastTimestamps;
+    QList<PendingBroadcast> m_pendingBroadcasts;
+    static bool isBroadcastRequest(const ZigbeeNetworkRequest &request);
+    bool acquireBroadcastSlot();
+    void sendPendingBroadcasts();
+
+    // ZCL transaction sequence numbers per destination, a number stays reserved until its transaction finished
+    typedef struct TransactionSequenceNumbers {
+        quint8 next = 1;
+        int inFlightCount = 0;
+        quint64 inFlight[4] = {0, 0, 0, 0};
+    } TransactionSequenceNumbers;
+
+    QHash<quint64, TransactionSequenceNumbers> m_transactionSequenceNumbers;
+    bool acquireTransactionSequenceNumber(quint64 destination, quint8 *transactionSequenceNumber);
+    void releaseTransactionSequenceNumber(quint64 destination, quint8 transactionSequenceNumber);
+
+    // Attribute deadbands, the key contains the cluster id in the upper and the attribute id in the lower 16 bit
+    QHash<quint32, ZigbeeClusterAttributeDeadband> m_attributeDeadbands;
+
+    // Continuous ASP sequence number for network requests, the ids in flight map to the handle of their request
     quint8 m_sequenceNumber = 0;
+    quint64 m_requestHandle = 0;
+    QHash<quint8, quint64> m_requestIdsInFlight;
 
     // Network configurations
     quint16 m_panId = 0;
@@ -170,6 +294,28 @@ private:
     quint8 m_permitJoiningRemaining = 0;
 
 private:
+    // Lifecycle list of a node, the order defines the lookup precedence
+    enum NodeList {
+        NodeListUninitialized,
+        NodeListInitialized,
+        NodeListTemporary
+    };
+
+    typedef struct NodeIndexEntry {
+        ZigbeeNode *node = nullptr;
+        NodeList list = NodeListInitialized;
+    } NodeIndexEntry;
+
+    // Node lookup indexes, kept in sync with m_uninitializedNodes, m_nodes and m_temporaryNodes
+    QMultiHash<quint16, NodeIndexEntry> m_shortAddressIndex;
+    QMultiHash<quint64, NodeIndexEntry> m_ieeeAddressIndex;
+
+    void indexNode(ZigbeeNode *node, NodeList list);
+    void unindexNode(ZigbeeNode *node);
+    // Returns the node with the highest precedence, considering only the lists up to lastList
+    template <typename Key>
+    ZigbeeNode *findIndexedNode(const QMultiHash<Key, NodeIndexEntry> &index, const Key &key, NodeList lastList) const;
+
     void addNodeInternally(ZigbeeNode *node);
     void removeNodeInternally(ZigbeeNode *node);
 
@@ -184,8 +330,16 @@ protected:
     ZigbeeNode *createNode(quint16 shortAddress, const ZigbeeAddress &extendedAddress, quint8 macCapabilities, QObject *parent);
 
     QTimer *m_reachableRefreshTimer = nullptr;
+    QTimer *m_reachableProbeTimer = nullptr;
     QList<ZigbeeAddress> m_reachableRefreshAddresses;
+    int m_reachabilityProbeConcurrency = 4;
+    int m_reachableProbesInFlight = 0;
+    bool m_reachableSweepRunning = false;
+    QElapsedTimer m_reachableSweepTimer;
+    ReachabilityStatistics m_reachabilityStatistics;
     void evaluateNextNodeReachableState();
+    void probeNodeReachableState(ZigbeeNode *node);
+    void finishNodeReachableSweep();
 
     void setPermitJoiningState(bool permitJoiningEnabled, quint8 duration = 0);
 
@@ -224,6 +378,8 @@ protected:
 
     // Network reply methods
     ZigbeeNetworkReply *createNetworkReply(const ZigbeeNetworkRequest &request = ZigbeeNetworkRequest());
+    // Keeps the request id in flight until the reply finished, fails the reply if the id is taken already
+    bool reserveRequestId(ZigbeeNetworkReply *reply);
     void setReplyResponseError(ZigbeeNetworkReply *reply, quint8 zigbeeStatus = Zigbee::ZigbeeApsStatusSuccess);
     void finishNetworkReply(ZigbeeNetworkReply *reply, ZigbeeNetworkReply::Error error = ZigbeeNetworkReply::ErrorNoError);
     void startWaitingReply(ZigbeeNetworkReply *reply);
@@ -232,6 +388,7 @@ signals:
     void settingsDirectoryChanged(const QDir &settingsDirectory);
     void serialPortNameChanged(const QString &serialPortName);
     void serialBaudrateChanged(qint32 serialBaudrate);
+    void serialIoThreadEnabledChanged(bool serialIoThreadEnabled);
     void macAddressChanged(const ZigbeeAddress &macAddress);
     void firmwareVersionChanged(const QString &firmwareVersion);
 
@@ -252,12 +409,14 @@ signals:
     void permitJoinDurationChanged(quint8 duration);
     void permitJoinRemainingChanged(quint8 remaining);
 
+    void interviewBacklogChanged(int interviewBacklog);
+
     void errorOccured(Error error);
     void stateChanged(State state);
 
 private slots:
     void onNodeStateChanged(ZigbeeNode::State state);
-    void onNodeClusterAttributeChanged(ZigbeeCluster *cluster, const ZigbeeClusterAttribute &attribute);
+    void onNodeClusterAttributeUpdated(ZigbeeCluster *cluster, const ZigbeeClusterAttribute &attribute, bool valueChanged);
     void evaluateNodeReachableStates();
 
 public slots:
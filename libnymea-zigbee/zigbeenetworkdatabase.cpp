@@ -33,12 +33,23 @@
 
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <algorithm>
 
 ZigbeeNetworkDatabase::ZigbeeNetworkDatabase(ZigbeeNetwork *network, const QString &databaseName, QObject *parent) :
     QObject(parent),
     m_network(network),
     m_databaseName(databaseName)
 {
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &ZigbeeNetworkDatabase::flush);
+
+    // Make sure pending updates end up on disk even if the network never gets deleted
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &ZigbeeNetworkDatabase::flush);
+    }
+
     m_connectionName = QFileInfo(m_databaseName).baseName();
     m_db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), m_connectionName);
     m_db.setDatabaseName(m_databaseName);
@@ -59,6 +70,9 @@ ZigbeeNetworkDatabase::ZigbeeNetworkDatabase(ZigbeeNetwork *network, const QStri
 
 ZigbeeNetworkDatabase::~ZigbeeNetworkDatabase()
 {
+    flush();
+    m_preparedQueries.clear();
+    m_rowIds.clear();
     m_db.close();
     m_db = QSqlDatabase();
     QSqlDatabase::removeDatabase(m_connectionName);
@@ -69,19 +83,122 @@ QString ZigbeeNetworkDatabase::databaseName() const
     return m_databaseName;
 }
 
+int ZigbeeNetworkDatabase::flushInterval() const
+{
+    return m_flushInterval;
+}
+
+void ZigbeeNetworkDatabase::setFlushInterval(int flushInterval)
+{
+    m_flushInterval = flushInterval;
+    if (m_flushTimer.isActive()) {
+        m_flushTimer.stop();
+        scheduleFlush();
+    }
+}
+
+int ZigbeeNetworkDatabase::maxPendingWrites() const
+{
+    return m_maxPendingWrites;
+}
+
+void ZigbeeNetworkDatabase::setMaxPendingWrites(int maxPendingWrites)
+{
+    m_maxPendingWrites = maxPendingWrites;
+    if (pendingWrites() > 0) {
+        scheduleFlush();
+    }
+}
+
+int ZigbeeNetworkDatabase::pendingWrites() const
+{
+    return m_pendingNodeUpdates.count() + m_pendingAttributeUpdates.count();
+}
+
+bool ZigbeeNetworkDatabase::flush()
+{
+    m_flushTimer.stop();
+    if (pendingWrites() == 0)
+        return true;
+
+    if (!m_db.isOpen()) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not flush" << pendingWrites() << "pending updates. The database is not open.";
+        scheduleFlushRetry();
+        return false;
+    }
+
+    qCDebug(dcZigbeeNetworkDatabase()) << "Flush" << pendingWrites() << "pending updates into" << m_db.databaseName();
+    bool transactionStarted = m_db.transaction();
+    if (!transactionStarted) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not start transaction for flushing pending updates. Writing them one by one." << m_db.lastError().databaseText() << m_db.lastError().driverText();
+    }
+
+    bool success = true;
+    foreach (const QString &ieeeAddress, m_pendingNodeUpdates.keys()) {
+        PendingNodeUpdate update = m_pendingNodeUpdates.value(ieeeAddress);
+        if (update.lqiPending) {
+            QSqlQuery query = preparedQuery("UPDATE nodes SET lqi = :lqi WHERE ieeeAddress = :ieeeAddress;");
+            query.bindValue(":lqi", update.lqi);
+            query.bindValue(":ieeeAddress", ieeeAddress);
+            if (!query.exec()) {
+                qCWarning(dcZigbeeNetworkDatabase()) << "Could not update node LQI value in the database." << ieeeAddress << query.lastError().databaseText() << query.lastError().driverText();
+                success = false;
+            }
+        }
+
+        if (update.lastSeenPending) {
+            QSqlQuery query = preparedQuery("UPDATE nodes SET timestamp = :timestamp WHERE ieeeAddress = :ieeeAddress;");
+            query.bindValue(":timestamp", update.timestamp);
+            query.bindValue(":ieeeAddress", ieeeAddress);
+            if (!query.exec()) {
+                qCWarning(dcZigbeeNetworkDatabase()) << "Could not update node timestamp value in the database." << ieeeAddress << query.lastError().databaseText() << query.lastError().driverText();
+                success = false;
+            }
+        }
+    }
+
+    foreach (const PendingAttributeUpdate &update, m_pendingAttributeUpdates) {
+        if (!writeAttribute(update)) {
+            success = false;
+        }
+    }
+
+    if (transactionStarted && !m_db.commit()) {
+        // The rollback discards the whole batch, keep the pending updates for the next attempt
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not commit pending updates into the database." << m_db.lastError().databaseText() << m_db.lastError().driverText();
+        m_db.rollback();
+        scheduleFlushRetry();
+        return false;
+    }
+
+    m_pendingNodeUpdates.clear();
+    m_pendingAttributeUpdates.clear();
+    return success;
+}
+
 QList<ZigbeeNode *> ZigbeeNetworkDatabase::loadNodes()
 {
     qCDebug(dcZigbeeNetworkDatabase()) << "Loading nodes from database" << m_db.databaseName();
+    QElapsedTimer loadingTimer;
+    loadingTimer.start();
+
+    // Note: each table gets read once in one pass and the rows are joined using the row ids
     QList<ZigbeeNode *> nodes;
-    QString query("SELECT * FROM nodes;");
-    QSqlQuery nodesQuery = m_db.exec(query);
+    QHash<QString, ZigbeeNode *> nodesByAddress;
+    QSqlQuery nodesQuery(m_db);
+    nodesQuery.setForwardOnly(true);
+    if (!nodesQuery.exec("SELECT ieeeAddress, shortAddress, nodeDescriptor, powerDescriptor, lqi, timestamp FROM nodes ORDER BY rowid;")) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not fetch nodes from database." << nodesQuery.lastError().databaseText() << nodesQuery.lastError().driverText();
+        return nodes;
+    }
+
     while (nodesQuery.next()) {
-        QString ieeeAddress = nodesQuery.value("ieeeAddress").toString();
-        quint16 shortAddress = nodesQuery.value("shortAddress").toUInt();
-        QByteArray nodeDescriptor = QByteArray::fromBase64(nodesQuery.value("nodeDescriptor").toByteArray());
-        quint16 powerDescriptor = nodesQuery.value("powerDescriptor").toUInt();
-        quint8 lqi = nodesQuery.value("lqi").toUInt();
-        quint64 lastSeen = nodesQuery.value("timestamp").toULongLong();
+        QString ieeeAddress = nodesQuery.value(0).toString();
+        quint16 shortAddress = nodesQuery.value(1).toUInt();
+        QByteArray nodeDescriptor = QByteArray::fromBase64(nodesQuery.value(2).toByteArray());
+        quint16 powerDescriptor = nodesQuery.value(3).toUInt();
+        quint8 lqi = nodesQuery.value(4).toUInt();
+        quint64 lastSeen = nodesQuery.value(5).toULongLong();
 
         // Build the node object
         ZigbeeNode *node = new ZigbeeNode(m_network, shortAddress, ZigbeeAddress(ieeeAddress), m_network);
@@ -95,100 +212,183 @@ QList<ZigbeeNode *> ZigbeeNetworkDatabase::loadNodes()
             node->m_powerDescriptorAvailable = true;
         }
         node->m_lqi = lqi;
-        node->m_lastSeen = QDateTime::fromMSecsSinceEpoch(lastSeen * 1000);
+        node->setLastSeen(QDateTime::fromMSecsSinceEpoch(lastSeen * 1000));
 
         qCDebug(dcZigbeeNetworkDatabase()) << "Loaded" << node;
+        nodes.append(node);
+        nodesByAddress.insert(ieeeAddress, node);
+    }
 
-        // Now load all endpoints for this node
-        query = QString("SELECT * FROM endpoints WHERE ieeeAddress = \"%1\";").arg(ieeeAddress);
-        QSqlQuery endpointsQuery = m_db.exec(query);
-        while (endpointsQuery.next()) {
-            quint8 endpointId = endpointsQuery.value("endpointId").toUInt();
-            ZigbeeNodeEndpoint *endpoint = new ZigbeeNodeEndpoint(m_network, node, endpointId, node);
-            endpoint->setProfile(static_cast<Zigbee::ZigbeeProfile>(endpointsQuery.value("profileId").toUInt()));
-            endpoint->setDeviceId(static_cast<Zigbee::ZigbeeProfile>(endpointsQuery.value("deviceId").toUInt()));
-            endpoint->setDeviceVersion(static_cast<Zigbee::ZigbeeProfile>(endpointsQuery.value("deviceVersion").toUInt()));
-
-            qCDebug(dcZigbeeNetworkDatabase()) << "Loaded" << endpoint;
-
-            // Load input clusters for this endpoint
-            query = QString("SELECT * FROM serverClusters WHERE endpointId = (SELECT id FROM endpoints WHERE ieeeAddress = \"%1\" AND endpointId = \"%2\");")
-                    .arg(ieeeAddress)
-                    .arg(endpointId);
-            QSqlQuery inputClustersQuery = m_db.exec(query);
-            while (inputClustersQuery.next()) {
-                ZigbeeClusterLibrary::ClusterId clusterId = static_cast<ZigbeeClusterLibrary::ClusterId>(inputClustersQuery.value("clusterId").toUInt());
-                ZigbeeCluster *cluster = endpoint->createCluster(clusterId, ZigbeeCluster::Server);
-                endpoint->addInputCluster(cluster);
-
-                qCDebug(dcZigbeeNetworkDatabase()) << "Loaded" << cluster;
-
-                // Load cluster attributes for this server cluster
-                query = QString("SELECT * FROM attributes WHERE clusterId = (SELECT id FROM serverClusters WHERE endpointId = (SELECT id FROM endpoints WHERE ieeeAddress = \"%1\" AND endpointId = \"%2\") AND clusterId = \"%3\");")
-                        .arg(ieeeAddress)
-                        .arg(endpointId)
-                        .arg(cluster->clusterId());
-                QSqlQuery attributesQuery = m_db.exec(query);
-                if (m_db.lastError().type() != QSqlError::NoError) {
-                    qCWarning(dcZigbeeNetworkDatabase()) << "Could not fetch attributes from database entries." << query << m_db.lastError().databaseText() << m_db.lastError().driverText();
-                    continue;
-                }
-
-
-                while (attributesQuery.next()) {
-                    quint16 attributeId = attributesQuery.value("attributeId").toUInt();
-                    Zigbee::DataType type = static_cast<Zigbee::DataType>(attributesQuery.value("dataType").toUInt());
-                    QByteArray data = QByteArray::fromBase64(attributesQuery.value("data").toByteArray());
-                    ZigbeeClusterAttribute attribute(attributeId, ZigbeeDataType(type, data));
-                    qCDebug(dcZigbeeNetworkDatabase()) << "Loaded" << attribute;
-                    cluster->setAttribute(attribute);
-                }
-            }
+    // Load all endpoints
+    QList<ZigbeeNodeEndpoint *> endpoints;
+    QHash<qint64, ZigbeeNodeEndpoint *> endpointsById;
+    QSqlQuery endpointsQuery(m_db);
+    endpointsQuery.setForwardOnly(true);
+    if (!endpointsQuery.exec("SELECT id, ieeeAddress, endpointId, profileId, deviceId, deviceVersion FROM endpoints ORDER BY id;")) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not fetch endpoints from database." << endpointsQuery.lastError().databaseText() << endpointsQuery.lastError().driverText();
+    }
+
+    while (endpointsQuery.next()) {
+        qint64 id = endpointsQuery.value(0).toLongLong();
+        QString ieeeAddress = endpointsQuery.value(1).toString();
+        ZigbeeNode *node = nodesByAddress.value(ieeeAddress);
+        if (!node) {
+            qCWarning(dcZigbeeNetworkDatabase()) << "Skipping endpoint entry" << id << "without node" << ieeeAddress;
+            continue;
+        }
+
+        quint8 endpointId = endpointsQuery.value(2).toUInt();
+        ZigbeeNodeEndpoint *endpoint = new ZigbeeNodeEndpoint(m_network, node, endpointId, node);
+        endpoint->setProfile(static_cast<Zigbee::ZigbeeProfile>(endpointsQuery.value(3).toUInt()));
+        endpoint->setDeviceId(static_cast<Zigbee::ZigbeeProfile>(endpointsQuery.value(4).toUInt()));
+        endpoint->setDeviceVersion(static_cast<Zigbee::ZigbeeProfile>(endpointsQuery.value(5).toUInt()));
 
-            // Set the basic cluster attributes if present to endpoint and node
-            if (endpoint->hasInputCluster(ZigbeeClusterLibrary::ClusterIdBasic)) {
-                ZigbeeClusterBasic *basicCluster = endpoint->inputCluster<ZigbeeClusterBasic>(ZigbeeClusterLibrary::ClusterIdBasic);
+        qCDebug(dcZigbeeNetworkDatabase()) << "Loaded" << endpoint;
+        endpoints.append(endpoint);
+        endpointsById.insert(id, endpoint);
+        m_rowIds.insert(rowKey(RowTypeEndpoint, ieeeAddress, endpointId), id);
+    }
 
-                if (basicCluster->hasAttribute(ZigbeeClusterBasic::AttributeManufacturerName)) {
-                    endpoint->setManufacturerName(basicCluster->attribute(ZigbeeClusterBasic::AttributeManufacturerName).dataType().toString());
-                    node->m_manufacturerName = endpoint->manufacturerName();
-                }
+    // Load all input clusters
+    QHash<qint64, ZigbeeCluster *> serverClustersById;
+    QSqlQuery inputClustersQuery(m_db);
+    inputClustersQuery.setForwardOnly(true);
+    if (!inputClustersQuery.exec("SELECT id, endpointId, clusterId FROM serverClusters ORDER BY id;")) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not fetch server clusters from database." << inputClustersQuery.lastError().databaseText() << inputClustersQuery.lastError().driverText();
+    }
 
-                if (basicCluster->hasAttribute(ZigbeeClusterBasic::AttributeModelIdentifier)) {
-                    endpoint->setModelIdentifier(basicCluster->attribute(ZigbeeClusterBasic::AttributeModelIdentifier).dataType().toString());
-                    node->m_modelName = endpoint->modelIdentifier();
-                }
+    while (inputClustersQuery.next()) {
+        qint64 id = inputClustersQuery.value(0).toLongLong();
+        ZigbeeNodeEndpoint *endpoint = endpointsById.value(inputClustersQuery.value(1).toLongLong());
+        if (!endpoint)
+            continue;
+
+        ZigbeeClusterLibrary::ClusterId clusterId = static_cast<ZigbeeClusterLibrary::ClusterId>(inputClustersQuery.value(2).toUInt());
+        ZigbeeCluster *cluster = endpoint->createCluster(clusterId, ZigbeeCluster::Server);
+        endpoint->addInputCluster(cluster);
+
+        qCDebug(dcZigbeeNetworkDatabase()) << "Loaded" << cluster;
+        serverClustersById.insert(id, cluster);
+        m_rowIds.insert(rowKey(RowTypeServerCluster, endpoint->node()->extendedAddress().toString(), endpoint->endpointId(), static_cast<quint16>(clusterId)), id);
+    }
+
+    // Load all cluster attributes of the server clusters
+    QSqlQuery attributesQuery(m_db);
+    attributesQuery.setForwardOnly(true);
+    if (!attributesQuery.exec("SELECT clusterId, attributeId, dataType, data FROM attributes ORDER BY id;")) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not fetch attributes from database." << attributesQuery.lastError().databaseText() << attributesQuery.lastError().driverText();
+    }
+
+    while (attributesQuery.next()) {
+        ZigbeeCluster *cluster = serverClustersById.value(attributesQuery.value(0).toLongLong());
+        if (!cluster)
+            continue;
+
+        quint16 attributeId = attributesQuery.value(1).toUInt();
+        Zigbee::DataType type = static_cast<Zigbee::DataType>(attributesQuery.value(2).toUInt());
+        QByteArray data = QByteArray::fromBase64(attributesQuery.value(3).toByteArray());
+        ZigbeeClusterAttribute attribute(attributeId, ZigbeeDataType(type, data));
+        qCDebug(dcZigbeeNetworkDatabase()) << "Loaded" << attribute;
+        cluster->setAttribute(attribute);
+    }
+
+    // Load all output clusters
+    QSqlQuery outputClustersQuery(m_db);
+    outputClustersQuery.setForwardOnly(true);
+    if (!outputClustersQuery.exec("SELECT id, endpointId, clusterId FROM clientClusters ORDER BY id;")) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not fetch client clusters from database." << outputClustersQuery.lastError().databaseText() << outputClustersQuery.lastError().driverText();
+    }
 
-                if (basicCluster->hasAttribute(ZigbeeClusterBasic::AttributeSwBuildId)) {
-                    endpoint->setSoftwareBuildId(basicCluster->attribute(ZigbeeClusterBasic::AttributeSwBuildId).dataType().toString());
-                    node->m_version = endpoint->softwareBuildId();
-                }
+    while (outputClustersQuery.next()) {
+        qint64 id = outputClustersQuery.value(0).toLongLong();
+        ZigbeeNodeEndpoint *endpoint = endpointsById.value(outputClustersQuery.value(1).toLongLong());
+        if (!endpoint)
+            continue;
+
+        ZigbeeClusterLibrary::ClusterId clusterId = static_cast<ZigbeeClusterLibrary::ClusterId>(outputClustersQuery.value(2).toUInt());
+        ZigbeeCluster *cluster = endpoint->createCluster(clusterId, ZigbeeCluster::Client);
+        qCDebug(dcZigbeeNetworkDatabase()) << "Loaded" << cluster;
+        endpoint->addOutputCluster(cluster);
+        m_rowIds.insert(rowKey(RowTypeClientCluster, endpoint->node()->extendedAddress().toString(), endpoint->endpointId(), static_cast<quint16>(clusterId)), id);
+    }
+
+    // Now all clusters are complete, finish the endpoints
+    foreach (ZigbeeNodeEndpoint *endpoint, endpoints) {
+        ZigbeeNode *node = endpoint->node();
+
+        // Set the basic cluster attributes if present to endpoint and node
+        if (endpoint->hasInputCluster(ZigbeeClusterLibrary::ClusterIdBasic)) {
+            ZigbeeClusterBasic *basicCluster = endpoint->inputCluster<ZigbeeClusterBasic>(ZigbeeClusterLibrary::ClusterIdBasic);
+
+            if (basicCluster->hasAttribute(ZigbeeClusterBasic::AttributeManufacturerName)) {
+                endpoint->setManufacturerName(basicCluster->attribute(ZigbeeClusterBasic::AttributeManufacturerName).dataType().toString());
+                node->m_manufacturerName = endpoint->manufacturerName();
             }
 
-            // Load output clusters for this endpoint
-            query = QString("SELECT * FROM clientClusters WHERE endpointId = (SELECT id FROM endpoints WHERE ieeeAddress = \"%1\" AND endpointId = \"%2\");")
-                    .arg(ieeeAddress)
-                    .arg(endpointId);
-            QSqlQuery outputClustersQuery = m_db.exec(query);
-            while (outputClustersQuery.next()) {
-                ZigbeeClusterLibrary::ClusterId clusterId = static_cast<ZigbeeClusterLibrary::ClusterId>(outputClustersQuery.value("clusterId").toUInt());
-                ZigbeeCluster *cluster = endpoint->createCluster(clusterId, ZigbeeCluster::Client);
-                qCDebug(dcZigbeeNetworkDatabase()) << "Loaded" << cluster;
-                endpoint->addOutputCluster(cluster);
+            if (basicCluster->hasAttribute(ZigbeeClusterBasic::AttributeModelIdentifier)) {
+                endpoint->setModelIdentifier(basicCluster->attribute(ZigbeeClusterBasic::AttributeModelIdentifier).dataType().toString());
+                node->m_modelName = endpoint->modelIdentifier();
             }
 
-            node->m_endpoints.append(endpoint);
-            node->setupEndpointInternal(endpoint);
+            if (basicCluster->hasAttribute(ZigbeeClusterBasic::AttributeSwBuildId)) {
+                endpoint->setSoftwareBuildId(basicCluster->attribute(ZigbeeClusterBasic::AttributeSwBuildId).dataType().toString());
+                node->m_version = endpoint->softwareBuildId();
+            }
         }
-        nodes.append(node);
+
+        node->m_endpoints.append(endpoint);
+        node->setupEndpointInternal(endpoint);
     }
 
+    qCDebug(dcZigbeeNetworkDatabase()) << "Loaded" << nodes.count() << "nodes with" << endpoints.count() << "endpoints in" << loadingTimer.elapsed() << "ms";
     return nodes;
 }
 
+QList<ZigbeeNodeInterviewTemplate> ZigbeeNetworkDatabase::loadInterviewTemplates()
+{
+    QList<ZigbeeNodeInterviewTemplate> interviewTemplates;
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT manufacturerCode, manufacturerName, modelName, version, powerDescriptor, simpleDescriptors FROM interviewTemplates;")) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not fetch interview templates from database." << query.lastError().databaseText() << query.lastError().driverText();
+        return interviewTemplates;
+    }
+
+    while (query.next()) {
+        ZigbeeNodeInterviewTemplate interviewTemplate;
+        interviewTemplate.manufacturerCode = query.value(0).toUInt();
+        interviewTemplate.manufacturerName = query.value(1).toString();
+        interviewTemplate.modelName = query.value(2).toString();
+        interviewTemplate.version = query.value(3).toString();
+        interviewTemplate.powerDescriptor = query.value(4).toUInt();
+        foreach (const QString &simpleDescriptor, query.value(5).toString().split(',', QString::SkipEmptyParts)) {
+            QByteArray descriptor = QByteArray::fromBase64(simpleDescriptor.toLatin1());
+            // Length, endpoint id, ...
+            if (descriptor.size() < 2)
+                continue;
+
+            interviewTemplate.endpoints.append(static_cast<quint8>(descriptor.at(1)));
+            interviewTemplate.simpleDescriptors.append(descriptor);
+        }
+        // Templates are stored with sorted endpoints
+        std::sort(interviewTemplate.endpoints.begin(), interviewTemplate.endpoints.end());
+
+        interviewTemplates.append(interviewTemplate);
+    }
+
+    qCDebug(dcZigbeeNetworkDatabase()) << "Loaded" << interviewTemplates.count() << "interview templates";
+    return interviewTemplates;
+}
+
 bool ZigbeeNetworkDatabase::wipeDatabase()
 {
     qCDebug(dcZigbeeNetworkDatabase()) << "Wipe all database entries from" << m_db.databaseName();
+    m_flushTimer.stop();
+    m_pendingNodeUpdates.clear();
+    m_pendingAttributeUpdates.clear();
+    m_preparedQueries.clear();
+    m_rowIds.clear();
+
     // Note: cascade will clean all other tables
     m_db.exec("DELETE FROM nodes;");
     if (m_db.lastError().type() != QSqlError::NoError) {
@@ -221,6 +421,14 @@ bool ZigbeeNetworkDatabase::initDatabase()
     }
 
 
+    // Use write ahead logging, this way commits do not rewrite the database pages
+    // and a full sync is only required on checkpoints
+    m_db.exec("PRAGMA journal_mode = WAL;");
+    if (m_db.lastError().type() != QSqlError::NoError) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not enable write ahead logging." << m_db.lastError().databaseText() << m_db.lastError().driverText();
+    }
+    m_db.exec("PRAGMA synchronous = NORMAL;");
+
     // FIXME: check schema version fro compatibility or migration
 
     qCDebug(dcZigbeeNetworkDatabase()) << "Tables" << m_db.tables();
@@ -287,6 +495,18 @@ bool ZigbeeNetworkDatabase::initDatabase()
         createIndices("attributesIndex", "attributes", "clusterId, attributeId");
     }
 
+    // Create interview templates table
+    if (!m_db.tables().contains("interviewTemplates")) {
+        createTable("interviewTemplates",
+                    "(manufacturerCode INTEGER NOT NULL, " // uint16 from the node descriptor
+                    "manufacturerName TEXT NOT NULL, " // basic cluster manufacturer name
+                    "modelName TEXT NOT NULL, " // basic cluster model identifier
+                    "version TEXT NOT NULL, " // basic cluster software build id
+                    "powerDescriptor INTEGER NOT NULL, " // uint16
+                    "simpleDescriptors TEXT NOT NULL, " // comma separated base64 simple descriptors as received from the node
+                    "PRIMARY KEY(manufacturerCode, modelName, version))");
+    }
+
     return true;
 }
 
@@ -307,24 +527,187 @@ void ZigbeeNetworkDatabase::createIndices(const QString &indexName, const QStrin
     m_db.exec(QString("CREATE UNIQUE INDEX IF NOT EXISTS %1 ON %2(%3);").arg(indexName).arg(tableName).arg(columns));
 }
 
+void ZigbeeNetworkDatabase::scheduleFlush()
+{
+    if (m_flushInterval <= 0 || pendingWrites() >= m_maxPendingWrites) {
+        flush();
+        return;
+    }
+
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start(m_flushInterval);
+    }
+}
+
+void ZigbeeNetworkDatabase::scheduleFlushRetry()
+{
+    m_flushTimer.start(m_flushInterval > 0 ? m_flushInterval : 1000);
+}
+
+void ZigbeeNetworkDatabase::discardPendingWrites(const QString &ieeeAddress)
+{
+    m_pendingNodeUpdates.remove(ieeeAddress);
+
+    QMutableHashIterator<QPair<quint64, quint64>, PendingAttributeUpdate> iterator(m_pendingAttributeUpdates);
+    while (iterator.hasNext()) {
+        iterator.next();
+        if (iterator.value().ieeeAddress == ieeeAddress) {
+            iterator.remove();
+        }
+    }
+
+    if (pendingWrites() == 0) {
+        m_flushTimer.stop();
+    }
+}
+
+QSqlQuery ZigbeeNetworkDatabase::preparedQuery(const QString &statement)
+{
+    // Note: copies of a query share the prepared statement
+    QHash<QString, QSqlQuery>::const_iterator it = m_preparedQueries.constFind(statement);
+    if (it != m_preparedQueries.constEnd())
+        return it.value();
+
+    QSqlQuery query(m_db);
+    if (!query.prepare(statement)) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not prepare query" << statement << query.lastError().databaseText() << query.lastError().driverText();
+        return query;
+    }
+
+    m_preparedQueries.insert(statement, query);
+    return query;
+}
+
+ZigbeeNetworkDatabase::RowKey ZigbeeNetworkDatabase::rowKey(RowType rowType, const QString &ieeeAddress, quint8 endpointId, quint16 clusterId)
+{
+    return RowKey(ieeeAddress, (static_cast<quint32>(rowType) << 24) | (static_cast<quint32>(endpointId) << 16) | clusterId);
+}
+
+qint64 ZigbeeNetworkDatabase::rowId(RowType rowType, const QString &ieeeAddress, quint8 endpointId, quint16 clusterId)
+{
+    RowKey key = rowKey(rowType, ieeeAddress, endpointId, rowType == RowTypeEndpoint ? 0 : clusterId);
+    QHash<RowKey, qint64>::const_iterator it = m_rowIds.constFind(key);
+    if (it != m_rowIds.constEnd())
+        return it.value();
+
+    QSqlQuery query;
+    if (rowType == RowTypeEndpoint) {
+        query = preparedQuery("SELECT id FROM endpoints WHERE ieeeAddress = :ieeeAddress AND endpointId = :endpointId;");
+        query.bindValue(":ieeeAddress", ieeeAddress);
+        query.bindValue(":endpointId", endpointId);
+    } else {
+        qint64 endpointRowId = rowId(RowTypeEndpoint, ieeeAddress, endpointId);
+        if (endpointRowId < 0)
+            return -1;
+
+        QString tableName = rowType == RowTypeServerCluster ? "serverClusters" : "clientClusters";
+        query = preparedQuery(QString("SELECT id FROM %1 WHERE endpointId = :endpointId AND clusterId = :clusterId;").arg(tableName));
+        query.bindValue(":endpointId", endpointRowId);
+        query.bindValue(":clusterId", clusterId);
+    }
+
+    if (!query.exec()) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not look up row id in the database." << query.lastQuery() << query.lastError().databaseText() << query.lastError().driverText();
+        return -1;
+    }
+
+    qint64 id = -1;
+    if (query.next())
+        id = query.value(0).toLongLong();
+
+    query.finish();
+
+    if (id >= 0)
+        m_rowIds.insert(key, id);
+
+    return id;
+}
+
+void ZigbeeNetworkDatabase::removeRowIds(const QString &ieeeAddress)
+{
+    QMutableHashIterator<RowKey, qint64> iterator(m_rowIds);
+    while (iterator.hasNext()) {
+        iterator.next();
+        if (iterator.key().first == ieeeAddress) {
+            iterator.remove();
+        }
+    }
+}
+
+bool ZigbeeNetworkDatabase::writeAttribute(const PendingAttributeUpdate &update)
+{
+    qint64 clusterRowId = rowId(RowTypeServerCluster, update.ieeeAddress, update.endpointId, update.clusterId);
+    if (clusterRowId < 0) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not save cluster attribute into database. The server cluster" << ZigbeeUtils::convertUint16ToHexString(update.clusterId)
+                                             << "of endpoint" << update.endpointId << "of" << update.ieeeAddress << "is unknown.";
+        return false;
+    }
+
+    QSqlQuery query = preparedQuery("INSERT OR REPLACE INTO attributes (clusterId, attributeId, dataType, data) "
+                                    "VALUES (:clusterId, :attributeId, :dataType, :data);");
+    query.bindValue(":clusterId", clusterRowId);
+    query.bindValue(":attributeId", update.attributeId);
+    query.bindValue(":dataType", update.dataType);
+    query.bindValue(":data", QString::fromLatin1(update.data.toBase64()));
+    if (!query.exec()) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not save cluster cluster attribute into database." << update.ieeeAddress << query.lastError().databaseText() << query.lastError().driverText();
+        return false;
+    }
+
+    return true;
+}
+
+bool ZigbeeNetworkDatabase::writeCluster(RowType rowType, ZigbeeCluster *cluster)
+{
+    QString ieeeAddress = cluster->node()->extendedAddress().toString();
+    quint8 endpointId = cluster->endpoint()->endpointId();
+    quint16 clusterId = static_cast<quint16>(cluster->clusterId());
+
+    qint64 endpointRowId = rowId(RowTypeEndpoint, ieeeAddress, endpointId);
+    if (endpointRowId < 0) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not save" << cluster << "into database. The endpoint is unknown.";
+        return false;
+    }
+
+    QString tableName = rowType == RowTypeServerCluster ? "serverClusters" : "clientClusters";
+    QSqlQuery query = preparedQuery(QString("INSERT OR REPLACE INTO %1 (endpointId, clusterId) VALUES (:endpointId, :clusterId);").arg(tableName));
+    query.bindValue(":endpointId", endpointRowId);
+    query.bindValue(":clusterId", clusterId);
+    if (!query.exec()) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not save" << cluster << "into database." << query.lastError().databaseText() << query.lastError().driverText();
+        return false;
+    }
+
+    m_rowIds.insert(rowKey(rowType, ieeeAddress, endpointId, clusterId), query.lastInsertId().toLongLong());
+    return true;
+}
+
 bool ZigbeeNetworkDatabase::saveNodeEndpoint(ZigbeeNodeEndpoint *endpoint)
 {
     qCDebug(dcZigbeeNetworkDatabase()) << "Save" << endpoint;
-    QString queryString = QString("INSERT OR REPLACE INTO endpoints (ieeeAddress, endpointId, profileId, deviceId, deviceVersion) "
-                                  "VALUES (\"%1\", \"%2\", \"%3\", \"%4\", \"%5\");")
-            .arg(endpoint->node()->extendedAddress().toString())
-            .arg(endpoint->endpointId())
-            .arg(static_cast<quint16>(endpoint->profile()))
-            .arg(static_cast<quint16>(endpoint->deviceId()))
-            .arg(static_cast<quint8>(endpoint->deviceVersion()));
-
-    qCDebug(dcZigbeeNetworkDatabase()) << queryString;
-    m_db.exec(queryString);
-    if (m_db.lastError().type() != QSqlError::NoError) {
-        qCWarning(dcZigbeeNetworkDatabase()) << "Could not save endpoint into database." << queryString << m_db.lastError().databaseText() << m_db.lastError().driverText();
+    QString ieeeAddress = endpoint->node()->extendedAddress().toString();
+    QSqlQuery query = preparedQuery("INSERT OR REPLACE INTO endpoints (ieeeAddress, endpointId, profileId, deviceId, deviceVersion) "
+                                    "VALUES (:ieeeAddress, :endpointId, :profileId, :deviceId, :deviceVersion);");
+    query.bindValue(":ieeeAddress", ieeeAddress);
+    query.bindValue(":endpointId", endpoint->endpointId());
+    query.bindValue(":profileId", static_cast<quint16>(endpoint->profile()));
+    query.bindValue(":deviceId", static_cast<quint16>(endpoint->deviceId()));
+    query.bindValue(":deviceVersion", static_cast<quint8>(endpoint->deviceVersion()));
+    if (!query.exec()) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not save endpoint into database." << endpoint << query.lastError().databaseText() << query.lastError().driverText();
         return false;
     }
 
+    // Replacing the endpoint row assigns a new row id, the cluster rows get written again below
+    QMutableHashIterator<RowKey, qint64> iterator(m_rowIds);
+    while (iterator.hasNext()) {
+        iterator.next();
+        if (iterator.key().first == ieeeAddress && static_cast<quint8>((iterator.key().second >> 16) & 0xff) == endpoint->endpointId()) {
+            iterator.remove();
+        }
+    }
+    m_rowIds.insert(rowKey(RowTypeEndpoint, ieeeAddress, endpoint->endpointId()), query.lastInsertId().toLongLong());
+
     // Save input/output clusters
     foreach(ZigbeeCluster *cluster, endpoint->inputClusters()) {
         if (!saveInputCluster(cluster)) {
@@ -332,7 +715,14 @@ bool ZigbeeNetworkDatabase::saveNodeEndpoint(ZigbeeNodeEndpoint *endpoint)
         }
 
         foreach(const ZigbeeClusterAttribute &attribute, cluster->attributes()) {
-            if (!saveAttribute(cluster, attribute)) {
+            PendingAttributeUpdate update;
+            update.ieeeAddress = ieeeAddress;
+            update.endpointId = endpoint->endpointId();
+            update.clusterId = static_cast<quint16>(cluster->clusterId());
+            update.attributeId = static_cast<quint16>(attribute.id());
+            update.dataType = static_cast<quint8>(attribute.dataType().dataType());
+            update.data = attribute.dataType().data();
+            if (!writeAttribute(update)) {
                 return false;
             }
         }
@@ -350,115 +740,95 @@ bool ZigbeeNetworkDatabase::saveNodeEndpoint(ZigbeeNodeEndpoint *endpoint)
 bool ZigbeeNetworkDatabase::saveInputCluster(ZigbeeCluster *cluster)
 {
     qCDebug(dcZigbeeNetworkDatabase()) << "Save" << cluster;
-    QString endpointIdReferenceQuery = QString("(SELECT id FROM endpoints WHERE ieeeAddress = \"%1\" AND endpointId = \"%2\")")
-            .arg(cluster->node()->extendedAddress().toString())
-            .arg(cluster->endpoint()->endpointId());
-    QString queryString = QString("INSERT OR REPLACE INTO serverClusters (endpointId, clusterId) VALUES (%1, \"%2\");")
-            .arg(endpointIdReferenceQuery)
-            .arg(static_cast<quint16>(cluster->clusterId()));
-    m_db.exec(queryString);
-    if (m_db.lastError().type() != QSqlError::NoError) {
-        qCWarning(dcZigbeeNetworkDatabase()) << "Could not save input cluster into database." << queryString << m_db.lastError().databaseText() << m_db.lastError().driverText();
-        return false;
-    }
-
-    return true;
+    return writeCluster(RowTypeServerCluster, cluster);
 }
 
 bool ZigbeeNetworkDatabase::saveOutputCluster(ZigbeeCluster *cluster)
 {
     qCDebug(dcZigbeeNetworkDatabase()) << "Save" << cluster;
-    QString endpointIdReferenceQuery = QString("(SELECT id FROM endpoints WHERE ieeeAddress = \"%1\" AND endpointId = \"%2\")")
-            .arg(cluster->node()->extendedAddress().toString())
-            .arg(cluster->endpoint()->endpointId());
-    QString queryString = QString("INSERT OR REPLACE INTO clientClusters (endpointId, clusterId) VALUES (%1, \"%2\");")
-            .arg(endpointIdReferenceQuery)
-            .arg(static_cast<quint16>(cluster->clusterId()));
-
-    m_db.exec(queryString);
-    if (m_db.lastError().type() != QSqlError::NoError) {
-        qCWarning(dcZigbeeNetworkDatabase()) << "Could not save output cluster into database." << queryString << m_db.lastError().databaseText() << m_db.lastError().driverText();
-        return false;
-    }
-
-    return true;
+    return writeCluster(RowTypeClientCluster, cluster);
 }
 
 bool ZigbeeNetworkDatabase::saveAttribute(ZigbeeCluster *cluster, const ZigbeeClusterAttribute &attribute)
 {
     qCDebug(dcZigbeeNetworkDatabase()) << "Save" << attribute;
-    QString serverClusterIdReferenceQuery = QString("(SELECT id FROM serverClusters "
-                                                    "WHERE endpointId = (SELECT id FROM endpoints WHERE ieeeAddress = \"%1\" AND endpointId = \"%2\")"
-                                                    "AND clusterId = \"%3\")")
-            .arg(cluster->node()->extendedAddress().toString())
-            .arg(cluster->endpoint()->endpointId())
-            .arg(cluster->clusterId());
-
-    QString queryString = QString("INSERT OR REPLACE INTO attributes (clusterId, attributeId, dataType, data) "
-                                  "VALUES (%1, \"%2\", \"%3\", \"%4\");")
-            .arg(serverClusterIdReferenceQuery)
-            .arg(static_cast<quint16>(attribute.id()))
-            .arg(static_cast<quint8>(attribute.dataType().dataType()))
-            .arg((attribute.dataType().data().toBase64().data()));
-
-    m_db.exec(queryString);
-    if (m_db.lastError().type() != QSqlError::NoError) {
-        qCWarning(dcZigbeeNetworkDatabase()) << "Could not save cluster cluster attribute into database." << queryString << m_db.lastError().databaseText() << m_db.lastError().driverText();
-        return false;
-    }
-
+    PendingAttributeUpdate update;
+    update.ieeeAddress = cluster->node()->extendedAddress().toString();
+    update.endpointId = cluster->endpoint()->endpointId();
+    update.clusterId = static_cast<quint16>(cluster->clusterId());
+    update.attributeId = static_cast<quint16>(attribute.id());
+    update.dataType = static_cast<quint8>(attribute.dataType().dataType());
+    update.data = attribute.dataType().data();
+
+    // Only the latest value of an attribute row gets written
+    QPair<quint64, quint64> key(cluster->node()->extendedAddress().toUInt64(),
+                                (static_cast<quint64>(update.endpointId) << 32) | (static_cast<quint64>(update.clusterId) << 16) | update.attributeId);
+    m_pendingAttributeUpdates.insert(key, update);
+    scheduleFlush();
     return true;
 }
 
 bool ZigbeeNetworkDatabase::saveNode(ZigbeeNode *node)
 {
     qCDebug(dcZigbeeNetworkDatabase()) << "Save" << node;
-    QString queryString = QString("INSERT OR REPLACE INTO nodes (ieeeAddress, shortAddress, nodeDescriptor, powerDescriptor, lqi, timestamp) "
-                                  "VALUES (\"%1\", \"%2\", \"%3\", \"%4\", \"%5\", \"%6\");")
-            .arg(node->extendedAddress().toString())
-            .arg(node->shortAddress())
-            .arg(node->nodeDescriptor().descriptorRawData.toBase64().data()) // Note: convert to base64 for saving zeros as string
-            .arg(node->powerDescriptor().powerDescriptoFlag)
-            .arg(node->lqi())
-            .arg(node->lastSeen().toMSecsSinceEpoch() / 1000);
-
-    qCDebug(dcZigbeeNetworkDatabase()) << queryString;
-    m_db.exec(queryString);
-    if (m_db.lastError().type() != QSqlError::NoError) {
-        qCWarning(dcZigbeeNetworkDatabase()) << "Could not save node into database." << queryString << m_db.lastError().databaseText() << m_db.lastError().driverText();
+
+    // Pending updates are older than the values we are about to write
+    flush();
+
+    bool transactionStarted = m_db.transaction();
+    QSqlQuery query = preparedQuery("INSERT OR REPLACE INTO nodes (ieeeAddress, shortAddress, nodeDescriptor, powerDescriptor, lqi, timestamp) "
+                                    "VALUES (:ieeeAddress, :shortAddress, :nodeDescriptor, :powerDescriptor, :lqi, :timestamp);");
+    query.bindValue(":ieeeAddress", node->extendedAddress().toString());
+    query.bindValue(":shortAddress", node->shortAddress());
+    query.bindValue(":nodeDescriptor", QString::fromLatin1(node->nodeDescriptor().descriptorRawData.toBase64())); // Note: convert to base64 for saving zeros as string
+    query.bindValue(":powerDescriptor", node->powerDescriptor().powerDescriptoFlag);
+    query.bindValue(":lqi", node->lqi());
+    query.bindValue(":timestamp", node->lastSeen().toMSecsSinceEpoch() / 1000);
+    if (!query.exec()) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not save node into database." << node << query.lastError().databaseText() << query.lastError().driverText();
+        if (transactionStarted)
+            m_db.rollback();
+
         return false;
     }
 
     // Save endpoints
     foreach (ZigbeeNodeEndpoint *endpoint, node->endpoints()) {
         if (!saveNodeEndpoint(endpoint)) {
+            if (transactionStarted)
+                m_db.rollback();
+
             return false;
         }
     }
 
+    if (transactionStarted && !m_db.commit()) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not commit node into database." << m_db.lastError().databaseText() << m_db.lastError().driverText();
+        m_db.rollback();
+        return false;
+    }
+
     return true;
 }
 
 bool ZigbeeNetworkDatabase::updateNodeLqi(ZigbeeNode *node, quint8 lqi)
 {
     qCDebug(dcZigbeeNetworkDatabase()) << "Update node LQI" << node << lqi;
-    QString queryString = QString("UPDATE nodes SET lqi = \"%1\" WHERE ieeeAddress = \"%2\";").arg(lqi).arg(node->extendedAddress().toString());
-    m_db.exec(queryString);
-    if (m_db.lastError().type() != QSqlError::NoError) {
-        qCWarning(dcZigbeeNetworkDatabase()) << "Could not update node LQI value in the database." << queryString << m_db.lastError().databaseText() << m_db.lastError().driverText();
-        return false;
-    }
-
+    PendingNodeUpdate &update = m_pendingNodeUpdates[node->extendedAddress().toString()];
+    update.lqiPending = true;
+    update.lqi = lqi;
+    scheduleFlush();
     return true;
 }
 
 bool ZigbeeNetworkDatabase::updateNodeNetworkAddress(ZigbeeNode *node, quint16 networkAddress)
 {
     qCDebug(dcZigbeeNetworkDatabase()) << "Update node network address" << node << ZigbeeUtils::convertUint16ToHexString(networkAddress);
-    QString queryString = QString("UPDATE nodes SET shortAddress = \"%1\" WHERE ieeeAddress = \"%2\";").arg(networkAddress).arg(node->extendedAddress().toString());
-    m_db.exec(queryString);
-    if (m_db.lastError().type() != QSqlError::NoError) {
-        qCWarning(dcZigbeeNetworkDatabase()) << "Could not update node LQI value in the database." << queryString << m_db.lastError().databaseText() << m_db.lastError().driverText();
+    QSqlQuery query = preparedQuery("UPDATE nodes SET shortAddress = :shortAddress WHERE ieeeAddress = :ieeeAddress;");
+    query.bindValue(":shortAddress", networkAddress);
+    query.bindValue(":ieeeAddress", node->extendedAddress().toString());
+    if (!query.exec()) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not update node network address in the database." << node << query.lastError().databaseText() << query.lastError().driverText();
         return false;
     }
 
@@ -469,24 +839,64 @@ bool ZigbeeNetworkDatabase::updateNodeLastSeen(ZigbeeNode *node, const QDateTime
 {
     quint64 timestamp = lastSeen.toMSecsSinceEpoch() / 1000;
     qCDebug(dcZigbeeNetworkDatabase()) << "Update node last seen UTC timestamp" << node << timestamp;
-    QString queryString = QString("UPDATE nodes SET timestamp = \"%1\" WHERE ieeeAddress = \"%2\";").arg(timestamp).arg(node->extendedAddress().toString());
-    m_db.exec(queryString);
-    if (m_db.lastError().type() != QSqlError::NoError) {
-        qCWarning(dcZigbeeNetworkDatabase()) << "Could not update node timestamp value in the database." << queryString << m_db.lastError().databaseText() << m_db.lastError().driverText();
-        return false;
-    }
-
+    PendingNodeUpdate &update = m_pendingNodeUpdates[node->extendedAddress().toString()];
+    update.lastSeenPending = true;
+    update.timestamp = timestamp;
+    scheduleFlush();
     return true;
 }
 
 bool ZigbeeNetworkDatabase::removeNode(ZigbeeNode *node)
 {
     qCDebug(dcZigbeeNetworkDatabase()) << "Remove" << node;
+    QString ieeeAddress = node->extendedAddress().toString();
+    discardPendingWrites(ieeeAddress);
+    removeRowIds(ieeeAddress);
+
     // Note: cascade delete will clean up all other tables
-    QString queryString = QString("DELETE FROM nodes WHERE ieeeAddress = \"%1\";").arg(node->extendedAddress().toString());
-    m_db.exec(queryString);
-    if (m_db.lastError().type() != QSqlError::NoError) {
-        qCWarning(dcZigbeeNetworkDatabase()) << "Could not remove node from database." << queryString << m_db.lastError().databaseText() << m_db.lastError().driverText();
+    QSqlQuery query = preparedQuery("DELETE FROM nodes WHERE ieeeAddress = :ieeeAddress;");
+    query.bindValue(":ieeeAddress", ieeeAddress);
+    if (!query.exec()) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not remove node from database." << node << query.lastError().databaseText() << query.lastError().driverText();
+        return false;
+    }
+
+    return true;
+}
+
+bool ZigbeeNetworkDatabase::saveInterviewTemplate(const ZigbeeNodeInterviewTemplate &interviewTemplate)
+{
+    qCDebug(dcZigbeeNetworkDatabase()) << "Save interview template" << interviewTemplate.manufacturerName << interviewTemplate.modelName << interviewTemplate.version;
+    QStringList simpleDescriptors;
+    foreach (const QByteArray &simpleDescriptor, interviewTemplate.simpleDescriptors) {
+        simpleDescriptors.append(QString::fromLatin1(simpleDescriptor.toBase64()));
+    }
+
+    QSqlQuery query = preparedQuery("INSERT OR REPLACE INTO interviewTemplates (manufacturerCode, manufacturerName, modelName, version, powerDescriptor, simpleDescriptors) "
+                                    "VALUES (:manufacturerCode, :manufacturerName, :modelName, :version, :powerDescriptor, :simpleDescriptors);");
+    query.bindValue(":manufacturerCode", interviewTemplate.manufacturerCode);
+    query.bindValue(":manufacturerName", interviewTemplate.manufacturerName);
+    query.bindValue(":modelName", interviewTemplate.modelName);
+    query.bindValue(":version", interviewTemplate.version);
+    query.bindValue(":powerDescriptor", interviewTemplate.powerDescriptor);
+    query.bindValue(":simpleDescriptors", simpleDescriptors.join(','));
+    if (!query.exec()) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not save interview template into database." << query.lastError().databaseText() << query.lastError().driverText();
+        return false;
+    }
+
+    return true;
+}
+
+bool ZigbeeNetworkDatabase::removeInterviewTemplate(const ZigbeeNodeInterviewTemplate &interviewTemplate)
+{
+    qCDebug(dcZigbeeNetworkDatabase()) << "Remove interview template" << interviewTemplate.manufacturerName << interviewTemplate.modelName << interviewTemplate.version;
+    QSqlQuery query = preparedQuery("DELETE FROM interviewTemplates WHERE manufacturerCode = :manufacturerCode AND modelName = :modelName AND version = :version;");
+    query.bindValue(":manufacturerCode", interviewTemplate.manufacturerCode);
+    query.bindValue(":modelName", interviewTemplate.modelName);
+    query.bindValue(":version", interviewTemplate.version);
+    if (!query.exec()) {
+        qCWarning(dcZigbeeNetworkDatabase()) << "Could not remove interview template from database." << query.lastError().databaseText() << query.lastError().driverText();
         return false;
     }
 
@@ -28,7 +28,11 @@
 #ifndef ZIGBEENETWORKDATABASE_H
 #define ZIGBEENETWORKDATABASE_H
 
+#include <QHash>
+#include <QPair>
+#include <QTimer>
 #include <QObject>
+#include <QSqlQuery>
 #include <QSqlDatabase>
 
 #define DB_VERSION 1
@@ -39,6 +43,8 @@ class ZigbeeNetwork;
 class ZigbeeNodeEndpoint;
 class ZigbeeClusterAttribute;
 
+struct ZigbeeNodeInterviewTemplate;
+
 class QSqlDatabase;
 
 class ZigbeeNetworkDatabase : public QObject
@@ -51,19 +57,79 @@ public:
     QString databaseName() const;
 
     QList<ZigbeeNode *> loadNodes();
+    QList<ZigbeeNodeInterviewTemplate> loadInterviewTemplates();
 
     bool wipeDatabase();
 
+    // Frequently changing values (LQI, last seen, attribute values) are written behind.
+    // Pending updates get merged per row and written in one transaction once the flush
+    // interval expired or the amount of pending rows reached the limit.
+    int flushInterval() const;
+    void setFlushInterval(int flushInterval);
+
+    int maxPendingWrites() const;
+    void setMaxPendingWrites(int maxPendingWrites);
+
+    int pendingWrites() const;
+
+    bool flush();
+
 private:
     ZigbeeNetwork *m_network = nullptr;
     QString m_databaseName;
     QString m_connectionName;
     QSqlDatabase m_db;
 
+    typedef struct PendingNodeUpdate {
+        bool lqiPending = false;
+        quint8 lqi = 0;
+        bool lastSeenPending = false;
+        quint64 timestamp = 0;
+    } PendingNodeUpdate;
+
+    typedef struct PendingAttributeUpdate {
+        QString ieeeAddress;
+        quint8 endpointId = 0;
+        quint16 clusterId = 0;
+        quint16 attributeId = 0;
+        quint8 dataType = 0;
+        QByteArray data;
+    } PendingAttributeUpdate;
+
+    QTimer m_flushTimer;
+    int m_flushInterval = 5000;
+    int m_maxPendingWrites = 200;
+    QHash<QString, PendingNodeUpdate> m_pendingNodeUpdates;
+    QHash<QPair<quint64, quint64>, PendingAttributeUpdate> m_pendingAttributeUpdates;
+
+    // Prepared statements by query string and the row ids of endpoints and clusters, so updates
+    // do not need to resolve the relations using sub queries each time
+    enum RowType {
+        RowTypeEndpoint,
+        RowTypeServerCluster,
+        RowTypeClientCluster
+    };
+
+    typedef QPair<QString, quint32> RowKey;
+
+    QHash<QString, QSqlQuery> m_preparedQueries;
+    QHash<RowKey, qint64> m_rowIds;
+
     bool initDatabase();
     void createTable(const QString &tableName, const QString &schema);
     void createIndices(const QString &indexName, const QString &tableName, const QString &columns);
 
+    void scheduleFlush();
+    void scheduleFlushRetry();
+    void discardPendingWrites(const QString &ieeeAddress);
+    bool writeAttribute(const PendingAttributeUpdate &update);
+    bool writeCluster(RowType rowType, ZigbeeCluster *cluster);
+
+    QSqlQuery preparedQuery(const QString &statement);
+    static RowKey rowKey(RowType rowType, const QString &ieeeAddress, quint8 endpointId, quint16 clusterId = 0);
+    qint64 rowId(RowType rowType, const QString &ieeeAddress, quint8 endpointId, quint16 clusterId = 0);
+    void removeRowIds(const QString &ieeeAddress);
+
 public slots:
     bool saveNodeEndpoint(ZigbeeNodeEndpoint *endpoint);
     bool saveInputCluster(ZigbeeCluster *cluster);
@@ -74,6 +140,8 @@ public slots:
     bool updateNodeNetworkAddress(ZigbeeNode *node, quint16 networkAddress);
     bool updateNodeLastSeen(ZigbeeNode *node, const QDateTime &lastSeen);
     bool removeNode(ZigbeeNode *node);
+    bool saveInterviewTemplate(const ZigbeeNodeInterviewTemplate &interviewTemplate);
+    bool removeInterviewTemplate(const ZigbeeNodeInterviewTemplate &interviewTemplate);
 
 };
 
@@ -56,10 +56,8 @@ ZigbeeNetworkReply::ZigbeeNetworkReply(const ZigbeeNetworkRequest &request, QObj
     QObject(parent),
     m_request(request)
 {
-    m_timer = new QTimer(this);
-    m_timer->setSingleShot(true);
-    m_timer->setInterval(10000);
-    connect(m_timer, &QTimer::timeout, this, [this](){
+    m_timer.setInterval(10000);
+    m_timer.setCallback([this](){
         m_error = ErrorTimeout;
         emit finished();
     });
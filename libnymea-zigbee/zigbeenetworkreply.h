@@ -29,9 +29,9 @@
 #define ZIGBEENETWORKREPLY_H
 
 #include <QObject>
-#include <QTimer>
 
 #include "zigbee.h"
+#include "zigbeetimerwheel.h"
 #include "zigbeenetworkrequest.h"
 
 class ZigbeeNetworkReply : public QObject
@@ -49,7 +49,8 @@ public:
         ErrorZigbeeMacStatusError,
         ErrorZigbeeNwkStatusError,
         ErrorZigbeeApsStatusError,
-        ErrorNetworkOffline
+        ErrorNetworkOffline,
+        ErrorRequestIdUnavailable // All on air request ids are in flight
     };
     Q_ENUM(Error)
 
@@ -63,7 +64,7 @@ public:
 private:
     explicit ZigbeeNetworkReply(const ZigbeeNetworkRequest &request, QObject *parent = nullptr);
     ZigbeeNetworkRequest m_request;
-    QTimer *m_timer = nullptr;
+    ZigbeeTimeout m_timer;
 
     Error m_error = ErrorNoError;
     Zigbee::ZigbeeMacLayerStatus m_zigbeeMacStatus = Zigbee::ZigbeeMacLayerStatusSuccess;
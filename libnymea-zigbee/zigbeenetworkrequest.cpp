@@ -34,6 +34,16 @@ ZigbeeNetworkRequest::ZigbeeNetworkRequest()
 
 }
 
+quint64 ZigbeeNetworkRequest::handle() const
+{
+    return m_handle;
+}
+
+void ZigbeeNetworkRequest::setHandle(quint64 handle)
+{
+    m_handle = handle;
+}
+
 quint8 ZigbeeNetworkRequest::requestId() const
 {
     return m_requestId;
@@ -144,9 +154,28 @@ void ZigbeeNetworkRequest::setRadius(quint8 radius)
     m_radius = radius;
 }
 
+Zigbee::RequestPriority ZigbeeNetworkRequest::priority() const
+{
+    return m_priority;
+}
+
+void ZigbeeNetworkRequest::setPriority(Zigbee::RequestPriority priority)
+{
+    m_priority = priority;
+}
+
+quint64 ZigbeeNetworkRequest::destinationKey() const
+{
+    if (m_destinationAddressMode == Zigbee::DestinationAddressModeIeeeAddress)
+        return m_destinationIeeeAddress.toUInt64();
+
+    // Keep group and short addresses apart
+    return (static_cast<quint64>(m_destinationAddressMode) << 16) | m_destinationShortAddress;
+}
+
 QDebug operator<<(QDebug debug, const ZigbeeNetworkRequest &request)
 {
-    debug.nospace() << "Request(ID:" << request.requestId() << ", ";
+    debug.nospace() << "Request(ID:" << request.requestId() << ", Handle:" << request.handle() << ", ";
     debug.nospace() << static_cast<Zigbee::ZigbeeProfile>(request.profileId()) << ", ";
     if (request.profileId() == Zigbee::ZigbeeProfileDevice) {
         debug.nospace() << static_cast<ZigbeeDeviceProfile::ZdoCommand>(request.clusterId()) << ", ";
@@ -166,6 +195,7 @@ QDebug operator<<(QDebug debug, const ZigbeeNetworkRequest &request)
     debug.nospace() << "Destination EP:" << ZigbeeUtils::convertByteToHexString(request.destinationEndpoint()) << ", ";
     debug.nospace() << "Source EP:" << ZigbeeUtils::convertByteToHexString(request.sourceEndpoint()) << ", ";
     debug.nospace() << "Radius:" << request.radius() << ", ";
+    debug.nospace() << request.priority() << ", ";
     debug.nospace() << request.txOptions() << ", ";
     debug.nospace() << ZigbeeUtils::convertByteArrayToHexString(request.asdu());
     debug.nospace() << ")";
@@ -39,6 +39,11 @@ class ZigbeeNetworkRequest
 public:
     ZigbeeNetworkRequest();
 
+    // Internal handle of the request, unique for the lifetime of the network
+    quint64 handle() const;
+    void setHandle(quint64 handle);
+
+    // On air APS request id, only unique among the requests in flight
     quint8 requestId() const;
     void setRequestId(quint8 requestId);
 
@@ -72,7 +77,14 @@ public:
     quint8 radius() const;
     void setRadius(quint8 radius);
 
+    Zigbee::RequestPriority priority() const;
+    void setPriority(Zigbee::RequestPriority priority);
+
+    // Key identifying the destination of this request, used for fair scheduling between destinations
+    quint64 destinationKey() const;
+
 private:
+    quint64 m_handle = 0;
     quint8 m_requestId = 0;
     Zigbee::DestinationAddressMode m_destinationAddressMode = Zigbee::DestinationAddressModeShortAddress;
     quint16 m_destinationShortAddress = 0;
@@ -84,6 +96,7 @@ private:
     QByteArray m_asdu;
     Zigbee::ZigbeeTxOptions m_txOptions = Zigbee::ZigbeeTxOptions(Zigbee::ZigbeeTxOptionAckTransmission);
     quint8 m_radius = 0;
+    Zigbee::RequestPriority m_priority = Zigbee::RequestPriorityUser;
 
 };
 
@@ -114,7 +114,18 @@ quint8 ZigbeeNode::lqi() const
 
 QDateTime ZigbeeNode::lastSeen() const
 {
-    return m_lastSeen;
+    if (!m_lastSeenAvailable)
+        return QDateTime();
+
+    return QDateTime::currentDateTimeUtc().addMSecs(-msecsSinceLastSeen());
+}
+
+qint64 ZigbeeNode::msecsSinceLastSeen() const
+{
+    if (!m_lastSeenAvailable)
+        return 0;
+
+    return ZigbeeUtils::monotonicMilliseconds() - m_lastSeen;
 }
 
 ZigbeeDeviceProfile::NodeDescriptor ZigbeeNode::nodeDescriptor() const
@@ -172,21 +183,47 @@ void ZigbeeNode::setReachable(bool reachable)
     emit reachableChanged(m_reachable);
 }
 
+void ZigbeeNode::setLastSeen(const QDateTime &lastSeen)
+{
+    // Map the persisted wall clock time onto the monotonic clock
+    m_lastSeen = ZigbeeUtils::monotonicMilliseconds() - lastSeen.msecsTo(QDateTime::currentDateTimeUtc());
+    m_lastSeenReported = m_lastSeen;
+    m_lastSeenAvailable = lastSeen.isValid();
+}
+
 void ZigbeeNode::startInitialization()
 {
     setState(StateInitializing);
 
-    /* Node initialisation steps (sequentially)
-      * - Node descriptor
-      * - Power descriptor
-      * - Active endpoints
-      * - for each endpoint do:
-      *    - Simple descriptor request
-      *    - for each endpoint
-      *      - read basic cluster
+    /* Node initialisation steps
+      * - Node descriptor, power descriptor and active endpoints (concurrently)
+      * - Simple descriptor request for each endpoint (concurrently)
+      * - Once all of them are finished, read the basic cluster attributes of the first
+      *   endpoint containing the basic cluster in one request
+      *
+      * If the interview cache is enabled, the power descriptor and simple descriptors are only requested
+      * if there is no interview template matching the node descriptor and the active endpoints. Otherwise
+      * the endpoints are created from the template and verified by the basic cluster attributes.
       */
 
+    // Responses of a previous run must not count for this one
+    m_initGeneration++;
+    m_pendingInitRequests = 0;
+    m_initEndpointsFailed = false;
+    m_initFromTemplate = false;
+    m_simpleDescriptors.clear();
+    m_initTemplateLookupPending = m_network->interviewCacheEnabled() && m_shortAddress != 0;
+    if (m_initTemplateLookupPending) {
+        m_pendingInitRequests = 2;
+        initNodeDescriptor();
+        initEndpoints();
+        return;
+    }
+
+    m_pendingInitRequests = 3;
     initNodeDescriptor();
+    initPowerDescriptor();
+    initEndpoints();
 }
 
 ZigbeeReply *ZigbeeNode::removeAllBindings()
@@ -264,57 +301,65 @@ ZigbeeReply *ZigbeeNode::readBindingTableEntries()
     return reply;
 }
 
-void ZigbeeNode::initNodeDescriptor()
+void ZigbeeNode::initNodeDescriptor(int attempt)
 {
     qCDebug(dcZigbeeNode()) << "Request node descriptor from" << this;
+    qint64 requestTimestamp = ZigbeeUtils::monotonicMilliseconds();
+    quint32 generation = m_initGeneration;
     ZigbeeDeviceObjectReply *reply = deviceObject()->requestNodeDescriptor();
-    connect(reply, &ZigbeeDeviceObjectReply::finished, this, [this, reply](){
+    connect(reply, &ZigbeeDeviceObjectReply::finished, this, [this, reply, attempt, requestTimestamp, generation](){
+        // Ignore responses of a previous initialization run
+        if (generation != m_initGeneration)
+            return;
+
         if (reply->error() != ZigbeeDeviceObjectReply::ErrorNoError) {
             qCWarning(dcZigbeeNode()) << "Error occured during initialization of" << this << "Failed to read node descriptor" << reply->error();
-            m_requestRetry++;
-            if (m_requestRetry < m_requestRetriesMax) {
-                qCDebug(dcZigbeeNode()) << "Retry to request node descriptor" << m_requestRetry << "/" << m_requestRetriesMax;
-                QTimer::singleShot(500, this, [=](){ initNodeDescriptor(); });
+            if (attempt < m_requestRetriesMax) {
+                qCDebug(dcZigbeeNode()) << "Retry to request node descriptor" << attempt + 1 << "/" << m_requestRetriesMax;
+                QTimer::singleShot(initRetryDelay(attempt), this, [=](){ if (generation == m_initGeneration) initNodeDescriptor(attempt + 1); });
             } else {
                 qCWarning(dcZigbeeNode()) << "Failed to read node descriptor from" << this << "after" << m_requestRetriesMax << "attempts.";
-                m_requestRetry = 0;
-                qCWarning(dcZigbeeNode()) << this << "is out of spec. A device must implement the node descriptor. Continue anyways with the power decriptor...";
-                initPowerDescriptor();
+                qCWarning(dcZigbeeNode()) << this << "is out of spec. A device must implement the node descriptor. Continue anyways with the initialization...";
+                finishInitRequest();
             }
             return;
         }
 
         qCDebug(dcZigbeeNode()) << this << "reading node descriptor finished successfully.";
+        updateInitResponseTime(requestTimestamp);
         m_nodeDescriptor = ZigbeeDeviceProfile::parseNodeDescriptor(reply->responseAdpu().payload);
         qCDebug(dcZigbeeNode()) << m_nodeDescriptor;
         m_nodeDescriptorAvailable = true;
-        m_requestRetry = 0;
-
-        // Continue with the power descriptor
-        initPowerDescriptor();
+        finishInitRequest();
     });
 }
 
-void ZigbeeNode::initPowerDescriptor()
+void ZigbeeNode::initPowerDescriptor(int attempt)
 {
     qCDebug(dcZigbeeNode()) << "Request power descriptor from" << this;
+    qint64 requestTimestamp = ZigbeeUtils::monotonicMilliseconds();
+    quint32 generation = m_initGeneration;
     ZigbeeDeviceObjectReply *reply = deviceObject()->requestPowerDescriptor();
-    connect(reply, &ZigbeeDeviceObjectReply::finished, this, [this, reply](){
+    connect(reply, &ZigbeeDeviceObjectReply::finished, this, [this, reply, attempt, requestTimestamp, generation](){
+        // Ignore responses of a previous initialization run
+        if (generation != m_initGeneration)
+            return;
+
         if (reply->error() != ZigbeeDeviceObjectReply::ErrorNoError) {
             qCWarning(dcZigbeeNode()) << "Error occured during initialization of" << this << "Failed to read power descriptor" << reply->error();
-            if (m_requestRetry < m_requestRetriesMax) {
-                m_requestRetry++;
-                qCDebug(dcZigbeeNode()) << "Retry to request power descriptor from" << this << m_requestRetry << "/" << m_requestRetriesMax << "attempts.";
-                QTimer::singleShot(500, this, [=](){ initPowerDescriptor(); });
+            if (attempt < m_requestRetriesMax) {
+                qCDebug(dcZigbeeNode()) << "Retry to request power descriptor from" << this << attempt + 1 << "/" << m_requestRetriesMax << "attempts.";
+                QTimer::singleShot(initRetryDelay(attempt), this, [=](){ if (generation == m_initGeneration) initPowerDescriptor(attempt + 1); });
             } else {
                 qCWarning(dcZigbeeNode()) << "Failed to read power descriptor from" << this << "after" << m_requestRetriesMax << "attempts. Giving up reading power descriptor.";
-                qCWarning(dcZigbeeNode()) << this << "is out of spec. A device must implement the power descriptor. Continue anyways with the endpoint initialization...";
-                initEndpoints();
+                qCWarning(dcZigbeeNode()) << this << "is out of spec. A device must implement the power descriptor. Continue anyways with the initialization...";
+                finishInitRequest();
             }
             return;
         }
 
         qCDebug(dcZigbeeNode()) << this << "reading power descriptor finished successfully.";
+        updateInitResponseTime(requestTimestamp);
         QDataStream stream(reply->responseAdpu().payload);
         stream.setByteOrder(QDataStream::LittleEndian);
         quint16 powerDescriptorFlag = 0;
@@ -322,33 +367,36 @@ void ZigbeeNode::initPowerDescriptor()
         m_powerDescriptor = ZigbeeDeviceProfile::parsePowerDescriptor(powerDescriptorFlag);
         qCDebug(dcZigbeeNode()) << m_powerDescriptor;
         m_powerDescriptorAvailable = true;
-        m_requestRetry = 0;
-
-        // Continue with endpoint fetching
-        initEndpoints();
+        finishInitRequest();
     });
 }
 
-void ZigbeeNode::initEndpoints()
+void ZigbeeNode::initEndpoints(int attempt)
 {
     qCDebug(dcZigbeeNode()) << "Request active endpoints from" << this;
+    qint64 requestTimestamp = ZigbeeUtils::monotonicMilliseconds();
+    quint32 generation = m_initGeneration;
     ZigbeeDeviceObjectReply *reply = deviceObject()->requestActiveEndpoints();
-    connect(reply, &ZigbeeDeviceObjectReply::finished, this, [this, reply](){
+    connect(reply, &ZigbeeDeviceObjectReply::finished, this, [this, reply, attempt, requestTimestamp, generation](){
+        // Ignore responses of a previous initialization run
+        if (generation != m_initGeneration)
+            return;
+
         if (reply->error() != ZigbeeDeviceObjectReply::ErrorNoError) {
             qCWarning(dcZigbeeNode()) << "Error occured during initialization of" << this << "Failed to read active endpoints" << reply->error();
-            if (m_requestRetry < m_requestRetriesMax) {
-                m_requestRetry++;
-                qCDebug(dcZigbeeNode()) << "Retry to request active endpoints from" << this << m_requestRetry << "/" << m_requestRetriesMax << "attempts.";
-                QTimer::singleShot(500, this, [=](){ initEndpoints(); });
+            if (attempt < m_requestRetriesMax) {
+                qCDebug(dcZigbeeNode()) << "Retry to request active endpoints from" << this << attempt + 1 << "/" << m_requestRetriesMax << "attempts.";
+                QTimer::singleShot(initRetryDelay(attempt), this, [=](){ if (generation == m_initGeneration) initEndpoints(attempt + 1); });
             } else {
                 qCWarning(dcZigbeeNode()) << "Failed to read active endpoints from" << this << "after" << m_requestRetriesMax << "attempts. Giving up reading endpoints.";
-                m_requestRetry = 0;
-                setState(StateInitialized);
+                m_initEndpointsFailed = true;
+                finishInitRequest();
             }
             return;
         }
 
         qCDebug(dcZigbeeNode()) << this << "reading active endpoints finished successfully.";
+        updateInitResponseTime(requestTimestamp);
         QDataStream stream(reply->responseAdpu().payload);
         stream.setByteOrder(QDataStream::LittleEndian);
         quint8 endpointCount = 0;
@@ -365,124 +413,242 @@ void ZigbeeNode::initEndpoints()
             qCDebug(dcZigbeeNode()) << " -" << ZigbeeUtils::convertByteToHexString(m_uninitializedEndpoints.at(i));
         }
 
-        m_requestRetry = 0;
-
-        // If there a no endpoints or all endpoints have already be initialized, continue with reading the basic cluster information
-        if (m_uninitializedEndpoints.isEmpty()) {
-            initBasicCluster();
-            return;
+        // Read all simple descriptors at once, the initialization continues once all of them are finished.
+        // If an interview template could match, wait for the node descriptor before reading them.
+        if (!m_initTemplateLookupPending) {
+            m_pendingInitRequests += m_uninitializedEndpoints.count();
+            foreach (quint8 endpointId, m_uninitializedEndpoints) {
+                initEndpoint(endpointId);
+            }
         }
 
-        // Start reading simple descriptors sequentially
-        initEndpoint(m_uninitializedEndpoints.first());
+        finishInitRequest();
     });
 }
 
 
-void ZigbeeNode::initEndpoint(quint8 endpointId)
+void ZigbeeNode::initEndpoint(quint8 endpointId, int attempt)
 {
     qCDebug(dcZigbeeNode()) << "Read simple descriptor of endpoint" << ZigbeeUtils::convertByteToHexString(endpointId);
+    qint64 requestTimestamp = ZigbeeUtils::monotonicMilliseconds();
+    quint32 generation = m_initGeneration;
     ZigbeeDeviceObjectReply *reply = deviceObject()->requestSimpleDescriptor(endpointId);
-    connect(reply, &ZigbeeDeviceObjectReply::finished, this, [this, reply, endpointId](){
+    connect(reply, &ZigbeeDeviceObjectReply::finished, this, [this, reply, endpointId, attempt, requestTimestamp, generation](){
+        // Ignore responses of a previous initialization run
+        if (generation != m_initGeneration)
+            return;
+
         if (reply->error() != ZigbeeDeviceObjectReply::ErrorNoError) {
             qCWarning(dcZigbeeNode()) << "Error occured during initialization of" << this << "Failed to read simple descriptor for endpoint" << endpointId << reply->error();
-            if (m_requestRetry < m_requestRetriesMax) {
-                m_requestRetry++;
-                qCDebug(dcZigbeeNode()) << "Retry to request simple descriptor from" << this << ZigbeeUtils::convertByteToHexString(endpointId) << m_requestRetry << "/" << m_requestRetriesMax << "attempts.";
-                QTimer::singleShot(500, this, [=](){ initEndpoint(endpointId); });
+            if (attempt < m_requestRetriesMax) {
+                qCDebug(dcZigbeeNode()) << "Retry to request simple descriptor from" << this << ZigbeeUtils::convertByteToHexString(endpointId) << attempt + 1 << "/" << m_requestRetriesMax << "attempts.";
+                QTimer::singleShot(initRetryDelay(attempt), this, [=](){ if (generation == m_initGeneration) initEndpoint(endpointId, attempt + 1); });
             } else {
                 qCWarning(dcZigbeeNode()) << "Failed to read simple descriptor from" << this << ZigbeeUtils::convertByteToHexString(endpointId) << "after" << m_requestRetriesMax << "attempts. Giving up initializing endpoint" << endpointId;
-                m_requestRetry = 0;
-                if (m_uninitializedEndpoints.isEmpty()) {
-                    // Continue with the basic cluster attributes
-                    initBasicCluster();
-                } else {
-                    // Fetch next endpoint
-                    initEndpoint(m_uninitializedEndpoints.first());
-                }
+                m_uninitializedEndpoints.removeAll(endpointId);
+                finishInitRequest();
             }
             return;
         }
 
         qCDebug(dcZigbeeNode()) << this << "reading simple descriptor for endpoint" << endpointId << "finished successfully.";
-        m_requestRetry = 0;
-        quint8 length = 0; quint8 endpointId = 0; quint16 profileId = 0; quint16 deviceId = 0; quint8 deviceVersion = 0;
-        quint8 inputClusterCount = 0; quint8 outputClusterCount = 0;
-        QList<quint16> inputClusters;
-        QList<quint16> outputClusters;
+        updateInitResponseTime(requestTimestamp);
+        ZigbeeNodeEndpoint *endpoint = setupEndpoint(reply->responseAdpu().payload);
+        m_simpleDescriptors.insert(endpoint->endpointId(), reply->responseAdpu().payload);
+        m_uninitializedEndpoints.removeAll(endpoint->endpointId());
+        finishInitRequest();
+    });
+}
 
-        QDataStream stream(reply->responseAdpu().payload);
-        stream.setByteOrder(QDataStream::LittleEndian);
-        stream >> length >> endpointId >> profileId >> deviceId >> deviceVersion >> inputClusterCount;
-
-        qCDebug(dcZigbeeNode()) << "Node endpoint simple descriptor:";
-        qCDebug(dcZigbeeNode()) << "    Lenght:" << ZigbeeUtils::convertByteToHexString(length);
-        qCDebug(dcZigbeeNode()) << "    End Point:" << ZigbeeUtils::convertByteToHexString(endpointId);
-        qCDebug(dcZigbeeNode()) << "    Profile:" << ZigbeeUtils::profileIdToString(static_cast<Zigbee::ZigbeeProfile>(profileId));
-        if (profileId == Zigbee::ZigbeeProfileLightLink) {
-            qCDebug(dcZigbeeNode()) << "    Device ID:" << ZigbeeUtils::convertUint16ToHexString(deviceId) << static_cast<Zigbee::LightLinkDevice>(deviceId);
-        } else if (profileId == Zigbee::ZigbeeProfileHomeAutomation) {
-            qCDebug(dcZigbeeNode()) << "    Device ID:" << ZigbeeUtils::convertUint16ToHexString(deviceId) << static_cast<Zigbee::HomeAutomationDevice>(deviceId);
-        } else if (profileId == Zigbee::ZigbeeProfileGreenPower) {
-            qCDebug(dcZigbeeNode()) << "    Device ID:" << ZigbeeUtils::convertUint16ToHexString(deviceId) << static_cast<Zigbee::GreenPowerDevice>(deviceId);
+ZigbeeNodeEndpoint *ZigbeeNode::setupEndpoint(const QByteArray &simpleDescriptor)
+{
+    quint8 length = 0; quint8 endpointId = 0; quint16 profileId = 0; quint16 deviceId = 0; quint8 deviceVersion = 0;
+    quint8 inputClusterCount = 0; quint8 outputClusterCount = 0;
+    QList<quint16> inputClusters;
+    QList<quint16> outputClusters;
+
+    QDataStream stream(simpleDescriptor);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream >> length >> endpointId >> profileId >> deviceId >> deviceVersion >> inputClusterCount;
+
+    qCDebug(dcZigbeeNode()) << "Node endpoint simple descriptor:";
+    qCDebug(dcZigbeeNode()) << "    Lenght:" << ZigbeeUtils::convertByteToHexString(length);
+    qCDebug(dcZigbeeNode()) << "    End Point:" << ZigbeeUtils::convertByteToHexString(endpointId);
+    qCDebug(dcZigbeeNode()) << "    Profile:" << ZigbeeUtils::profileIdToString(static_cast<Zigbee::ZigbeeProfile>(profileId));
+    if (profileId == Zigbee::ZigbeeProfileLightLink) {
+        qCDebug(dcZigbeeNode()) << "    Device ID:" << ZigbeeUtils::convertUint16ToHexString(deviceId) << static_cast<Zigbee::LightLinkDevice>(deviceId);
+    } else if (profileId == Zigbee::ZigbeeProfileHomeAutomation) {
+        qCDebug(dcZigbeeNode()) << "    Device ID:" << ZigbeeUtils::convertUint16ToHexString(deviceId) << static_cast<Zigbee::HomeAutomationDevice>(deviceId);
+    } else if (profileId == Zigbee::ZigbeeProfileGreenPower) {
+        qCDebug(dcZigbeeNode()) << "    Device ID:" << ZigbeeUtils::convertUint16ToHexString(deviceId) << static_cast<Zigbee::GreenPowerDevice>(deviceId);
+    }
+
+    qCDebug(dcZigbeeNode()) << "    Device version:" << ZigbeeUtils::convertByteToHexString(deviceVersion);
+
+    // Create endpoint
+    ZigbeeNodeEndpoint *endpoint = nullptr;
+    if (!hasEndpoint(endpointId)) {
+        endpoint = new ZigbeeNodeEndpoint(m_network, this, endpointId, this);
+        m_endpoints.append(endpoint);
+    } else {
+        endpoint = getEndpoint(endpointId);
+    }
+    endpoint->setProfile(static_cast<Zigbee::ZigbeeProfile>(profileId));
+    endpoint->setDeviceId(deviceId);
+    endpoint->setDeviceVersion(deviceVersion);
+
+    // Parse and add server clusters
+    qCDebug(dcZigbeeNode()) << "    Input clusters: (" << inputClusterCount << ")";
+    for (int i = 0; i < inputClusterCount; i++) {
+        quint16 clusterId = 0;
+        stream >> clusterId;
+        if (!endpoint->hasInputCluster(static_cast<ZigbeeClusterLibrary::ClusterId>(clusterId))) {
+            endpoint->addInputCluster(endpoint->createCluster(static_cast<ZigbeeClusterLibrary::ClusterId>(clusterId), ZigbeeCluster::Server));
+        }
+        qCDebug(dcZigbeeNode()) << "        Cluster ID:" << ZigbeeUtils::convertUint16ToHexString(clusterId) << ZigbeeUtils::clusterIdToString(static_cast<ZigbeeClusterLibrary::ClusterId>(clusterId));
+    }
+
+    // Parse and add client clusters
+    stream >> outputClusterCount;
+    qCDebug(dcZigbeeNode()) << "    Output clusters: (" << outputClusterCount << ")";
+    for (int i = 0; i < outputClusterCount; i++) {
+        quint16 clusterId = 0;
+        stream >> clusterId;
+        if (!endpoint->hasOutputCluster(static_cast<ZigbeeClusterLibrary::ClusterId>(clusterId))) {
+            endpoint->addOutputCluster(endpoint->createCluster(static_cast<ZigbeeClusterLibrary::ClusterId>(clusterId), ZigbeeCluster::Client));
         }
+        qCDebug(dcZigbeeNode()) << "        Cluster ID:" << ZigbeeUtils::convertUint16ToHexString(clusterId) << ZigbeeUtils::clusterIdToString(static_cast<ZigbeeClusterLibrary::ClusterId>(clusterId));
+    }
+
+    endpoint->m_initialized = true;
 
-        qCDebug(dcZigbeeNode()) << "    Device version:" << ZigbeeUtils::convertByteToHexString(deviceVersion);
+    setupEndpointInternal(endpoint);
+    return endpoint;
+}
+
+int ZigbeeNode::initRetryDelay(int attempt) const
+{
+    // Back off exponentially, starting from the average response time of this node
+    return static_cast<int>(qBound<qint64>(250, m_initResponseTime << (attempt + 1), 5000));
+}
+
+void ZigbeeNode::updateInitResponseTime(qint64 requestTimestamp)
+{
+    qint64 responseTime = ZigbeeUtils::monotonicMilliseconds() - requestTimestamp;
+    m_initResponseTime = (m_initResponseTime * 3 + responseTime) / 4;
+}
+
+void ZigbeeNode::finishInitRequest()
+{
+    m_pendingInitRequests--;
+    if (m_pendingInitRequests > 0)
+        return;
+
+    // Note: if we are initializing the coordinator, we can stop here
+    if (m_initEndpointsFailed || m_shortAddress == 0) {
+        setState(StateInitialized);
+        return;
+    }
 
-        // Create endpoint
-        ZigbeeNodeEndpoint *endpoint = nullptr;
-        if (!hasEndpoint(endpointId)) {
-            endpoint = new ZigbeeNodeEndpoint(m_network, this, endpointId, this);
-            m_endpoints.append(endpoint);
+    // Node descriptor and active endpoints are known, check if we know this kind of device already
+    if (m_initTemplateLookupPending) {
+        m_initTemplateLookupPending = false;
+        if (m_nodeDescriptorAvailable && m_network->findInterviewTemplate(m_nodeDescriptor.manufacturerCode, m_uninitializedEndpoints, &m_interviewTemplate)) {
+            initFromInterviewTemplate();
         } else {
-            endpoint = getEndpoint(endpointId);
-        }
-        endpoint->setProfile(static_cast<Zigbee::ZigbeeProfile>(profileId));
-        endpoint->setDeviceId(deviceId);
-        endpoint->setDeviceVersion(deviceVersion);
-
-        // Parse and add server clusters
-        qCDebug(dcZigbeeNode()) << "    Input clusters: (" << inputClusterCount << ")";
-        for (int i = 0; i < inputClusterCount; i++) {
-            quint16 clusterId = 0;
-            stream >> clusterId;
-            if (!endpoint->hasInputCluster(static_cast<ZigbeeClusterLibrary::ClusterId>(clusterId))) {
-                endpoint->addInputCluster(endpoint->createCluster(static_cast<ZigbeeClusterLibrary::ClusterId>(clusterId), ZigbeeCluster::Server));
-            }
-            qCDebug(dcZigbeeNode()) << "        Cluster ID:" << ZigbeeUtils::convertUint16ToHexString(clusterId) << ZigbeeUtils::clusterIdToString(static_cast<ZigbeeClusterLibrary::ClusterId>(clusterId));
+            initRemainingDescriptors();
         }
+        return;
+    }
 
-        // Parse and add client clusters
-        stream >> outputClusterCount;
-        qCDebug(dcZigbeeNode()) << "    Output clusters: (" << outputClusterCount << ")";
-        for (int i = 0; i < outputClusterCount; i++) {
-            quint16 clusterId = 0;
-            stream >> clusterId;
-            if (!endpoint->hasOutputCluster(static_cast<ZigbeeClusterLibrary::ClusterId>(clusterId))) {
-                endpoint->addOutputCluster(endpoint->createCluster(static_cast<ZigbeeClusterLibrary::ClusterId>(clusterId), ZigbeeCluster::Client));
-            }
-            qCDebug(dcZigbeeNode()) << "        Cluster ID:" << ZigbeeUtils::convertUint16ToHexString(clusterId) << ZigbeeUtils::clusterIdToString(static_cast<ZigbeeClusterLibrary::ClusterId>(clusterId));
+    // Continue with the basic cluster attributes
+    initBasicCluster();
+}
+
+void ZigbeeNode::initRemainingDescriptors()
+{
+    m_pendingInitRequests = 1 + m_uninitializedEndpoints.count();
+    initPowerDescriptor();
+    foreach (quint8 endpointId, m_uninitializedEndpoints) {
+        initEndpoint(endpointId);
+    }
+}
+
+void ZigbeeNode::initFromInterviewTemplate()
+{
+    qCDebug(dcZigbeeNode()) << "Initialize" << this << "from interview template" << m_interviewTemplate.modelName << m_interviewTemplate.version;
+    m_initFromTemplate = true;
+    if (m_interviewTemplate.powerDescriptor != 0x0000) {
+        m_powerDescriptor = ZigbeeDeviceProfile::parsePowerDescriptor(m_interviewTemplate.powerDescriptor);
+        m_powerDescriptorAvailable = true;
+    }
+
+    foreach (const QByteArray &simpleDescriptor, m_interviewTemplate.simpleDescriptors) {
+        setupEndpoint(simpleDescriptor);
+    }
+
+    // The basic cluster attributes verify the template
+    initBasicCluster();
+}
+
+void ZigbeeNode::finishInitialization()
+{
+    if (m_initFromTemplate) {
+        m_initFromTemplate = false;
+        if (m_manufacturerName == m_interviewTemplate.manufacturerName && m_modelName == m_interviewTemplate.modelName && m_version == m_interviewTemplate.version) {
+            qCDebug(dcZigbeeNode()) << this << "matches the interview template" << m_interviewTemplate.modelName << m_interviewTemplate.version;
+            setState(StateInitialized);
+            return;
         }
 
-        m_uninitializedEndpoints.removeAll(endpointId);
-        endpoint->m_initialized = true;
+        qCWarning(dcZigbeeNode()) << this << "does not match the interview template" << m_interviewTemplate.modelName << m_interviewTemplate.version;
 
-        setupEndpointInternal(endpoint);
+        // The lookup only knew the manufacturer code and the endpoints, so the template might belong to another model
+        // of the same vendor. Only drop it if it has been stored for exactly this model and version.
+        if (m_interviewTemplate.manufacturerCode == m_nodeDescriptor.manufacturerCode && m_interviewTemplate.modelName == m_modelName && m_interviewTemplate.version == m_version) {
+            m_network->removeInterviewTemplate(m_interviewTemplate);
+        }
+
+        // Now that the model is known, check if there is a template for it
+        ZigbeeNodeInterviewTemplate modelTemplate;
+        bool modelTemplateFound = m_network->findInterviewTemplate(m_nodeDescriptor.manufacturerCode, m_modelName, m_version, &modelTemplate)
+                && modelTemplate.manufacturerName == m_manufacturerName && modelTemplate.endpoints == m_interviewTemplate.endpoints;
 
-        if (m_uninitializedEndpoints.isEmpty()) {
-            // Note: if we are initializing the coordinator, we can stop here
-            if (m_shortAddress == 0) {
-                setState(StateInitialized);
+        // This is called from within the basic cluster reply, drop the endpoints created from the template once that has been processed
+        quint32 generation = m_initGeneration;
+        QTimer::singleShot(0, this, [this, generation, modelTemplateFound, modelTemplate](){
+            if (generation != m_initGeneration)
                 return;
+
+            qDeleteAll(m_endpoints);
+            m_endpoints.clear();
+            if (modelTemplateFound) {
+                m_interviewTemplate = modelTemplate;
+                initFromInterviewTemplate();
+            } else {
+                qCDebug(dcZigbeeNode()) << "Reading all descriptors from" << this;
+                m_uninitializedEndpoints = m_interviewTemplate.endpoints;
+                initRemainingDescriptors();
             }
+        });
+        return;
+    }
 
-            // Continue with the basic cluster attributes
-            initBasicCluster();
-        } else {
-            // Fetch next endpoint
-            initEndpoint(m_uninitializedEndpoints.first());
-        }
-    });
+    // Remember the interview results, so nodes of the same model can be initialized without reading all descriptors
+    if (m_network->interviewCacheEnabled() && m_nodeDescriptorAvailable && !m_modelName.isEmpty()
+            && !m_endpoints.isEmpty() && m_simpleDescriptors.count() == m_endpoints.count()) {
+        ZigbeeNodeInterviewTemplate interviewTemplate;
+        interviewTemplate.manufacturerCode = m_nodeDescriptor.manufacturerCode;
+        interviewTemplate.manufacturerName = m_manufacturerName;
+        interviewTemplate.modelName = m_modelName;
+        interviewTemplate.version = m_version;
+        interviewTemplate.powerDescriptor = m_powerDescriptorAvailable ? m_powerDescriptor.powerDescriptoFlag : 0x0000;
+        interviewTemplate.endpoints = m_simpleDescriptors.keys();
+        interviewTemplate.simpleDescriptors = m_simpleDescriptors.values();
+        m_network->saveInterviewTemplate(interviewTemplate);
+    }
+
+    setState(StateInitialized);
 }
 
 void ZigbeeNode::removeNextBinding(ZigbeeReply *reply)
@@ -578,7 +744,7 @@ void ZigbeeNode::initBasicCluster()
 
     if (!endpoint) {
         qCWarning(dcZigbeeNode()) << "Could not find any endpoint contiaining the basic cluster on" << this << "Set the node to initialized anyways.";
-        setState(StateInitialized);
+        finishInitialization();
         return;
     }
 
@@ -586,180 +752,108 @@ void ZigbeeNode::initBasicCluster()
     if (!basicCluster) {
         qCWarning(dcZigbeeNode()) << "Could not find basic cluster on" << this << "Set the node to initialized anyways.";
         // Set the device initialized any ways since this ist just for convenience
-        setState(StateInitialized);
+        finishInitialization();
         return;
     }
 
-    // Start reading basic cluster attributes sequentially
-    readManufacturerName(basicCluster);
-}
-
-void ZigbeeNode::readManufacturerName(ZigbeeClusterBasic *basicCluster)
-{
-    ZigbeeClusterBasic::Attribute attributeId = ZigbeeClusterBasic::AttributeManufacturerName;
-    if (basicCluster->hasAttribute(attributeId)) {
-        // Note: only read the basic cluster information if we don't have them already from an indication.
-        // Some devices (Lumi/Aquara) send cluster information containing different payload than a read attribute returns.
-        // This is bad device stack implementation, but we want to make it work either way without destroying the correct
-        // workflow as specified by the stack.
-        qCDebug(dcZigbeeNode()) << "The manufacturer name has already been set" << this << "Continue with model identifier";
-        bool valueOk = false;
-        QString manufacturerName = basicCluster->attribute(attributeId).dataType().toString(&valueOk);
-        if (valueOk) {
-            endpoints().first()->m_manufacturerName = manufacturerName;
-            m_manufacturerName = manufacturerName;
-            emit manufacturerNameChanged(m_manufacturerName);
+    // Note: only read the manufacturer name and model identifier if we don't have them already from an indication.
+    // Some devices (Lumi/Aquara) send cluster information containing different payload than a read attribute returns.
+    // This is bad device stack implementation, but we want to make it work either way without destroying the correct
+    // workflow as specified by the stack.
+    QList<quint16> attributeIds;
+    QList<quint16> cachedAttributeIds = { ZigbeeClusterBasic::AttributeManufacturerName, ZigbeeClusterBasic::AttributeModelIdentifier };
+    foreach (quint16 attributeId, cachedAttributeIds) {
+        if (basicCluster->hasAttribute(attributeId)) {
+            qCDebug(dcZigbeeNode()) << "The basic cluster attribute" << static_cast<ZigbeeClusterBasic::Attribute>(attributeId) << "has already been set" << this;
+            setBasicClusterInformation(attributeId, basicCluster->attribute(attributeId).dataType());
         } else {
-            qCWarning(dcZigbeeNode()) << "Could not convert manufacturer name attribute data to string" << basicCluster->attribute(attributeId).dataType();
+            attributeIds.append(attributeId);
         }
-
-        readModelIdentifier(basicCluster);
-        return;
     }
+    attributeIds.append(ZigbeeClusterBasic::AttributeSwBuildId);
+
+    // Read all remaining basic cluster attributes with one request
+    readBasicClusterAttributes(basicCluster, attributeIds);
+}
+
+void ZigbeeNode::readBasicClusterAttributes(ZigbeeClusterBasic *basicCluster, const QList<quint16> &attributeIds, int attempt)
+{
+    qCDebug(dcZigbeeNode()) << "Reading basic cluster attributes" << attributeIds << "from" << this;
+    qint64 requestTimestamp = ZigbeeUtils::monotonicMilliseconds();
+    quint32 generation = m_initGeneration;
+    ZigbeeClusterReply *reply = basicCluster->readAttributes(attributeIds);
+    connect(reply, &ZigbeeClusterReply::finished, this, [this, basicCluster, reply, attributeIds, attempt, requestTimestamp, generation](){
+        // Ignore responses of a previous initialization run
+        if (generation != m_initGeneration)
+            return;
 
-    qCDebug(dcZigbeeNode()) << "Reading attribute" << attributeId;
-    ZigbeeClusterReply *reply = basicCluster->readAttributes({static_cast<quint16>(attributeId)});
-    connect(reply, &ZigbeeClusterReply::finished, this, [this, basicCluster, reply, attributeId](){
         if (reply->error() != ZigbeeClusterReply::ErrorNoError) {
-            qCWarning(dcZigbeeNode()) << "Error occured during initialization of" << this << "Failed to read basic cluster attribute" << attributeId << reply->error();
-            if (m_requestRetry < m_requestRetriesMax) {
-                m_requestRetry++;
-                qCDebug(dcZigbeeNode()) << "Retry to read manufacturer name from" << this << basicCluster << m_requestRetry << "/" << m_requestRetriesMax << "attempts.";
-                QTimer::singleShot(500, this, [=](){ readManufacturerName(basicCluster); });
+            qCWarning(dcZigbeeNode()) << "Error occured during initialization of" << this << "Failed to read basic cluster attributes" << attributeIds << reply->error();
+            if (attempt < m_requestRetriesMax) {
+                qCDebug(dcZigbeeNode()) << "Retry to read basic cluster attributes from" << this << basicCluster << attempt + 1 << "/" << m_requestRetriesMax << "attempts.";
+                QTimer::singleShot(initRetryDelay(attempt), this, [=](){ if (generation == m_initGeneration) readBasicClusterAttributes(basicCluster, attributeIds, attempt + 1); });
             } else {
-                qCWarning(dcZigbeeNode()) << "Failed to read manufacturer name from" << this << basicCluster << "after" << m_requestRetriesMax << "attempts. Giving up and continue...";
-                m_requestRetry = 0;
-                readModelIdentifier(basicCluster);
+                qCWarning(dcZigbeeNode()) << "Failed to read basic cluster attributes from" << this << basicCluster << "after" << m_requestRetriesMax << "attempts. Giving up and continue...";
+                finishInitialization();
             }
             return;
         }
 
         qCDebug(dcZigbeeNode()) << "Reading basic cluster attributes finished successfully";
-        QList<ZigbeeClusterLibrary::ReadAttributeStatusRecord> attributeStatusRecords = ZigbeeClusterLibrary::parseAttributeStatusRecords(reply->responseFrame().payload);
-        if (!attributeStatusRecords.isEmpty()) {
-            ZigbeeClusterLibrary::ReadAttributeStatusRecord attributeStatusRecord = attributeStatusRecords.first();
+        updateInitResponseTime(requestTimestamp);
+        QList<quint16> remainingAttributeIds = attributeIds;
+        QList<ZigbeeClusterLibrary::ReadAttributeStatusRecord> attributeStatusRecords = ZigbeeClusterLibrary::parseAttributeStatusRecords(reply->responseFrame().payload, true);
+        foreach (const ZigbeeClusterLibrary::ReadAttributeStatusRecord &attributeStatusRecord, attributeStatusRecords) {
             qCDebug(dcZigbeeNode()) << attributeStatusRecord;
-            basicCluster->setAttribute(ZigbeeClusterAttribute(static_cast<quint16>(attributeId), attributeStatusRecord.dataType));
-            bool valueOk = false;
-            QString manufacturerName = attributeStatusRecord.dataType.toString(&valueOk);
-            if (valueOk) {
-                endpoints().first()->m_manufacturerName = manufacturerName;
-                m_manufacturerName = manufacturerName;
-                emit manufacturerNameChanged(m_manufacturerName);
-            } else {
-                qCWarning(dcZigbeeNode()) << "Could not convert manufacturer name attribute data to string" << attributeStatusRecord.dataType;
+            remainingAttributeIds.removeAll(attributeStatusRecord.attributeId);
+            if (attributeStatusRecord.attributeStatus != ZigbeeClusterLibrary::StatusSuccess) {
+                qCWarning(dcZigbeeNode()) << "Reading basic cluster attribute from" << this << "returned an error" << attributeStatusRecord;
+                continue;
             }
-        }
 
-        // Continue eiterh way with attribute reading
-        m_requestRetry = 0;
-        readModelIdentifier(basicCluster);
-    });
-}
-
-void ZigbeeNode::readModelIdentifier(ZigbeeClusterBasic *basicCluster)
-{
-    ZigbeeClusterBasic::Attribute attributeId = ZigbeeClusterBasic::AttributeModelIdentifier;
-    if (basicCluster->hasAttribute(attributeId)) {
-        // Note: only read the basic cluster information if we don't have them already from an indication.
-        // Some devices (Lumi/Aquara) send cluster information containing different payload than a read attribute returns.
-        // This is bad device stack implementation, but we want to make it work either way without destroying the correct
-        // workflow as specified by the stack.
-        qCDebug(dcZigbeeNode()) << "The model identifier has already been set" << this << "Continue with software build ID.";
-        bool valueOk = false;
-        QString modelIdentifier = basicCluster->attribute(attributeId).dataType().toString(&valueOk);
-        if (valueOk) {
-            endpoints().first()->m_modelIdentifier= modelIdentifier;
-            m_modelName = modelIdentifier;
-            emit modelNameChanged(m_modelName);
-        } else {
-            qCWarning(dcZigbeeNode()) << "Could not convert model identifier attribute data to string" << basicCluster->attribute(attributeId).dataType();
+            basicCluster->setAttribute(ZigbeeClusterAttribute(attributeStatusRecord.attributeId, attributeStatusRecord.dataType));
+            setBasicClusterInformation(attributeStatusRecord.attributeId, attributeStatusRecord.dataType);
         }
 
-        readSoftwareBuildId(basicCluster);
-        return;
-    }
-
-    qCDebug(dcZigbeeNode()) << "Reading attribute" << attributeId;
-    ZigbeeClusterReply *reply = basicCluster->readAttributes({static_cast<quint16>(attributeId)});
-    connect(reply, &ZigbeeClusterReply::finished, this, [this, basicCluster, reply, attributeId](){
-        if (reply->error() != ZigbeeClusterReply::ErrorNoError) {
-            qCWarning(dcZigbeeNode()) << "Error occured during initialization of" << this << "Failed to read basic cluster attribute" << attributeId << reply->error();
-            if (m_requestRetry < m_requestRetriesMax) {
-                m_requestRetry++;
-                qCDebug(dcZigbeeNode()) << "Retry to read model identifier from" << this << basicCluster << m_requestRetry << "/" << m_requestRetriesMax << "attempts.";
-                QTimer::singleShot(500, this, [=](){ readModelIdentifier(basicCluster); });
-            } else {
-                qCWarning(dcZigbeeNode()) << "Failed to read model identifier from" << this << basicCluster << "after" << m_requestRetriesMax << "attempts. Giving up and continue...";
-                m_requestRetry = 0;
-                readSoftwareBuildId(basicCluster);
-            }
+        // If the response did not fit into one frame, the node returns only the first records. Read the rest of them.
+        if (!attributeStatusRecords.isEmpty() && !remainingAttributeIds.isEmpty()) {
+            readBasicClusterAttributes(basicCluster, remainingAttributeIds);
             return;
         }
 
-        qCDebug(dcZigbeeNode()) << "Reading basic cluster attributes finished successfully";
-        QList<ZigbeeClusterLibrary::ReadAttributeStatusRecord> attributeStatusRecords = ZigbeeClusterLibrary::parseAttributeStatusRecords(reply->responseFrame().payload);
-        if (!attributeStatusRecords.isEmpty()) {
-            ZigbeeClusterLibrary::ReadAttributeStatusRecord attributeStatusRecord = attributeStatusRecords.first();
-            qCDebug(dcZigbeeNode()) << attributeStatusRecord;
-            basicCluster->setAttribute(ZigbeeClusterAttribute(static_cast<quint16>(attributeId), attributeStatusRecord.dataType));
-            bool valueOk = false;
-            QString modelIdentifier = attributeStatusRecord.dataType.toString(&valueOk);
-            if (valueOk) {
-                endpoints().first()->m_modelIdentifier = modelIdentifier;
-                m_modelName = modelIdentifier;
-                emit modelNameChanged(m_modelName);
-            } else {
-                qCWarning(dcZigbeeNode()) << "Could not convert model identifier attribute data to string" << attributeStatusRecord.dataType;
-            }
-        }
-
-        // Continue eiterh way with attribute reading
-        m_requestRetry = 0;
-        readSoftwareBuildId(basicCluster);
+        // Finished with reading basic cluster, the node is initialized.
+        finishInitialization();
     });
 }
 
-void ZigbeeNode::readSoftwareBuildId(ZigbeeClusterBasic *basicCluster)
+void ZigbeeNode::setBasicClusterInformation(quint16 attributeId, const ZigbeeDataType &dataType)
 {
-    ZigbeeClusterBasic::Attribute attributeId = ZigbeeClusterBasic::AttributeSwBuildId;
-    qCDebug(dcZigbeeNode()) << "Reading attribute" << attributeId;
-    ZigbeeClusterReply *reply = basicCluster->readAttributes({static_cast<quint16>(attributeId)});
-    connect(reply, &ZigbeeClusterReply::finished, this, [this, basicCluster, reply, attributeId](){
-        if (reply->error() != ZigbeeClusterReply::ErrorNoError) {
-            qCWarning(dcZigbeeNode()) << "Error occured during initialization of" << this << "Failed to read basic cluster attribute" << attributeId << reply->error();
-            if (m_requestRetry < m_requestRetriesMax) {
-                m_requestRetry++;
-                qCDebug(dcZigbeeNode()) << "Retry to read model identifier from" << this << basicCluster << m_requestRetry << "/" << m_requestRetriesMax << "attempts.";
-                QTimer::singleShot(500, this, [=](){ readSoftwareBuildId(basicCluster); });
-            } else {
-                qCWarning(dcZigbeeNode()) << "Failed to read model identifier from" << this << basicCluster << "after" << m_requestRetriesMax << "attempts. Giving up and continue...";
-                m_requestRetry = 0;
-                setState(StateInitialized);
-            }
-            return;
-        }
-
-        qCDebug(dcZigbeeNode()) << "Reading basic cluster attributes finished successfully";
-        QList<ZigbeeClusterLibrary::ReadAttributeStatusRecord> attributeStatusRecords = ZigbeeClusterLibrary::parseAttributeStatusRecords(reply->responseFrame().payload);
-        if (!attributeStatusRecords.isEmpty()) {
-            ZigbeeClusterLibrary::ReadAttributeStatusRecord attributeStatusRecord = attributeStatusRecords.first();
-            qCDebug(dcZigbeeNode()) << attributeStatusRecord;
-            basicCluster->setAttribute(ZigbeeClusterAttribute(static_cast<quint16>(attributeId), attributeStatusRecord.dataType));
-            bool valueOk = false;
-            QString softwareBuildId = attributeStatusRecord.dataType.toString(&valueOk);
-            if (valueOk) {
-                endpoints().first()->m_softwareBuildId = softwareBuildId;
-                m_version = softwareBuildId;
-                emit versionChanged(m_version);
-            } else {
-                qCWarning(dcZigbeeNode()) << "Could not convert software build id attribute data to string" << attributeStatusRecord.dataType;
-            }
-        }
+    bool valueOk = false;
+    QString value = dataType.toString(&valueOk);
+    if (!valueOk) {
+        qCWarning(dcZigbeeNode()) << "Could not convert basic cluster attribute" << static_cast<ZigbeeClusterBasic::Attribute>(attributeId) << "data to string" << dataType;
+        return;
+    }
 
-        // Finished with reading basic cluster, the node is initialized.
-        setState(StateInitialized);
-    });
+    switch (attributeId) {
+    case ZigbeeClusterBasic::AttributeManufacturerName:
+        endpoints().first()->m_manufacturerName = value;
+        m_manufacturerName = value;
+        emit manufacturerNameChanged(m_manufacturerName);
+        break;
+    case ZigbeeClusterBasic::AttributeModelIdentifier:
+        endpoints().first()->m_modelIdentifier = value;
+        m_modelName = value;
+        emit modelNameChanged(m_modelName);
+        break;
+    case ZigbeeClusterBasic::AttributeSwBuildId:
+        endpoints().first()->m_softwareBuildId = value;
+        m_version = value;
+        emit versionChanged(m_version);
+        break;
+    default:
+        break;
+    }
 }
 
 void ZigbeeNode::handleDataIndication(const Zigbee::ApsdeDataIndication &indication)
@@ -772,10 +866,13 @@ void ZigbeeNode::handleDataIndication(const Zigbee::ApsdeDataIndication &indicat
     // Data received from this node, it is reachable for sure
     setReachable(true);
 
-    // Update the UTC timestamp of last seen for reachable verification
-    if (m_lastSeen != QDateTime::currentDateTimeUtc()) {
-        m_lastSeen = QDateTime::currentDateTimeUtc();
-        emit lastSeenChanged(m_lastSeen);
+    // Update the monotonic timestamp of last seen for reachable verification and
+    // publish it only once it moved more than the configured granularity
+    m_lastSeen = ZigbeeUtils::monotonicMilliseconds();
+    if (!m_lastSeenAvailable || m_lastSeen - m_lastSeenReported >= m_network->lastSeenGranularity()) {
+        m_lastSeenAvailable = true;
+        m_lastSeenReported = m_lastSeen;
+        emit lastSeenChanged(lastSeen());
     }
 
     // Check if this indocation is related to any pending reply
@@ -792,6 +889,13 @@ void ZigbeeNode::handleZigbeeClusterLibraryIndication(const Zigbee::ApsdeDataInd
 {
     qCDebug(dcZigbeeNode()) << "Processing ZCL indication" << indication;
 
+    // Parse the header once, the payload gets referenced by the view until the indication has been processed
+    ZigbeeClusterLibrary::FrameView frame = ZigbeeClusterLibrary::parseFrameView(indication.asdu);
+    if (!frame.valid) {
+        qCWarning(dcZigbeeNode()) << "Received an invalid ZCL indication on" << this << "Ignoring indication" << indication;
+        return;
+    }
+
     // Get the endpoint
     ZigbeeNodeEndpoint *endpoint = getEndpoint(indication.sourceEndpoint);
     if (!endpoint) {
@@ -804,11 +908,17 @@ void ZigbeeNode::handleZigbeeClusterLibraryIndication(const Zigbee::ApsdeDataInd
         m_endpoints.append(endpoint);
     }
 
-    endpoint->handleZigbeeClusterLibraryIndication(indication);
+    endpoint->handleZigbeeClusterLibraryIndication(indication, frame);
 }
 
 QDebug operator<<(QDebug debug, ZigbeeNode *node)
 {
+    // Group bound clusters have no node and endpoint
+    if (!node) {
+        debug.nospace().noquote() << "ZigbeeNode(nullptr)";
+        return debug.space();
+    }
+
     debug.nospace().noquote() << "ZigbeeNode(" << ZigbeeUtils::convertUint16ToHexString(node->shortAddress());
     debug.nospace().noquote() << ", " << node->extendedAddress().toString();
     if (!node->manufacturerName().isEmpty())
@@ -29,6 +29,7 @@
 #define ZIGBEENODE_H
 
 #include <QObject>
+#include <QMap>
 #include <QDateTime>
 
 #include "zigbee.h"
@@ -40,6 +41,17 @@
 
 class ZigbeeNetwork;
 
+// Interview results of a device model, used to initialize nodes of the same model without reading all descriptors
+typedef struct ZigbeeNodeInterviewTemplate {
+    quint16 manufacturerCode = 0;
+    QString manufacturerName;
+    QString modelName;
+    QString version;
+    quint16 powerDescriptor = 0;
+    QList<quint8> endpoints;
+    QList<QByteArray> simpleDescriptors;
+} ZigbeeNodeInterviewTemplate;
+
 class ZigbeeNode : public QObject
 {
     Q_OBJECT
@@ -79,6 +91,8 @@ public:
 
     quint8 lqi() const;
     QDateTime lastSeen() const;
+    // Milliseconds on the monotonic clock since the node has been seen the last time, 0 if never seen
+    qint64 msecsSinceLastSeen() const;
 
     // Information from descriptors
     ZigbeeDeviceProfile::NodeDescriptor nodeDescriptor() const;
@@ -115,7 +129,11 @@ private:
     bool m_reachable = false;
     State m_state = StateUninitialized;
     quint8 m_lqi = 0;
-    QDateTime m_lastSeen;
+
+    // Monotonic timestamps of the last received data and the last emitted lastSeenChanged
+    qint64 m_lastSeen = 0;
+    qint64 m_lastSeenReported = 0;
+    bool m_lastSeenAvailable = false;
 
     // Node information
     ZigbeeDeviceProfile::NodeDescriptor m_nodeDescriptor;
@@ -128,25 +146,41 @@ private:
 
     void setState(State state);
     void setReachable(bool reachable);
+    void setLastSeen(const QDateTime &lastSeen);
 
-    // Init methods
-    int m_requestRetry = 0;
+    // Init methods, independent requests are sent concurrently
     int m_requestRetriesMax = 2;
+    int m_pendingInitRequests = 0;
+    quint32 m_initGeneration = 0;
+    bool m_initEndpointsFailed = false;
+    qint64 m_initResponseTime = 250;
     QList<quint8> m_uninitializedEndpoints;
-    void initNodeDescriptor();
-    void initPowerDescriptor();
-    void initEndpoints();
-    void initEndpoint(quint8 endpointId);
+    void initNodeDescriptor(int attempt = 0);
+    void initPowerDescriptor(int attempt = 0);
+    void initEndpoints(int attempt = 0);
+    void initEndpoint(quint8 endpointId, int attempt = 0);
+    int initRetryDelay(int attempt) const;
+    void updateInitResponseTime(qint64 requestTimestamp);
+    void finishInitRequest();
+    void finishInitialization();
+
+    // Interview cache
+    bool m_initTemplateLookupPending = false;
+    bool m_initFromTemplate = false;
+    ZigbeeNodeInterviewTemplate m_interviewTemplate;
+    QMap<quint8, QByteArray> m_simpleDescriptors;
+    void initRemainingDescriptors();
+    void initFromInterviewTemplate();
 
     void removeNextBinding(ZigbeeReply *reply);
 
     void setupEndpointInternal(ZigbeeNodeEndpoint *endpoint);
+    ZigbeeNodeEndpoint *setupEndpoint(const QByteArray &simpleDescriptor);
 
     // For convenience and having base information about the first endpoint
     void initBasicCluster();
-    void readManufacturerName(ZigbeeClusterBasic *basicCluster);
-    void readModelIdentifier(ZigbeeClusterBasic *basicCluster);
-    void readSoftwareBuildId(ZigbeeClusterBasic *basicCluster);
+    void readBasicClusterAttributes(ZigbeeClusterBasic *basicCluster, const QList<quint16> &attributeIds, int attempt = 0);
+    void setBasicClusterInformation(quint16 attributeId, const ZigbeeDataType &dataType);
 
     void handleDataIndication(const Zigbee::ApsdeDataIndication &indication);
 
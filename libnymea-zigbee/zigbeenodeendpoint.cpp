@@ -248,6 +248,9 @@ void ZigbeeNodeEndpoint::addInputCluster(ZigbeeCluster *cluster)
     connect(cluster, &ZigbeeCluster::attributeChanged, this, [this, cluster](const ZigbeeClusterAttribute &attribute){
         emit clusterAttributeChanged(cluster, attribute);
     });
+    connect(cluster, &ZigbeeCluster::attributeUpdated, this, [this, cluster](const ZigbeeClusterAttribute &attribute, bool valueChanged){
+        emit clusterAttributeUpdated(cluster, attribute, valueChanged);
+    });
     emit inputClusterAdded(cluster);
 }
 
@@ -257,12 +260,14 @@ void ZigbeeNodeEndpoint::addOutputCluster(ZigbeeCluster *cluster)
     connect(cluster, &ZigbeeCluster::attributeChanged, this, [this, cluster](const ZigbeeClusterAttribute &attribute){
         emit clusterAttributeChanged(cluster, attribute);
     });
+    connect(cluster, &ZigbeeCluster::attributeUpdated, this, [this, cluster](const ZigbeeClusterAttribute &attribute, bool valueChanged){
+        emit clusterAttributeUpdated(cluster, attribute, valueChanged);
+    });
     emit outputClusterAdded(cluster);
 }
 
-void ZigbeeNodeEndpoint::handleZigbeeClusterLibraryIndication(const Zigbee::ApsdeDataIndication &indication)
+void ZigbeeNodeEndpoint::handleZigbeeClusterLibraryIndication(const Zigbee::ApsdeDataIndication &indication, const ZigbeeClusterLibrary::FrameView &frame)
 {
-    ZigbeeClusterLibrary::Frame frame = ZigbeeClusterLibrary::parseFrameData(indication.asdu);
     qCDebug(dcZigbeeEndpoint()) << "Processing ZCL indication" << this << indication << frame;
 
     // Check which kind of cluster sent this inidication, server or client
@@ -296,11 +301,17 @@ void ZigbeeNodeEndpoint::handleZigbeeClusterLibraryIndication(const Zigbee::Apsd
         break;
     }
 
-    cluster->processApsDataIndication(indication.asdu, frame);
+    cluster->processApsDataIndication(frame);
 }
 
 QDebug operator<<(QDebug debug, ZigbeeNodeEndpoint *endpoint)
 {
+    // Group bound clusters have no node and endpoint
+    if (!endpoint) {
+        debug.nospace().noquote() << "ZigbeeNodeEndpoint(nullptr)";
+        return debug.space();
+    }
+
     debug.nospace().noquote() << "ZigbeeNodeEndpoint(" << ZigbeeUtils::convertByteToHexString(endpoint->endpointId());
     debug.nospace().noquote() << ", " << endpoint->profile();
     if (endpoint->profile() == Zigbee::ZigbeeProfileLightLink) {
@@ -161,13 +161,14 @@ private:
     void addInputCluster(ZigbeeCluster *cluster);
     void addOutputCluster(ZigbeeCluster *cluster);
 
-    void handleZigbeeClusterLibraryIndication(const Zigbee::ApsdeDataIndication &indication);
+    void handleZigbeeClusterLibraryIndication(const Zigbee::ApsdeDataIndication &indication, const ZigbeeClusterLibrary::FrameView &frame);
 
 signals:
     void inputClusterAdded(ZigbeeCluster *cluster);
     void outputClusterAdded(ZigbeeCluster *cluster);
 
     void clusterAttributeChanged(ZigbeeCluster *cluster, const ZigbeeClusterAttribute &attribute);
+    void clusterAttributeUpdated(ZigbeeCluster *cluster, const ZigbeeClusterAttribute &attribute, bool valueChanged);
 
     void manufacturerNameChanged(const QString &manufacturerName);
     void modelIdentifierChanged(const QString &modelIdentifier);
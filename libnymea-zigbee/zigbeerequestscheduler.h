@@ -0,0 +1,189 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright 2013 - 2020, nymea GmbH
+* Contact: contact@nymea.io
+*
+* This file is part of nymea-zigbee.
+* This project including source code and documentation is protected by copyright law, and
+* remains the property of nymea GmbH. All rights, including reproduction, publication,
+* editing and translation, are reserved. The use of this project is subject to the terms of a
+* license agreement to be concluded with nymea GmbH in accordance with the terms
+* of use of nymea GmbH, available under https://nymea.io/license
+*
+* GNU Lesser General Public License Usage
+* Alternatively, this project may be redistributed and/or modified under the terms of the GNU
+* Lesser General Public License as published by the Free Software Foundation; version 3.
+* this project is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License along with this project.
+* If not, see <https://www.gnu.org/licenses/>.
+*
+* For any further details and any questions please contact us under contact@nymea.io
+* or see our FAQ/Licensing Information on https://nymea.io/license/faq
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ZIGBEEREQUESTSCHEDULER_H
+#define ZIGBEEREQUESTSCHEDULER_H
+
+#include <QHash>
+#include <QList>
+#include <QDebug>
+#include <QQueue>
+
+#include "zigbee.h"
+
+// Request queue for the bridge controllers. Requests are grouped into the traffic classes of
+// Zigbee::RequestPriority and a higher class is always served first. Within one class the requests
+// are served round robin per destination, so a long running interview of one node cannot starve
+// the requests to other nodes. The order of the requests for one destination is preserved.
+
+template <typename T>
+class ZigbeeRequestScheduler
+{
+public:
+    ZigbeeRequestScheduler() = default;
+
+    void enqueue(T request, Zigbee::RequestPriority priority, quint64 destination = 0)
+    {
+        PriorityClass &priorityClass = m_classes[priority];
+        QQueue<T> &queue = priorityClass.queues[destination];
+        if (queue.isEmpty())
+            priorityClass.destinations.enqueue(destination);
+
+        queue.enqueue(request);
+        priorityClass.count++;
+    }
+
+    // Put the request in front of its class, i.e. for requests which have to be sent again
+    void prepend(T request, Zigbee::RequestPriority priority, quint64 destination = 0)
+    {
+        PriorityClass &priorityClass = m_classes[priority];
+        QQueue<T> &queue = priorityClass.queues[destination];
+        priorityClass.destinations.removeAll(destination);
+        priorityClass.destinations.prepend(destination);
+        queue.prepend(request);
+        priorityClass.count++;
+    }
+
+    T dequeue()
+    {
+        return dequeue([](T) { return true; });
+    }
+
+    // Returns the next request accepted by the given predicate or a default constructed T if there is none.
+    // Only the first request of each destination is considered in order to keep the order per destination.
+    template <typename Predicate>
+    T dequeue(Predicate accept)
+    {
+        for (int i = 0; i < PriorityClassCount; i++) {
+            PriorityClass &priorityClass = m_classes[i];
+            for (int d = 0; d < priorityClass.destinations.count(); d++) {
+                quint64 destination = priorityClass.destinations.at(d);
+                QQueue<T> &queue = priorityClass.queues[destination];
+                if (!accept(queue.head()))
+                    continue;
+
+                T request = queue.dequeue();
+                priorityClass.count--;
+                priorityClass.destinations.removeAt(d);
+                if (queue.isEmpty()) {
+                    priorityClass.queues.remove(destination);
+                } else {
+                    // Give the other destinations a turn
+                    priorityClass.destinations.enqueue(destination);
+                }
+                return request;
+            }
+        }
+
+        return T();
+    }
+
+    bool remove(T request)
+    {
+        for (int i = 0; i < PriorityClassCount; i++) {
+            PriorityClass &priorityClass = m_classes[i];
+            for (int d = 0; d < priorityClass.destinations.count(); d++) {
+                quint64 destination = priorityClass.destinations.at(d);
+                QQueue<T> &queue = priorityClass.queues[destination];
+                if (!queue.removeOne(request))
+                    continue;
+
+                priorityClass.count--;
+                if (queue.isEmpty()) {
+                    priorityClass.queues.remove(destination);
+                    priorityClass.destinations.removeAt(d);
+                }
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Removes all requests, ordered by priority
+    QList<T> takeAll()
+    {
+        QList<T> requests;
+        for (int i = 0; i < PriorityClassCount; i++) {
+            PriorityClass &priorityClass = m_classes[i];
+            foreach (quint64 destination, priorityClass.destinations) {
+                requests.append(priorityClass.queues.value(destination));
+            }
+            priorityClass.queues.clear();
+            priorityClass.destinations.clear();
+            priorityClass.count = 0;
+        }
+        return requests;
+    }
+
+    bool isEmpty() const
+    {
+        return count() == 0;
+    }
+
+    int count() const
+    {
+        int count = 0;
+        for (int i = 0; i < PriorityClassCount; i++)
+            count += m_classes[i].count;
+
+        return count;
+    }
+
+    // Queue depth of the given traffic class
+    int count(Zigbee::RequestPriority priority) const
+    {
+        return m_classes[priority].count;
+    }
+
+private:
+    Q_DISABLE_COPY(ZigbeeRequestScheduler)
+
+    static const int PriorityClassCount = Zigbee::RequestPriorityBackground + 1;
+
+    typedef struct PriorityClass {
+        QHash<quint64, QQueue<T>> queues;
+        QQueue<quint64> destinations; // Round robin order of the destinations with pending requests
+        int count = 0;
+    } PriorityClass;
+
+    PriorityClass m_classes[PriorityClassCount];
+
+};
+
+template <typename T>
+QDebug operator<<(QDebug debug, const ZigbeeRequestScheduler<T> &scheduler)
+{
+    debug.nospace() << "RequestQueue(";
+    debug.nospace() << "Inbound: " << scheduler.count(Zigbee::RequestPriorityInbound) << ", ";
+    debug.nospace() << "User: " << scheduler.count(Zigbee::RequestPriorityUser) << ", ";
+    debug.nospace() << "Interview: " << scheduler.count(Zigbee::RequestPriorityInterview) << ", ";
+    debug.nospace() << "Background: " << scheduler.count(Zigbee::RequestPriorityBackground) << ")";
+    return debug.space();
+}
+
+#endif // ZIGBEEREQUESTSCHEDULER_H
@@ -0,0 +1,267 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright 2013 - 2020, nymea GmbH
+* Contact: contact@nymea.io
+*
+* This file is part of nymea-zigbee.
+* This project including source code and documentation is protected by copyright law, and
+* remains the property of nymea GmbH. All rights, including reproduction, publication,
+* editing and translation, are reserved. The use of this project is subject to the terms of a
+* license agreement to be concluded with nymea GmbH in accordance with the terms
+* of use of nymea GmbH, available under https://nymea.io/license
+*
+* GNU Lesser General Public License Usage
+* Alternatively, this project may be redistributed and/or modified under the terms of the GNU
+* Lesser General Public License as published by the Free Software Foundation; version 3.
+* this project is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License along with this project.
+* If not, see <https://www.gnu.org/licenses/>.
+*
+* For any further details and any questions please contact us under contact@nymea.io
+* or see our FAQ/Licensing Information on https://nymea.io/license/faq
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "zigbeeslipframer.h"
+#include "zigbeeutils.h"
+#include "loggingcategory.h"
+
+#include <string.h>
+
+ZigbeeSlipFramer::ZigbeeSlipFramer(ChecksumType checksumType, bool leadingEnd, int capacity) :
+    m_checksumType(checksumType),
+    m_leadingEnd(leadingEnd)
+{
+    m_buffer.resize(capacity);
+}
+
+ZigbeeSlipFramer::ChecksumType ZigbeeSlipFramer::checksumType() const
+{
+    return m_checksumType;
+}
+
+int ZigbeeSlipFramer::checksumLength() const
+{
+    return m_checksumType == ChecksumTypeSum16 ? 2 : 1;
+}
+
+qint64 ZigbeeSlipFramer::readFrom(QIODevice *device)
+{
+    qint64 available = device->bytesAvailable();
+    if (available <= 0)
+        return 0;
+
+    if (!reserve(static_cast<int>(available)))
+        return -1;
+
+    qint64 bytesRead = device->read(m_buffer.data() + m_end, available);
+    if (bytesRead > 0)
+        m_end += static_cast<int>(bytesRead);
+
+    return bytesRead;
+}
+
+bool ZigbeeSlipFramer::takeFrame(QByteArray *package)
+{
+    char *buffer = m_buffer.data();
+    while (m_scanned < m_end) {
+        char *endByte = static_cast<char *>(memchr(buffer + m_scanned, ProtocolByteEnd, static_cast<size_t>(m_end - m_scanned)));
+        if (!endByte) {
+            m_scanned = m_end;
+            break;
+        }
+
+        char *frame = buffer + m_begin;
+        int frameLength = static_cast<int>(endByte - frame);
+        m_begin = m_scanned = static_cast<int>(endByte - buffer) + 1;
+
+        // If there is no data...continue since it might be a starting END byte
+        if (frameLength == 0)
+            continue;
+
+        qCDebug(dcZigbeeInterfaceTraffic()) << "<--" << ZigbeeUtils::convertByteArrayToHexString(QByteArray::fromRawData(frame, frameLength));
+        frameLength = unescapeInPlace(frame, frameLength);
+        if (frameLength < 0) {
+            qCWarning(dcZigbeeInterface()) << "Received inconsistant message. Ignoring data";
+            continue;
+        }
+
+        int packageLength = frameLength - checksumLength();
+        if (packageLength <= 0) {
+            qCWarning(dcZigbeeInterface()) << "Received frame is too short. Ignoring data" << ZigbeeUtils::convertByteArrayToHexString(QByteArray(frame, frameLength));
+            continue;
+        }
+
+        quint16 receivedChecksum = static_cast<quint8>(frame[packageLength]);
+        if (m_checksumType == ChecksumTypeSum16)
+            receivedChecksum |= static_cast<quint16>(static_cast<quint8>(frame[packageLength + 1]) << 8);
+
+        quint16 calculatedChecksum = calculateChecksum(frame, packageLength);
+        if (receivedChecksum != calculatedChecksum) {
+            qCWarning(dcZigbeeInterfaceTraffic()) << "Checksum verification failed for frame" << ZigbeeUtils::convertByteArrayToHexString(QByteArray(frame, frameLength)) << receivedChecksum << "!=" << calculatedChecksum;
+            continue;
+        }
+
+        // Checksum verified, we got valid data
+        *package = QByteArray(frame, packageLength);
+        qCDebug(dcZigbeeInterface()) << "Received frame" << ZigbeeUtils::convertByteArrayToHexString(QByteArray::fromRawData(frame, frameLength));
+        if (m_begin == m_end)
+            m_begin = m_scanned = m_end = 0;
+
+        return true;
+    }
+
+    // Everything consumed, start again at the beginning of the buffer
+    if (m_begin == m_end)
+        m_begin = m_scanned = m_end = 0;
+
+    return false;
+}
+
+void ZigbeeSlipFramer::clear()
+{
+    m_begin = 0;
+    m_scanned = 0;
+    m_end = 0;
+}
+
+QByteArray ZigbeeSlipFramer::encode(const QByteArray &package) const
+{
+    // Build the frame and escape the package data and crc
+    quint16 checksum = calculateChecksum(package.constData(), package.length());
+    char checksumBytes[2] = { static_cast<char>(checksum & 0xFF), static_cast<char>((checksum >> 8) & 0xFF) };
+    int checksumBytesLength = checksumLength();
+
+    // Size the transport data in one pass so it gets allocated only once
+    int escapeCount = 0;
+    for (int i = 0; i < package.length(); i++) {
+        quint8 byte = static_cast<quint8>(package.at(i));
+        if (byte == ProtocolByteEnd || byte == ProtocolByteEsc) {
+            escapeCount++;
+        }
+    }
+    for (int i = 0; i < checksumBytesLength; i++) {
+        quint8 byte = static_cast<quint8>(checksumBytes[i]);
+        if (byte == ProtocolByteEnd || byte == ProtocolByteEsc) {
+            escapeCount++;
+        }
+    }
+
+    QByteArray data(package.length() + checksumBytesLength + escapeCount + (m_leadingEnd ? 2 : 1), Qt::Uninitialized);
+    char *out = data.data();
+
+    // Start with SLIP END character if required
+    if (m_leadingEnd)
+        *out++ = static_cast<char>(ProtocolByteEnd);
+
+    auto escape = [&out](const char *in, int length) {
+        for (int i = 0; i < length; i++) {
+            switch (static_cast<quint8>(in[i])) {
+            case ProtocolByteEnd:
+                *out++ = static_cast<char>(ProtocolByteEsc);
+                *out++ = static_cast<char>(ProtocolByteTransposedEnd);
+                break;
+            case ProtocolByteEsc:
+                *out++ = static_cast<char>(ProtocolByteEsc);
+                *out++ = static_cast<char>(ProtocolByteTransposedEsc);
+                break;
+            default:
+                *out++ = in[i];
+                break;
+            }
+        }
+    };
+    escape(package.constData(), package.length());
+    escape(checksumBytes, checksumBytesLength);
+
+    // End with SLIP END character
+    *out = static_cast<char>(ProtocolByteEnd);
+    return data;
+}
+
+bool ZigbeeSlipFramer::reserve(int size)
+{
+    if (m_buffer.size() - m_end >= size)
+        return true;
+
+    // Move the partial frame to the front of the buffer
+    if (m_begin > 0) {
+        int pending = m_end - m_begin;
+        memmove(m_buffer.data(), m_buffer.constData() + m_begin, static_cast<size_t>(pending));
+        m_scanned -= m_begin;
+        m_end = pending;
+        m_begin = 0;
+    }
+
+    if (m_buffer.size() - m_end >= size)
+        return true;
+
+    // Still not enough space, the buffer has to grow
+    int requiredSize = m_end + size;
+    if (requiredSize < 0) {
+        qCWarning(dcZigbeeInterface()) << "Could not grow the receive buffer. Dropping pending data.";
+        clear();
+        return false;
+    }
+
+    m_buffer.resize(qMax(requiredSize, m_buffer.size() * 2));
+    return true;
+}
+
+quint16 ZigbeeSlipFramer::calculateChecksum(const char *data, int length) const
+{
+    if (m_checksumType == ChecksumTypeXor8) {
+        quint8 crc = 0;
+        for (int i = 0; i < length; i++) {
+            crc ^= static_cast<quint8>(data[i]);
+        }
+        return crc;
+    }
+
+    quint16 crc = 0;
+    for (int i = 0; i < length; i++) {
+        crc += static_cast<quint8>(data[i]);
+    }
+    return static_cast<quint16>(~crc + 1);
+}
+
+int ZigbeeSlipFramer::unescapeInPlace(char *data, int length) const
+{
+    // Nothing to do if the frame contains no ESC byte, which is the common case
+    char *escapeByte = static_cast<char *>(memchr(data, ProtocolByteEsc, static_cast<size_t>(length)));
+    if (!escapeByte)
+        return length;
+
+    // The unescaped frame is never longer than the escaped one, so we can write into the same memory
+    char *in = escapeByte;
+    char *out = escapeByte;
+    char *end = data + length;
+    while (in < end) {
+        if (static_cast<quint8>(*in) != ProtocolByteEsc) {
+            *out++ = *in++;
+            continue;
+        }
+
+        // If escape byte, the next byte has to be a modified byte
+        in++;
+        if (in == end) {
+            qCWarning(dcZigbeeInterfaceTraffic()) << "Error while deserialing data. Escape character received at the end of the frame.";
+            return -1;
+        }
+
+        if (static_cast<quint8>(*in) == ProtocolByteTransposedEnd) {
+            *out++ = static_cast<char>(ProtocolByteEnd);
+        } else if (static_cast<quint8>(*in) == ProtocolByteTransposedEsc) {
+            *out++ = static_cast<char>(ProtocolByteEsc);
+        } else {
+            qCWarning(dcZigbeeInterfaceTraffic()) << "Error while deserialing data. Escape character received but the escaped character was not recognized.";
+            return -1;
+        }
+        in++;
+    }
+
+    return static_cast<int>(out - data);
+}
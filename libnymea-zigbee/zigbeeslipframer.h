@@ -0,0 +1,88 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright 2013 - 2020, nymea GmbH
+* Contact: contact@nymea.io
+*
+* This file is part of nymea-zigbee.
+* This project including source code and documentation is protected by copyright law, and
+* remains the property of nymea GmbH. All rights, including reproduction, publication,
+* editing and translation, are reserved. The use of this project is subject to the terms of a
+* license agreement to be concluded with nymea GmbH in accordance with the terms
+* of use of nymea GmbH, available under https://nymea.io/license
+*
+* GNU Lesser General Public License Usage
+* Alternatively, this project may be redistributed and/or modified under the terms of the GNU
+* Lesser General Public License as published by the Free Software Foundation; version 3.
+* this project is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License along with this project.
+* If not, see <https://www.gnu.org/licenses/>.
+*
+* For any further details and any questions please contact us under contact@nymea.io
+* or see our FAQ/Licensing Information on https://nymea.io/license/faq
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ZIGBEESLIPFRAMER_H
+#define ZIGBEESLIPFRAMER_H
+
+#include <QObject>
+#include <QIODevice>
+#include <QByteArray>
+
+// SLIP: https://tools.ietf.org/html/rfc1055
+
+// Shared SLIP codec for the UART based backends. Incoming data will be read directly into a
+// preallocated receive buffer, END/ESC bytes get located using memchr and frames get unescaped in place,
+// so each valid frame is copied exactly once: into the package handed out to the interface.
+
+class ZigbeeSlipFramer
+{
+    Q_GADGET
+
+public:
+    enum ProtocolByte {
+        ProtocolByteEnd = 0xC0,
+        ProtocolByteEsc = 0xDB,
+        ProtocolByteTransposedEnd = 0xDC,
+        ProtocolByteTransposedEsc = 0xDD
+    };
+    Q_ENUM(ProtocolByte)
+
+    enum ChecksumType {
+        ChecksumTypeSum16, // 2 byte little endian two's complement sum (deCONZ)
+        ChecksumTypeXor8 // 1 byte xor (NXP)
+    };
+    Q_ENUM(ChecksumType)
+
+    explicit ZigbeeSlipFramer(ChecksumType checksumType, bool leadingEnd, int capacity = 4096);
+
+    ChecksumType checksumType() const;
+    int checksumLength() const;
+
+    // Receive
+    qint64 readFrom(QIODevice *device);
+    bool takeFrame(QByteArray *package);
+    void clear();
+
+    // Send
+    QByteArray encode(const QByteArray &package) const;
+
+private:
+    ChecksumType m_checksumType = ChecksumTypeSum16;
+    bool m_leadingEnd = true;
+
+    QByteArray m_buffer;
+    int m_begin = 0; // Start of the frame currently being received
+    int m_scanned = 0; // Bytes up to this position contain no END byte
+    int m_end = 0; // Write position of the next incoming byte
+
+    bool reserve(int size);
+    quint16 calculateChecksum(const char *data, int length) const;
+    int unescapeInPlace(char *data, int length) const;
+
+};
+
+#endif // ZIGBEESLIPFRAMER_H
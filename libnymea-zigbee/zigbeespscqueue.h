@@ -0,0 +1,98 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright 2013 - 2020, nymea GmbH
+* Contact: contact@nymea.io
+*
+* This file is part of nymea-zigbee.
+* This project including source code and documentation is protected by copyright law, and
+* remains the property of nymea GmbH. All rights, including reproduction, publication,
+* editing and translation, are reserved. The use of this project is subject to the terms of a
+* license agreement to be concluded with nymea GmbH in accordance with the terms
+* of use of nymea GmbH, available under https://nymea.io/license
+*
+* GNU Lesser General Public License Usage
+* Alternatively, this project may be redistributed and/or modified under the terms of the GNU
+* Lesser General Public License as published by the Free Software Foundation; version 3.
+* this project is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License along with this project.
+* If not, see <https://www.gnu.org/licenses/>.
+*
+* For any further details and any questions please contact us under contact@nymea.io
+* or see our FAQ/Licensing Information on https://nymea.io/license/faq
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ZIGBEESPSCQUEUE_H
+#define ZIGBEESPSCQUEUE_H
+
+#include <QAtomicInt>
+
+// Lock-free single producer / single consumer ring queue used to hand over frames between
+// an interface running in its own I/O thread and the thread of the bridge controller.
+// The capacity has to be a power of two, one slot stays always empty.
+
+template <typename T, int Capacity = 1024>
+class ZigbeeSpscQueue
+{
+    static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "The capacity of the queue must be a power of two");
+
+public:
+    ZigbeeSpscQueue() = default;
+
+    // Producer side
+    bool enqueue(const T &item)
+    {
+        int tail = m_tail.load();
+        int nextTail = (tail + 1) & (Capacity - 1);
+        if (nextTail == m_head.loadAcquire())
+            return false;
+
+        m_items[tail] = item;
+        m_tail.storeRelease(nextTail);
+        return true;
+    }
+
+    // Returns true only for the first call since the consumer acknowledged the last wake up,
+    // so a burst of frames results in one single notification of the consumer.
+    bool requestWakeUp()
+    {
+        return m_wakeUpRequested.testAndSetOrdered(0, 1);
+    }
+
+    // Consumer side, acknowledge the wake up before draining the queue
+    void acknowledgeWakeUp()
+    {
+        m_wakeUpRequested.fetchAndStoreOrdered(0);
+    }
+
+    bool dequeue(T *item)
+    {
+        int head = m_head.load();
+        if (head == m_tail.loadAcquire())
+            return false;
+
+        *item = m_items[head];
+        m_items[head] = T();
+        m_head.storeRelease((head + 1) & (Capacity - 1));
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return m_head.loadAcquire() == m_tail.loadAcquire();
+    }
+
+private:
+    Q_DISABLE_COPY(ZigbeeSpscQueue)
+
+    T m_items[Capacity];
+    QAtomicInt m_head;
+    QAtomicInt m_tail;
+    QAtomicInt m_wakeUpRequested;
+
+};
+
+#endif // ZIGBEESPSCQUEUE_H
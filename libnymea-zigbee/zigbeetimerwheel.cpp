@@ -0,0 +1,242 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright 2013 - 2020, nymea GmbH
+* Contact: contact@nymea.io
+*
+* This file is part of nymea-zigbee.
+* This project including source code and documentation is protected by copyright law, and
+* remains the property of nymea GmbH. All rights, including reproduction, publication,
+* editing and translation, are reserved. The use of this project is subject to the terms of a
+* license agreement to be concluded with nymea GmbH in accordance with the terms
+* of use of nymea GmbH, available under https://nymea.io/license
+*
+* GNU Lesser General Public License Usage
+* Alternatively, this project may be redistributed and/or modified under the terms of the GNU
+* Lesser General Public License as published by the Free Software Foundation; version 3.
+* this project is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License along with this project.
+* If not, see <https://www.gnu.org/licenses/>.
+*
+* For any further details and any questions please contact us under contact@nymea.io
+* or see our FAQ/Licensing Information on https://nymea.io/license/faq
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "zigbeetimerwheel.h"
+#include "zigbeeutils.h"
+
+#include <QThreadStorage>
+
+ZigbeeTimeout::ZigbeeTimeout(int interval) :
+    m_interval(interval)
+{
+
+}
+
+ZigbeeTimeout::~ZigbeeTimeout()
+{
+    stop();
+}
+
+int ZigbeeTimeout::interval() const
+{
+    return m_interval;
+}
+
+void ZigbeeTimeout::setInterval(int interval)
+{
+    m_interval = qMax(0, interval);
+}
+
+void ZigbeeTimeout::setCallback(const std::function<void()> &callback)
+{
+    m_callback = callback;
+}
+
+bool ZigbeeTimeout::isActive() const
+{
+    return m_wheel != nullptr;
+}
+
+void ZigbeeTimeout::start()
+{
+    stop();
+    ZigbeeTimerWheel::instance()->startTimeout(this);
+}
+
+void ZigbeeTimeout::start(int interval)
+{
+    setInterval(interval);
+    start();
+}
+
+void ZigbeeTimeout::stop()
+{
+    if (m_wheel) {
+        m_wheel->stopTimeout(this);
+    }
+}
+
+
+ZigbeeTimerWheel *ZigbeeTimerWheel::instance()
+{
+    // The wheel gets deleted once the thread finishes
+    static QThreadStorage<ZigbeeTimerWheel *> wheels;
+    if (!wheels.hasLocalData())
+        wheels.setLocalData(new ZigbeeTimerWheel());
+
+    return wheels.localData();
+}
+
+ZigbeeTimerWheel::~ZigbeeTimerWheel()
+{
+    // Detach the timeouts still active, they will never fire
+    for (int level = 0; level < s_levels; level++) {
+        for (int slot = 0; slot < s_slotCount; slot++) {
+            while (m_slots[level][slot]) {
+                unlink(m_slots[level][slot]);
+            }
+        }
+    }
+}
+
+int ZigbeeTimerWheel::resolution() const
+{
+    return s_resolution;
+}
+
+int ZigbeeTimerWheel::activeTimeouts() const
+{
+    return m_activeTimeouts;
+}
+
+ZigbeeTimerWheel::ZigbeeTimerWheel(QObject *parent) :
+    QObject(parent)
+{
+    for (int level = 0; level < s_levels; level++) {
+        for (int slot = 0; slot < s_slotCount; slot++) {
+            m_slots[level][slot] = nullptr;
+        }
+    }
+
+    m_startTime = ZigbeeUtils::monotonicMilliseconds();
+
+    m_tickTimer = new QTimer(this);
+    m_tickTimer->setInterval(s_resolution);
+    m_tickTimer->setSingleShot(false);
+    connect(m_tickTimer, &QTimer::timeout, this, &ZigbeeTimerWheel::onTick);
+}
+
+quint64 ZigbeeTimerWheel::elapsedTicks() const
+{
+    return static_cast<quint64>(ZigbeeUtils::monotonicMilliseconds() - m_startTime) / s_resolution;
+}
+
+void ZigbeeTimerWheel::startTimeout(ZigbeeTimeout *timeout)
+{
+    qint64 elapsed = ZigbeeUtils::monotonicMilliseconds() - m_startTime;
+
+    // The wheel did not tick while idle, continue with the current time
+    if (m_activeTimeouts == 0) {
+        m_currentTick = qMax(m_currentTick, static_cast<quint64>(elapsed) / s_resolution);
+        m_tickTimer->start();
+    }
+
+    // Round up, a timeout never fires before the interval passed
+    timeout->m_expiryTick = qMax(m_currentTick + 1, static_cast<quint64>(elapsed + timeout->m_interval + s_resolution - 1) / s_resolution);
+    timeout->m_wheel = this;
+    m_activeTimeouts++;
+    insert(timeout);
+}
+
+void ZigbeeTimerWheel::stopTimeout(ZigbeeTimeout *timeout)
+{
+    unlink(timeout);
+    if (m_activeTimeouts == 0) {
+        m_tickTimer->stop();
+    }
+}
+
+void ZigbeeTimerWheel::insert(ZigbeeTimeout *timeout)
+{
+    // Pick the lowest level covering the remaining ticks
+    quint64 remainingTicks = timeout->m_expiryTick - m_currentTick;
+    int level = 0;
+    while (level < s_levels - 1 && remainingTicks >= (Q_UINT64_C(1) << (s_levelBits * (level + 1))))
+        level++;
+
+    // Longer timeouts fire at the end of the wheel range
+    quint64 range = Q_UINT64_C(1) << (s_levelBits * s_levels);
+    if (remainingTicks >= range)
+        timeout->m_expiryTick = m_currentTick + range - 1;
+
+    int slot = static_cast<int>((timeout->m_expiryTick >> (s_levelBits * level)) & (s_slotCount - 1));
+    timeout->m_slot = &m_slots[level][slot];
+    timeout->m_previous = nullptr;
+    timeout->m_next = *timeout->m_slot;
+    if (timeout->m_next)
+        timeout->m_next->m_previous = timeout;
+
+    *timeout->m_slot = timeout;
+}
+
+void ZigbeeTimerWheel::unlink(ZigbeeTimeout *timeout)
+{
+    if (timeout->m_previous) {
+        timeout->m_previous->m_next = timeout->m_next;
+    } else {
+        *timeout->m_slot = timeout->m_next;
+    }
+
+    if (timeout->m_next)
+        timeout->m_next->m_previous = timeout->m_previous;
+
+    timeout->m_wheel = nullptr;
+    timeout->m_slot = nullptr;
+    timeout->m_previous = nullptr;
+    timeout->m_next = nullptr;
+    m_activeTimeouts--;
+}
+
+void ZigbeeTimerWheel::onTick()
+{
+    // Catch up with all ticks passed, the event loop might have been busy
+    quint64 targetTick = elapsedTicks();
+    while (m_currentTick < targetTick && m_activeTimeouts > 0) {
+        m_currentTick++;
+
+        // Cascade the upper level slots reached by this tick down to the lower levels
+        for (int level = s_levels - 1; level > 0; level--) {
+            quint64 mask = (Q_UINT64_C(1) << (s_levelBits * level)) - 1;
+            if ((m_currentTick & mask) != 0)
+                continue;
+
+            int slot = static_cast<int>((m_currentTick >> (s_levelBits * level)) & (s_slotCount - 1));
+            ZigbeeTimeout *timeout = m_slots[level][slot];
+            m_slots[level][slot] = nullptr;
+            while (timeout) {
+                ZigbeeTimeout *next = timeout->m_next;
+                insert(timeout);
+                timeout = next;
+            }
+        }
+
+        // Fire the expired timeouts, the callbacks may start or stop any other timeout
+        ZigbeeTimeout **expiredSlot = &m_slots[0][m_currentTick & (s_slotCount - 1)];
+        while (*expiredSlot) {
+            ZigbeeTimeout *timeout = *expiredSlot;
+            unlink(timeout);
+            std::function<void()> callback = timeout->m_callback;
+            if (callback) {
+                callback();
+            }
+        }
+    }
+
+    if (m_activeTimeouts == 0) {
+        m_tickTimer->stop();
+    }
+}
@@ -0,0 +1,120 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright 2013 - 2020, nymea GmbH
+* Contact: contact@nymea.io
+*
+* This file is part of nymea-zigbee.
+* This project including source code and documentation is protected by copyright law, and
+* remains the property of nymea GmbH. All rights, including reproduction, publication,
+* editing and translation, are reserved. The use of this project is subject to the terms of a
+* license agreement to be concluded with nymea GmbH in accordance with the terms
+* of use of nymea GmbH, available under https://nymea.io/license
+*
+* GNU Lesser General Public License Usage
+* Alternatively, this project may be redistributed and/or modified under the terms of the GNU
+* Lesser General Public License as published by the Free Software Foundation; version 3.
+* this project is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+* See the GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License along with this project.
+* If not, see <https://www.gnu.org/licenses/>.
+*
+* For any further details and any questions please contact us under contact@nymea.io
+* or see our FAQ/Licensing Information on https://nymea.io/license/faq
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ZIGBEETIMERWHEEL_H
+#define ZIGBEETIMERWHEEL_H
+
+#include <QObject>
+#include <QTimer>
+
+#include <functional>
+
+class ZigbeeTimerWheel;
+
+// Single shot reply timeout registered in the timer wheel of the current thread. Starting and
+// stopping it is a constant time list operation instead of a timer registration in the event loop.
+// The timeout has to be started and stopped in the thread it has been started in.
+class ZigbeeTimeout
+{
+    friend class ZigbeeTimerWheel;
+
+public:
+    explicit ZigbeeTimeout(int interval = 0);
+    ~ZigbeeTimeout();
+
+    int interval() const;
+    void setInterval(int interval);
+
+    void setCallback(const std::function<void()> &callback);
+
+    bool isActive() const;
+
+    void start();
+    void start(int interval);
+    void stop();
+
+private:
+    Q_DISABLE_COPY(ZigbeeTimeout)
+
+    int m_interval = 0;
+    std::function<void()> m_callback;
+
+    // Position in the wheel while active
+    ZigbeeTimerWheel *m_wheel = nullptr;
+    ZigbeeTimeout **m_slot = nullptr;
+    ZigbeeTimeout *m_previous = nullptr;
+    ZigbeeTimeout *m_next = nullptr;
+    quint64 m_expiryTick = 0;
+
+};
+
+// Hierarchical timer wheel, one per thread. Every level has 64 slots, a slot of the first level
+// covers one tick and a slot of every further level one full turn of the level below. Timeouts
+// in the upper levels cascade down while their expiry approaches. The wheel only ticks while
+// timeouts are active.
+class ZigbeeTimerWheel : public QObject
+{
+    Q_OBJECT
+
+    friend class ZigbeeTimeout;
+
+public:
+    // The wheel of the calling thread
+    static ZigbeeTimerWheel *instance();
+
+    ~ZigbeeTimerWheel() override;
+
+    int resolution() const;
+    int activeTimeouts() const;
+
+private:
+    explicit ZigbeeTimerWheel(QObject *parent = nullptr);
+
+    static const int s_resolution = 50;
+    static const int s_levelBits = 6;
+    static const int s_slotCount = 1 << s_levelBits;
+    static const int s_levels = 4;
+
+    QTimer *m_tickTimer = nullptr;
+    qint64 m_startTime = 0;
+    quint64 m_currentTick = 0;
+    int m_activeTimeouts = 0;
+    ZigbeeTimeout *m_slots[s_levels][s_slotCount];
+
+    quint64 elapsedTicks() const;
+
+    void startTimeout(ZigbeeTimeout *timeout);
+    void stopTimeout(ZigbeeTimeout *timeout);
+
+    void insert(ZigbeeTimeout *timeout);
+    void unlink(ZigbeeTimeout *timeout);
+
+    void onTick();
+
+};
+
+#endif // ZIGBEETIMERWHEEL_H
@@ -31,6 +31,7 @@
 #include <QDateTime>
 #include <QMetaEnum>
 #include <QDataStream>
+#include <QElapsedTimer>
 
 #include <math.h>
 
@@ -296,6 +297,13 @@ quint16 ZigbeeUtils::generateRandomPanId()
     return static_cast<quint16>(rand() % (0x3fff - 1) + 1);
 }
 
+qint64 ZigbeeUtils::monotonicMilliseconds()
+{
+    QElapsedTimer timer;
+    timer.start();
+    return timer.msecsSinceReference();
+}
+
 QPointF ZigbeeUtils::convertColorToXY(const QColor &color)
 {
     // https://developers.meethue.com/develop/application-design-guidance/color-conversion-formulas-rgb-to-xy-and-back/
@@ -71,6 +71,8 @@ public:
     // Generate random data
     static quint16 generateRandomPanId();
 
+    // Monotonic clock in milliseconds, not affected by wall clock changes
+    static qint64 monotonicMilliseconds();
 
     // Color converter
     static QPointF convertColorToXY(const QColor &color);